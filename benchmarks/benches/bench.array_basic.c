@@ -0,0 +1,216 @@
+#include "array.h"
+#include "bench.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+static const size_t elt_sizes[] = {1, 4, 8, 16, 64};
+static char elem[64] = {1};
+
+static array_t *filled_array(size_t elt_size, size_t n) {
+  array_t *v = array_create(elt_size, n, NULL);
+
+  for (size_t i = 0; i < n; i++) {
+    elem[0] = (char)i;
+    array_push(v, elem);
+  }
+  return (v);
+}
+
+static void bench_push(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = array_create(elt_size, 0, NULL);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    array_push(v, elem);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(v->_ptr);
+  array_kill(v);
+}
+
+static void bench_pop(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = filled_array(elt_size, n);
+  char into[64];
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    array_pop(v, into);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(into);
+  array_kill(v);
+}
+
+static void bench_pushf(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = array_create(elt_size, 0, NULL);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    array_pushf(v, elem);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(v->_ptr);
+  array_kill(v);
+}
+
+static void bench_insert(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = array_create(elt_size, 0, NULL);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    array_insert(v, array_size(v) / 2, elem);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(v->_ptr);
+  array_kill(v);
+}
+
+static void bench_inject(size_t elt_size, size_t n, bench_timer_t *timer) {
+  static char block[16 * 64];
+  array_t *v = array_create(elt_size, 0, NULL);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    array_inject(v, array_size(v) / 2, block, 16);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(v->_ptr);
+  array_kill(v);
+}
+
+static void bench_evict(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = filled_array(elt_size, n);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    array_evict(v, 0);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  array_kill(v);
+}
+
+static void bench_wipe(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = filled_array(elt_size, n * 16 + 32);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    size_t start = array_size(v) / 2;
+    array_wipe(v, start, start + 16);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  array_kill(v);
+}
+
+static void bench_swap(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = filled_array(elt_size, 1024);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    array_swap_elems(v, i % 1024, (i * 7 + 1) % 1024);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(v->_ptr);
+  array_kill(v);
+}
+
+static void bench_reverse(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = filled_array(elt_size, n);
+
+  bench_timer_start(timer);
+  array_reverse(v);
+  bench_timer_stop(timer);
+
+  bench_consume(v->_ptr);
+  array_kill(v);
+}
+
+static void bench_rotate(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = filled_array(elt_size, n);
+
+  bench_timer_start(timer);
+  array_rotate(v, n / 3);
+  bench_timer_stop(timer);
+
+  bench_consume(v->_ptr);
+  array_kill(v);
+}
+
+static bool keep_even(const void *e) { return (!(*(const char *)e & 1)); }
+
+static void bench_filter(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = filled_array(elt_size, n);
+
+  bench_timer_start(timer);
+  array_t *filtered = array_filter(v, keep_even);
+  bench_timer_stop(timer);
+
+  array_kill(filtered);
+  array_kill(v);
+}
+
+static bool is_odd(const void *e) { return (*(const char *)e & 1); }
+
+/* Half of the elements are removed, scattered. */
+static void bench_erase_if(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = filled_array(elt_size, n);
+
+  bench_timer_start(timer);
+  array_erase_if(v, is_odd);
+  bench_timer_stop(timer);
+
+  bench_consume(v->_ptr);
+  array_kill(v);
+}
+
+/* The same removal, one 'evict' at a time. */
+static void bench_evict_if(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = filled_array(elt_size, n);
+
+  bench_timer_start(timer);
+  for (size_t i = array_size(v); i > 0; i--) {
+    if (is_odd(array_at(v, i - 1)))
+      array_evict(v, i - 1);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(v->_ptr);
+  array_kill(v);
+}
+
+BENCH_FUNCTION void array_basic_benchs(void) {
+  for (size_t i = 0; i < sizeof(elt_sizes) / sizeof(*elt_sizes); i++) {
+    size_t elt_size = elt_sizes[i];
+
+    run_bench(&bench_push, "array_push", elt_size, 100000);
+    run_bench(&bench_pop, "array_pop", elt_size, 100000);
+    run_bench(&bench_pushf, "array_pushf", elt_size, 2000);
+    run_bench(&bench_insert, "array_insert", elt_size, 2000);
+    run_bench(&bench_inject, "array_inject", elt_size, 1000);
+    run_bench(&bench_evict, "array_evict", elt_size, 2000);
+    run_bench(&bench_wipe, "array_wipe", elt_size, 1000);
+    run_bench(&bench_filter, "array_filter", elt_size, 100000);
+    run_bench(&bench_erase_if, "array_erase_if", elt_size, 10000);
+    run_bench(&bench_evict_if, "array_evict loop", elt_size, 10000);
+    run_bench(&bench_swap, "array_swap_elems", elt_size, 100000);
+    run_bench(&bench_reverse, "array_reverse", elt_size, 100000);
+    run_bench(&bench_rotate, "array_rotate", elt_size, 100000);
+  }
+}
@@ -0,0 +1,96 @@
+#include "array.h"
+#include "bench.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static array_t *filled_array(size_t n) {
+  array_t *v = array_create(sizeof(int32_t), n, NULL);
+
+  for (int32_t i = 0; i < (int32_t)n; i++)
+    array_push(v, &(int32_t){i * 7919});
+  return (v);
+}
+
+static bool keep_small(const void *e) {
+  return ((*(const int32_t *)e & 0xff) < 0x80);
+}
+
+static void keep_small_batch(const void *elems, size_t n, uint64_t *keep) {
+  const int32_t *x = elems;
+
+  for (size_t i = 0; i < n; i++)
+    keep[i / 64] |= (uint64_t)((x[i] & 0xff) < 0x80) << (i % 64);
+}
+
+static bool bump(void *e) {
+  (*(int32_t *)e)++;
+  return (true);
+}
+
+static bool bump_batch(void *elems, size_t n) {
+  int32_t *x = elems;
+
+  for (size_t i = 0; i < n; i++)
+    x[i]++;
+  return (true);
+}
+
+static void bench_filter(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = filled_array(n);
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  array_t *filtered = array_filter(v, &keep_small);
+  bench_timer_stop(timer);
+
+  array_kill(filtered);
+  array_kill(v);
+}
+
+static void bench_filter_batch(size_t elt_size, size_t n,
+                               bench_timer_t *timer) {
+  array_t *v = filled_array(n);
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  array_t *filtered = array_filter_batch(v, &keep_small_batch);
+  bench_timer_stop(timer);
+
+  array_kill(filtered);
+  array_kill(v);
+}
+
+static void bench_foreach(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = filled_array(n);
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  array_foreach(v, &bump);
+  bench_timer_stop(timer);
+
+  bench_consume(v->_ptr);
+  array_kill(v);
+}
+
+static void bench_foreach_batch(size_t elt_size, size_t n,
+                                bench_timer_t *timer) {
+  array_t *v = filled_array(n);
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  array_foreach_batch(v, &bump_batch);
+  bench_timer_stop(timer);
+
+  bench_consume(v->_ptr);
+  array_kill(v);
+}
+
+BENCH_FUNCTION void array_batch_benchs(void) {
+  run_bench(&bench_filter, "array_filter", sizeof(int32_t), 100000);
+  run_bench(&bench_filter_batch, "array_filter_batch", sizeof(int32_t),
+            100000);
+  run_bench(&bench_foreach, "array_foreach", sizeof(int32_t), 100000);
+  run_bench(&bench_foreach_batch, "array_foreach_batch", sizeof(int32_t),
+            100000);
+}
@@ -0,0 +1,59 @@
+#include "array.h"
+#include "bench.h"
+#include <stddef.h>
+
+static char elem[64];
+
+#define GROWTH_BENCH(policy, step)                                             \
+  static void bench_##policy(size_t elt_size, size_t n,                       \
+                             bench_timer_t *timer) {                           \
+    array_t *v = array_create(elt_size, 0, NULL);                              \
+    array_set_growth(v, policy, step);                                         \
+                                                                               \
+    bench_timer_start(timer);                                                  \
+    for (size_t i = 0; i < n; i++) {                                           \
+      array_push(v, elem);                                                     \
+      bench_timer_tick(timer);                                                 \
+    }                                                                          \
+    bench_timer_stop(timer);                                                   \
+                                                                               \
+    bench_consume(v->_ptr);                                                    \
+    array_kill(v);                                                             \
+  }
+
+GROWTH_BENCH(ARRAY_GROWTH_DOUBLE, 0)
+GROWTH_BENCH(ARRAY_GROWTH_HALF, 0)
+GROWTH_BENCH(ARRAY_GROWTH_CHUNK, 4096)
+GROWTH_BENCH(ARRAY_GROWTH_PAGES, 0)
+
+static void bench_append(size_t elt_size, size_t n, bench_timer_t *timer) {
+  static char block[256 * 64];
+  array_t *v = array_create(elt_size, 0, NULL);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    array_append(v, block, 256);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(v->_ptr);
+  array_kill(v);
+}
+
+BENCH_FUNCTION void array_growth_benchs(void) {
+  static const size_t elt_sizes[] = {4, 16, 64};
+
+  for (size_t i = 0; i < sizeof(elt_sizes) / sizeof(*elt_sizes); i++) {
+    size_t elt_size = elt_sizes[i];
+
+    run_bench(&bench_ARRAY_GROWTH_DOUBLE, "array_push/double", elt_size,
+              1000000);
+    run_bench(&bench_ARRAY_GROWTH_HALF, "array_push/half", elt_size, 1000000);
+    run_bench(&bench_ARRAY_GROWTH_CHUNK, "array_push/chunk", elt_size,
+              1000000);
+    run_bench(&bench_ARRAY_GROWTH_PAGES, "array_push/pages", elt_size,
+              1000000);
+    run_bench(&bench_append, "array_append", elt_size, 4096);
+  }
+}
@@ -0,0 +1,62 @@
+#include "array.h"
+#include "bench.h"
+#include <stddef.h>
+#include <stdint.h>
+
+static uint32_t needle = UINT32_MAX;
+
+static bool is_needle(const void *elem) {
+  return (*(const uint32_t *)elem == needle);
+}
+
+/* An array of 'n' ids, none of them being the one looked for. */
+static array_t *bench_ids(size_t n) {
+  array_t *arr = array_create(sizeof(uint32_t), n, NULL);
+
+  for (size_t i = 0; i < n; i++)
+    array_push(arr, &(uint32_t){(uint32_t)i});
+  return (arr);
+}
+
+static void bench_find_callback(size_t elt_size, size_t n,
+                                bench_timer_t *timer) {
+  array_t *arr = bench_ids(n);
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  bench_consume(array_find(arr, &is_needle));
+  bench_timer_stop(timer);
+
+  array_kill(arr);
+}
+
+static void bench_find_value(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *arr = bench_ids(n);
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  bench_consume(array_find_value(arr, &needle));
+  bench_timer_stop(timer);
+
+  array_kill(arr);
+}
+
+static void bench_minmax(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *arr = bench_ids(n);
+  uint32_t min;
+  uint32_t max;
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  array_minmax(arr, false, &min, &max);
+  bench_timer_stop(timer);
+
+  bench_consume(&max);
+  array_kill(arr);
+}
+
+BENCH_FUNCTION void array_search_benchs(void) {
+  run_bench(&bench_find_callback, "array_find", 4, 100000);
+  run_bench(&bench_find_value, "array_find_value", 4, 100000);
+  run_bench(&bench_minmax, "array_minmax", 4, 100000);
+}
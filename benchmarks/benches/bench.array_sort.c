@@ -0,0 +1,80 @@
+#include "array.h"
+#include "array_sort.h"
+#include "bench.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+static array_t *random_array(size_t elt_size, size_t n) {
+  array_t *v = array_create(elt_size, n, NULL);
+  uint64_t state = 0x2545f4914f6cdd1dULL;
+  char elem[64] = {0};
+
+  for (size_t i = 0; i < n; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    *(int64_t *)elem = (int64_t)(state >> 1);
+    array_push(v, elem);
+  }
+  return (v);
+}
+
+static int cmp_key(const void *a, const void *b) {
+  int64_t x = *(const int64_t *)a;
+  int64_t y = *(const int64_t *)b;
+
+  return ((x > y) - (x < y));
+}
+
+static void bench_qsort(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = random_array(elt_size, n);
+
+  bench_timer_start(timer);
+  qsort(v->_ptr, n, elt_size, &cmp_key);
+  bench_timer_stop(timer);
+
+  array_kill(v);
+}
+
+static void bench_sort(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *v = random_array(elt_size, n);
+
+  bench_timer_start(timer);
+  array_sort(v, &cmp_key);
+  bench_timer_stop(timer);
+
+  array_kill(v);
+}
+
+static void bench_sort_stable(size_t elt_size, size_t n,
+                              bench_timer_t *timer) {
+  array_t *v = random_array(elt_size, n);
+
+  bench_timer_start(timer);
+  array_sort_stable(v, &cmp_key);
+  bench_timer_stop(timer);
+
+  array_kill(v);
+}
+
+static void bench_radix_sort(size_t elt_size, size_t n,
+                             bench_timer_t *timer) {
+  array_t *v = random_array(elt_size, n);
+
+  bench_timer_start(timer);
+  array_radix_sort(v, 0, ARRAY_KEY_I64);
+  bench_timer_stop(timer);
+
+  array_kill(v);
+}
+
+BENCH_FUNCTION void array_sort_benchs(void) {
+  static const size_t elt_sizes[] = {8, 16, 64};
+
+  for (size_t i = 0; i < sizeof(elt_sizes) / sizeof(*elt_sizes); i++) {
+    run_bench(&bench_qsort, "qsort", elt_sizes[i], 100000);
+    run_bench(&bench_sort, "array_sort", elt_sizes[i], 100000);
+    run_bench(&bench_sort_stable, "array_sort_stable", elt_sizes[i], 100000);
+    run_bench(&bench_radix_sort, "array_radix_sort", elt_sizes[i], 100000);
+  }
+}
@@ -0,0 +1,55 @@
+#include "array.h"
+#include "bench.h"
+#include "deque.h"
+#include <stddef.h>
+
+static char elem[64];
+
+/* A work queue holding 'n' items, each operation pushes one at the back
+ * and pops one from the front. */
+static void bench_deque_queue(size_t elt_size, size_t n, bench_timer_t *timer) {
+  deque_t *q = deque_create(elt_size, n, NULL);
+  char into[64];
+
+  for (size_t i = 0; i < n; i++)
+    deque_push(q, elem);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    deque_push(q, elem);
+    deque_popf(q, into);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(into);
+  deque_kill(q);
+}
+
+static void bench_array_queue(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *q = array_create(elt_size, n, NULL);
+  char into[64];
+
+  for (size_t i = 0; i < n; i++)
+    array_push(q, elem);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    array_push(q, elem);
+    array_popf(q, into);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(into);
+  array_kill(q);
+}
+
+BENCH_FUNCTION void deque_basic_benchs(void) {
+  static const size_t elt_sizes[] = {8, 64};
+
+  for (size_t i = 0; i < sizeof(elt_sizes) / sizeof(*elt_sizes); i++) {
+    run_bench(&bench_deque_queue, "deque_push+popf", elt_sizes[i], 10000);
+    run_bench(&bench_array_queue, "array_push+popf", elt_sizes[i], 10000);
+  }
+}
@@ -0,0 +1,142 @@
+#include "bench.h"
+#include "dynstr.h"
+#include "gapstr.h"
+#include "rope.h"
+#include <stddef.h>
+
+static void bench_append(size_t elt_size, size_t n, bench_timer_t *timer) {
+  dynstr_t *str = dynstr_create(0);
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    dynstr_append(str, "some log key", 12);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(str->_ptr);
+  dynstr_kill(str);
+}
+
+static void bench_assign(size_t elt_size, size_t n, bench_timer_t *timer) {
+  (void)elt_size;
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    dynstr_t *str = dynstr_assign("short label", -1);
+    bench_consume(str->_ptr);
+    dynstr_kill(str);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+}
+
+/* Typing 'n' characters in the middle of a 1MB text. */
+static void bench_inject_typing(size_t elt_size, size_t n,
+                                bench_timer_t *timer) {
+  dynstr_t *str = dynstr_create(1 << 20);
+
+  (void)elt_size;
+  for (size_t i = 0; i < (1 << 20) / 16; i++)
+    dynstr_append(str, "0123456789abcdef", 16);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    dynstr_inject(str, (1 << 19) + i, "x", 1);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(str->_ptr);
+  dynstr_kill(str);
+}
+
+static void bench_gapstr_typing(size_t elt_size, size_t n,
+                                bench_timer_t *timer) {
+  gapstr_t *str = gapstr_create(1 << 20);
+
+  (void)elt_size;
+  for (size_t i = 0; i < (1 << 20) / 16; i++)
+    gapstr_append(str, "0123456789abcdef", 16);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    gapstr_inject(str, (1 << 19) + i, "x", 1);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(gapstr_view(str));
+  gapstr_kill(str);
+}
+
+static void bench_rope_typing(size_t elt_size, size_t n, bench_timer_t *timer) {
+  rope_t *str = rope_create();
+
+  (void)elt_size;
+  for (size_t i = 0; i < (1 << 20) / 16; i++)
+    rope_append(str, "0123456789abcdef", 16);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    rope_inject(str, (1 << 19) + i, "x", 1);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(str->_root);
+  rope_kill(str);
+}
+
+/* Pasting 'n' lines at scattered offsets of a 16MB text. */
+static void bench_inject_scattered(size_t elt_size, size_t n,
+                                   bench_timer_t *timer) {
+  dynstr_t *str = dynstr_create(1 << 24);
+  size_t seed = 42;
+
+  (void)elt_size;
+  for (size_t i = 0; i < (1 << 24) / 16; i++)
+    dynstr_append(str, "0123456789abcdef", 16);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    dynstr_inject(str, (seed >> 33) % (1 << 24), "a pasted line\n", 14);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(str->_ptr);
+  dynstr_kill(str);
+}
+
+static void bench_rope_scattered(size_t elt_size, size_t n,
+                                 bench_timer_t *timer) {
+  rope_t *str = rope_create();
+  size_t seed = 42;
+
+  (void)elt_size;
+  for (size_t i = 0; i < (1 << 24) / 16; i++)
+    rope_append(str, "0123456789abcdef", 16);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    rope_inject(str, (seed >> 33) % (1 << 24), "a pasted line\n", 14);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(str->_root);
+  rope_kill(str);
+}
+
+BENCH_FUNCTION void dynstr_basic_benchs(void) {
+  run_bench(&bench_append, "dynstr_append", 1, 100000);
+  run_bench(&bench_assign, "dynstr_assign", 1, 100000);
+  run_bench(&bench_inject_typing, "dynstr_inject typing", 1, 2000);
+  run_bench(&bench_gapstr_typing, "gapstr_inject typing", 1, 2000);
+  run_bench(&bench_rope_typing, "rope_inject typing", 1, 2000);
+  run_bench(&bench_inject_scattered, "dynstr_inject scattered", 1, 1000);
+  run_bench(&bench_rope_scattered, "rope_inject scattered", 1, 1000);
+}
@@ -0,0 +1,77 @@
+#include "bench.h"
+#include "hashmap.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/* The keys are scrambled so consecutive insertions land far apart. */
+static inline uint64_t bench_key(size_t i) {
+  return ((uint64_t)i * 0x9e3779b97f4a7c15ULL);
+}
+
+static void bench_hashmap_put(size_t elt_size, size_t n,
+                              bench_timer_t *timer) {
+  hashmap_t *m = hashmap_create(sizeof(uint64_t), elt_size, NULL);
+  static char value[64];
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    hashmap_put(m, &(uint64_t){bench_key(i)}, value);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  hashmap_kill(m);
+}
+
+/* Half of the lookups miss. */
+static void bench_hashmap_get(size_t elt_size, size_t n,
+                              bench_timer_t *timer) {
+  hashmap_t *m = hashmap_create(sizeof(uint64_t), elt_size, NULL);
+  static char value[64];
+  size_t found = 0;
+
+  for (size_t i = 0; i < n; i += 2)
+    hashmap_put(m, &(uint64_t){bench_key(i)}, value);
+
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    found += hashmap_get(m, &(uint64_t){bench_key(i)}) != NULL;
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(&found);
+  hashmap_kill(m);
+}
+
+/* A sliding window of 'n / 4' keys, each step inserts one and erases the
+ * oldest. */
+static void bench_hashmap_churn(size_t elt_size, size_t n,
+                                bench_timer_t *timer) {
+  hashmap_t *m = hashmap_create(sizeof(uint64_t), elt_size, NULL);
+  static char value[64];
+  size_t window = n / 4;
+
+  for (size_t i = 0; i < window; i++)
+    hashmap_put(m, &(uint64_t){bench_key(i)}, value);
+
+  bench_timer_start(timer);
+  for (size_t i = window; i < n + window; i++) {
+    hashmap_put(m, &(uint64_t){bench_key(i)}, value);
+    hashmap_erase(m, &(uint64_t){bench_key(i - window)});
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  hashmap_kill(m);
+}
+
+BENCH_FUNCTION void hashmap_basic_benchs(void) {
+  static const size_t elt_sizes[] = {8, 64};
+
+  for (size_t i = 0; i < sizeof(elt_sizes) / sizeof(*elt_sizes); i++) {
+    run_bench(&bench_hashmap_put, "hashmap_put", elt_sizes[i], 100000);
+    run_bench(&bench_hashmap_get, "hashmap_get", elt_sizes[i], 100000);
+    run_bench(&bench_hashmap_churn, "hashmap_put+erase", elt_sizes[i], 100000);
+  }
+}
@@ -0,0 +1,51 @@
+#include "bench.h"
+#include "dynstr.h"
+#include "intern.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* 'n' strings drawn from 'n / 16' distinct labels, as log keys would be. */
+static int bench_label(char *buffer, size_t size, size_t i, size_t n) {
+  return (snprintf(buffer, size, "host-%zu.service.latency", i % (n / 16)));
+}
+
+static void bench_intern_put(size_t elt_size, size_t n, bench_timer_t *timer) {
+  intern_t *t = intern_create(0);
+  char buffer[64];
+  ut32_t id = 0;
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    intern_put(t, buffer, bench_label(buffer, sizeof(buffer), i, n), &id);
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  bench_consume(&id);
+  intern_kill(t);
+}
+
+static void bench_dynstr_assign(size_t elt_size, size_t n,
+                                bench_timer_t *timer) {
+  dynstr_t **strs = malloc(n * sizeof(*strs));
+  char buffer[64];
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++) {
+    strs[i] = dynstr_assign(buffer, bench_label(buffer, sizeof(buffer), i, n));
+    bench_timer_tick(timer);
+  }
+  bench_timer_stop(timer);
+
+  for (size_t i = 0; i < n; i++)
+    dynstr_kill(strs[i]);
+  free(strs);
+}
+
+BENCH_FUNCTION void intern_basic_benchs(void) {
+  run_bench(&bench_intern_put, "intern_put", 1, 100000);
+  run_bench(&bench_dynstr_assign, "dynstr_assign", 1, 100000);
+}
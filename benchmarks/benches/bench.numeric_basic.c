@@ -0,0 +1,62 @@
+#include "array.h"
+#include "bench.h"
+#include "numeric.h"
+#include <stddef.h>
+
+static array_t *bench_doubles(size_t n) {
+  array_t *arr = array_create(sizeof(double), n, NULL);
+
+  for (size_t i = 0; i < n; i++)
+    array_push(arr, &(double){(double)i * 0.5});
+  return (arr);
+}
+
+/* The loop the kernels replace. */
+static void bench_sum_loop(size_t elt_size, size_t n, bench_timer_t *timer) {
+  array_t *arr = bench_doubles(n);
+  double sum = 0;
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  for (size_t i = 0; i < n; i++)
+    sum += *(const double *)array_unsafe_at(arr, i);
+  bench_timer_stop(timer);
+
+  bench_consume(&sum);
+  array_kill(arr);
+}
+
+static void bench_numeric_sum(size_t elt_size, size_t n,
+                              bench_timer_t *timer) {
+  array_t *arr = bench_doubles(n);
+  numeric_value_t sum;
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  sum = numeric_sum(arr, ARRAY_KEY_F64);
+  bench_timer_stop(timer);
+
+  bench_consume(&sum);
+  array_kill(arr);
+}
+
+static void bench_numeric_axpy(size_t elt_size, size_t n,
+                               bench_timer_t *timer) {
+  array_t *x = bench_doubles(n);
+  array_t *y = bench_doubles(n);
+
+  (void)elt_size;
+  bench_timer_start(timer);
+  numeric_axpy(y, (numeric_value_t){._f = 2.0}, x, ARRAY_KEY_F64);
+  bench_timer_stop(timer);
+
+  bench_consume(y->_ptr);
+  array_kill(x);
+  array_kill(y);
+}
+
+BENCH_FUNCTION void numeric_basic_benchs(void) {
+  run_bench(&bench_sum_loop, "sum_loop", 8, 100000);
+  run_bench(&bench_numeric_sum, "numeric_sum", 8, 100000);
+  run_bench(&bench_numeric_axpy, "numeric_axpy", 8, 100000);
+}
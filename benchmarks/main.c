@@ -0,0 +1,25 @@
+#include "bench.h"
+#include <stdio.h>
+
+/* The benchmarks have already run (they are registered as constructors),
+ * the results are written to stdout as JSON.
+ */
+int main(void) {
+  fprintf(stdout, "{\n  \"warmup_runs\": %d,\n  \"runs\": %d,\n"
+                  "  \"benchmarks\": [",
+          BENCH_WARMUP_RUNS, BENCH_RUNS);
+
+  for (size_t i = 0; i < __benchs__.count; i++) {
+    const bench_result_t *r = &__benchs__.results[i];
+
+    fprintf(stdout,
+            "%s\n    {\"name\": \"%s\", \"elt_size\": %zu, \"n\": %zu, "
+            "\"median_ns_per_op\": %.3f, \"p99_ns_per_op\": %.3f, "
+            "\"min_ns_per_op\": %.3f}",
+            i ? "," : "", r->_name, r->_elt_size, r->_n, r->_median_ns,
+            r->_p99_ns, r->_min_ns);
+  }
+
+  fprintf(stdout, "\n  ]\n}\n");
+  return (0);
+}
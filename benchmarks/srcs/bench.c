@@ -0,0 +1,115 @@
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define YEL "\033[0;33m"
+#define CRESET "\033[0m"
+
+benchs_state_t __benchs__ = {.count = 0};
+
+static volatile const void *__sink__;
+
+void bench_consume(const void *ptr) { __sink__ = ptr; }
+
+static void bench_samples_add(bench_samples_t *samples, double ns) {
+  if (samples->_count == samples->_cap) {
+    size_t cap = samples->_cap ? samples->_cap * 2 : 1024;
+    double *grown = realloc(samples->_ns, cap * sizeof(double));
+
+    if (!grown) {
+      return;
+    }
+    samples->_ns = grown;
+    samples->_cap = cap;
+  }
+  samples->_ns[samples->_count++] = ns;
+}
+
+static double elapsed_ns(const struct timespec *from,
+                         const struct timespec *to) {
+  return ((to->tv_sec - from->tv_sec) * 1e9 + (to->tv_nsec - from->tv_nsec));
+}
+
+void bench_timer_start(bench_timer_t *timer) {
+  timer->_ops = 0;
+  clock_gettime(CLOCK_MONOTONIC, &timer->_lap);
+}
+
+void bench_timer_stop(bench_timer_t *timer) {
+  struct timespec end;
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  timer->_elapsed_ns += elapsed_ns(&timer->_lap, &end);
+  timer->_ops = 0; /* a partial batch only counts in the mean */
+}
+
+void bench_timer_lap(bench_timer_t *timer) {
+  struct timespec end;
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  double ns = elapsed_ns(&timer->_lap, &end);
+
+  timer->_elapsed_ns += ns;
+  if (timer->_samples) {
+    bench_samples_add(timer->_samples, ns / timer->_ops);
+  }
+  timer->_ops = 0;
+  clock_gettime(CLOCK_MONOTONIC, &timer->_lap);
+}
+
+static int compare_doubles(const void *a, const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+
+  return ((x > y) - (x < y));
+}
+
+bool run_bench(bench_fn_t bench, const char *name, size_t elt_size, size_t n) {
+  double runs[BENCH_RUNS];
+  bench_samples_t samples = {NULL, 0, 0};
+
+  if (__benchs__.count == BENCH_MAX_RESULTS) {
+    fprintf(stderr, "too many benchmarks, %s skipped\n", name);
+    return (false);
+  }
+
+  fprintf(stderr, " running: %s%24s%s (elt_size: %3zu, n: %8zu) -> ", YEL, name,
+          CRESET, elt_size, n);
+
+  for (size_t i = 0; i < BENCH_WARMUP_RUNS; i++) {
+    bench_timer_t timer = {._elapsed_ns = 0};
+    bench(elt_size, n, &timer);
+  }
+
+  for (size_t i = 0; i < BENCH_RUNS; i++) {
+    bench_timer_t timer = {._elapsed_ns = 0, ._samples = &samples};
+    size_t batches = samples._count;
+
+    bench(elt_size, n, &timer);
+    runs[i] = timer._elapsed_ns / (double)n;
+    if (samples._count == batches) {
+      bench_samples_add(&samples, runs[i]);
+    }
+  }
+
+  qsort(runs, BENCH_RUNS, sizeof(double), compare_doubles);
+  qsort(samples._ns, samples._count, sizeof(double), compare_doubles);
+
+  bench_result_t *result = &__benchs__.results[__benchs__.count++];
+
+  result->_name = name;
+  result->_elt_size = elt_size;
+  result->_n = n;
+  result->_median_ns = samples._count ? samples._ns[samples._count / 2] : 0;
+  result->_p99_ns =
+      samples._count ? samples._ns[(samples._count * 99 + 99) / 100 - 1] : 0;
+  result->_min_ns = runs[0];
+  free(samples._ns);
+
+  fprintf(stderr, "median: %10.2f ns/op, p99: %10.2f ns/op\n",
+          result->_median_ns, result->_p99_ns);
+  return (true);
+}
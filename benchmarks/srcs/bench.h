@@ -0,0 +1,80 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+#define BENCH_WARMUP_RUNS 3
+#define BENCH_RUNS 31
+#define BENCH_MAX_RESULTS 256
+#define BENCH_BATCH_OPS 64
+
+/* The time per operation of every batch timed during a benchmark. */
+typedef struct {
+  double *_ns;
+  size_t _count;
+  size_t _cap;
+} bench_samples_t;
+
+#define BENCH_FUNCTION __attribute__((constructor))
+
+typedef struct {
+  struct timespec _lap;       /* When the current batch started */
+  double _elapsed_ns;         /* Accumulated time between start and stop */
+  size_t _ops;                /* The operations of the current batch */
+  bench_samples_t *_samples;  /* Where the batches go */
+} bench_timer_t;
+
+typedef struct {
+  const char *_name;
+  size_t _elt_size;
+  size_t _n;         /* The number of operations per run */
+  double _median_ns; /* per operation, over the batches */
+  double _p99_ns;    /* per operation, over the batches */
+  double _min_ns;    /* per operation, fastest run */
+} bench_result_t;
+
+typedef struct {
+  size_t count;
+  bench_result_t results[BENCH_MAX_RESULTS];
+} benchs_state_t;
+
+extern benchs_state_t __benchs__;
+
+/* A benchmark performs 'n' operations on elements of 'elt_size' bytes,
+ * only the code in between 'bench_timer_start' and 'bench_timer_stop' is
+ * measured so the setup can stay out of the figures.
+ */
+typedef void (*bench_fn_t)(size_t elt_size, size_t n, bench_timer_t *timer);
+
+void bench_timer_start(bench_timer_t *timer);
+void bench_timer_stop(bench_timer_t *timer);
+
+/* Records the time per operation of the batch that just ended, and starts
+ * the next one (see 'bench_timer_tick').
+ */
+void bench_timer_lap(bench_timer_t *timer);
+
+/* Marks the end of one operation: every BENCH_BATCH_OPS operations, the
+ * batch is timed on its own, so the p99 reflects the slow operations (a
+ * growth, a rehash...) and not only the slow runs. The time spent recording
+ * a batch is not counted. A benchmark that never ticks gives one sample per
+ * run instead.
+ */
+static inline void bench_timer_tick(bench_timer_t *timer) {
+  if (__builtin_expect(++timer->_ops == BENCH_BATCH_OPS, 0)) {
+    bench_timer_lap(timer);
+  }
+}
+
+/* Runs 'bench' BENCH_WARMUP_RUNS times, then BENCH_RUNS times while
+ * recording the time per operation of each run and of each batch.
+ */
+bool run_bench(bench_fn_t bench, const char *name, size_t elt_size, size_t n);
+
+/* Keeps the compiler from optimizing away a computation.
+ */
+void bench_consume(const void *ptr);
+
+#endif /* __BENCH_H__ */
@@ -13,6 +13,18 @@ TEST_FRAMEWORK_SRCS := \
 	$(TEST_FRAMEWORK_DIR)/srcs/unit_tests.c \
 	$(TEST_FRAMEWORK_DIR)/srcs/asserts.c
 
+BENCH_NAME     := libcont_bench.dylib
+BENCH_OBJS_DIR := .objs_bench
+
+BENCH_FRAMEWORK_BIN := bencher
+BENCH_FRAMEWORK_DIR := benchmarks
+BENCH_FRAMEWORK_INCS_DIR := $(BENCH_FRAMEWORK_DIR)/srcs
+BENCH_FRAMEWORK_SRCS := \
+	$(BENCH_FRAMEWORK_DIR)/main.c \
+	$(BENCH_FRAMEWORK_DIR)/srcs/bench.c
+BENCH_SRCS := $(shell find $(BENCH_FRAMEWORK_DIR) -name "bench.*.c")
+BENCH_OUTPUT := bench.json
+
 CFLAGS := \
 	-Wall     \
 	-Wextra   \
@@ -22,6 +34,10 @@ CFLAGS := \
 # export ASAN_OPTIONS="log_path=sanitizer.log"
 # export ASAN_OPTIONS="detect_leaks=1"
 
+# Test-only hooks, built into the debug library the specs run on.
+CFLAGS_SPECS := \
+	-DARRAY_SPEC_HOOKS 
+
 CFLAGS_DBG := \
 	-g3                      \
 	-O0                      \
@@ -29,8 +45,29 @@ CFLAGS_DBG := \
 	-fsanitize=undefined     \
 	-fno-omit-frame-pointer  \
 	-fstack-protector-strong \
-	-fno-optimize-sibling-calls 
+	-fno-optimize-sibling-calls \
+	$(CFLAGS_SPECS)
+
+CFLAGS_BENCH := \
+	-O2 
 
 SRCS := \
 	array.c \
-	dynstr.c 
+	array_parallel.c \
+	array_sort.c \
+	arena.c \
+	cpu.c \
+	deque.c \
+	dynstr.c \
+	gapstr.c \
+	hash.c \
+	hashmap.c \
+	intern.c \
+	numeric.c \
+	pages.c \
+	pool.c \
+	queue.c \
+	rope.c \
+	search.c \
+	snapshot.c \
+	swap.c 
@@ -0,0 +1,213 @@
+#include "arena.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#define ARENA_ALIGNMENT 16
+
+/* Every block is preceded by a header holding its size, so the arena can
+ * copy the right amount of bytes when a block has to move.
+ */
+#define BLOCK_HEADER_SIZE ARENA_ALIGNMENT
+#define CHUNK_HEADER_SIZE align_up(sizeof(arena_chunk_t))
+
+struct arena_chunk {
+  arena_chunk_t *_prev; /* The chunk that was in use before this one */
+  size_t _cap;          /* The number of bytes after the chunk header */
+  size_t _used;         /* The number of bytes handed out */
+};
+
+#define _chunk_data(chunk) ((char *)(chunk) + CHUNK_HEADER_SIZE)
+#define _block_size(ptr) (*(size_t *)((char *)(ptr)-BLOCK_HEADER_SIZE))
+
+static inline size_t align_up(size_t n) {
+  return ((n + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1));
+}
+
+static void *arena_alloc_cb(void *ctx, size_t n) {
+  return (arena_alloc(ctx, n));
+}
+
+static void *arena_realloc_cb(void *ctx, void *ptr, size_t n) {
+  return (arena_realloc(ctx, ptr, n));
+}
+
+static void arena_free_cb(void *ctx, void *ptr) { arena_free(ctx, ptr); }
+
+static void chunks_free(arena_chunk_t *chunk) {
+  while (chunk) {
+    arena_chunk_t *prev = chunk->_prev;
+    free(chunk);
+    chunk = prev;
+  }
+}
+
+/* Makes a chunk with at least 'need' free bytes the current one, reusing a
+ * spare chunk when possible.
+ */
+static bool arena_grow(arena_t *self, size_t need) {
+  arena_chunk_t **link = &self->_spare;
+  arena_chunk_t *chunk = NULL;
+
+  while (*link) {
+    if ((*link)->_cap >= need) {
+      chunk = *link;
+      *link = chunk->_prev;
+      break;
+    }
+    link = &(*link)->_prev;
+  }
+
+  if (!chunk) {
+    size_t cap = MAX(need, self->_chunk_size);
+
+    chunk = malloc(CHUNK_HEADER_SIZE + cap);
+    if (unlikely(!chunk)) {
+      return (false);
+    }
+    chunk->_cap = cap;
+  }
+
+  chunk->_used = 0;
+  chunk->_prev = self->_chunk;
+  self->_chunk = chunk;
+
+  return (true);
+}
+
+arena_t *arena_create(size_t chunk_size) {
+  arena_t *self = malloc(sizeof(*self));
+
+  if (likely(self)) {
+    (void)builtin_memset(self, 0x00, sizeof(*self));
+    self->_chunk_size = chunk_size ? align_up(chunk_size) : ARENA_CHUNK_SIZE;
+    self->_allocator._memory_alloc = arena_alloc_cb;
+    self->_allocator._memory_realloc = arena_realloc_cb;
+    self->_allocator._memory_free = arena_free_cb;
+    self->_allocator._ctx = self;
+  }
+
+  return (self);
+}
+
+void arena_kill(arena_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  chunks_free(self->_chunk);
+  chunks_free(self->_spare);
+  free(self);
+}
+
+void *arena_alloc(arena_t *self, size_t n) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_ADD(n, BLOCK_HEADER_SIZE + ARENA_ALIGNMENT) ==
+                 false);
+
+  size_t need = BLOCK_HEADER_SIZE + align_up(n);
+
+  if (!self->_chunk || self->_chunk->_cap - self->_chunk->_used < need) {
+    if (unlikely(!arena_grow(self, need))) {
+      return (NULL);
+    }
+  }
+
+  char *block = _chunk_data(self->_chunk) + self->_chunk->_used;
+
+  self->_chunk->_used += need;
+  self->_last = block + BLOCK_HEADER_SIZE;
+  _block_size(self->_last) = n;
+
+  return (self->_last);
+}
+
+void *arena_realloc(arena_t *self, void *ptr, size_t n) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  if (!ptr) {
+    return (arena_alloc(self, n));
+  }
+
+  size_t size = _block_size(ptr);
+
+  if (ptr == self->_last) {
+    size_t start = (char *)ptr - _chunk_data(self->_chunk);
+
+    if (start + align_up(n) <= self->_chunk->_cap) {
+      self->_chunk->_used = start + align_up(n);
+      _block_size(ptr) = n;
+      return (ptr);
+    }
+  } else if (n <= size) {
+    _block_size(ptr) = n;
+    return (ptr);
+  }
+
+  void *block = arena_alloc(self, n);
+
+  if (likely(block)) {
+    (void)builtin_memcpy(block, ptr, MIN(size, n));
+  }
+
+  return (block);
+}
+
+void arena_free(arena_t *self, void *ptr) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  if (ptr && ptr == self->_last) {
+    self->_chunk->_used =
+        (char *)ptr - BLOCK_HEADER_SIZE - _chunk_data(self->_chunk);
+    self->_last = NULL;
+  }
+}
+
+arena_mark_t arena_mark(const arena_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return ((arena_mark_t){._chunk = self->_chunk,
+                         ._used = self->_chunk ? self->_chunk->_used : 0,
+                         ._last = self->_last});
+}
+
+void arena_rewind(arena_t *self, arena_mark_t mark) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  while (self->_chunk != mark._chunk) {
+    HR_COMPLAIN_IF(self->_chunk == NULL);
+
+    arena_chunk_t *chunk = self->_chunk;
+
+    self->_chunk = chunk->_prev;
+    chunk->_prev = self->_spare;
+    self->_spare = chunk;
+  }
+
+  if (self->_chunk) {
+    self->_chunk->_used = mark._used;
+  }
+
+  self->_last = mark._last;
+}
+
+void arena_reset(arena_t *self) {
+  arena_rewind(self, (arena_mark_t){._chunk = NULL, ._used = 0, ._last = NULL});
+}
+
+size_t arena_used(const arena_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  size_t used = 0;
+
+  for (arena_chunk_t *chunk = self->_chunk; chunk; chunk = chunk->_prev) {
+    used += chunk->_used;
+  }
+
+  return (used);
+}
+
+const array_allocator_t *arena_allocator(arena_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (&self->_allocator);
+}
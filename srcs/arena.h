@@ -0,0 +1,76 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include "array.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct arena_chunk arena_chunk_t;
+
+typedef struct {
+  arena_chunk_t *_chunk; /* The chunk allocations are bumped from, chunks are
+                          * chained backwards through their '_prev' */
+  arena_chunk_t *_spare; /* Chunks released by a rewind, kept for reuse */
+  void *_last;           /* The most recent allocation, the only one that can
+                          * be grown in place or given back on free */
+  size_t _chunk_size;    /* The minimum size of a new chunk (in bytes) */
+
+  array_allocator_t _allocator; /* The arena seen as an array allocator */
+} arena_t;
+
+typedef struct {
+  arena_chunk_t *_chunk;
+  size_t _used;
+  void *_last;
+} arena_mark_t;
+
+/* Creates an empty arena that reserves memory by chunks of at least
+ * 'chunk_size' bytes (ARENA_CHUNK_SIZE if 0).
+ */
+arena_t *arena_create(size_t chunk_size);
+
+/* Frees the arena and all the memory obtained from it at once.
+ */
+void arena_kill(arena_t *self);
+
+/* Returns a block of 'n' bytes, aligned for any type.
+ */
+void *arena_alloc(arena_t *self, size_t n);
+
+/* Resizes the block pointed to by 'ptr' to 'n' bytes. If 'ptr' is the most
+ * recent allocation and its chunk has room, the block grows in place,
+ * otherwise it is copied to a new block and the old one is left unused
+ * until the next rewind.
+ */
+void *arena_realloc(arena_t *self, void *ptr, size_t n);
+
+/* Gives the block back to the arena if it is the most recent allocation,
+ * does nothing otherwise.
+ */
+void arena_free(arena_t *self, void *ptr);
+
+/* Returns the current position of the arena, to be used with 'rewind'.
+ */
+arena_mark_t arena_mark(const arena_t *self);
+
+/* Releases every allocation made after 'mark' was taken. Containers built
+ * on the arena after that point must not be used (nor killed) anymore.
+ */
+void arena_rewind(arena_t *self, arena_mark_t mark);
+
+/* Releases every allocation made from the arena, the chunks are kept for
+ * reuse.
+ */
+void arena_reset(arena_t *self);
+
+/* Returns the number of bytes currently handed out by the arena, headers
+ * and padding included.
+ */
+size_t arena_used(const arena_t *self);
+
+/* Returns an allocator that can be passed to the '*_with_allocator'
+ * constructors. It stays valid until the arena is killed.
+ */
+const array_allocator_t *arena_allocator(arena_t *self);
+
+#endif /* __ARENA_H__ */
@@ -1,13 +1,45 @@
 #include "array.h"
 #include "internal.h"
+#include "pages.h"
+#include "search.h"
+#include "swap.h"
+#include <fcntl.h>
 #include <limits.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-array_allocator_t __array_allocator__ = {
-    ._memory_alloc = malloc, ._memory_realloc = realloc, ._memory_free = free};
+static PTR_TYPE(heap_alloc)(PTR_TYPE(ctx), SIZE_TYPE(n)) {
+  (void)ctx;
+  return (malloc(n));
+}
+
+static PTR_TYPE(heap_realloc)(PTR_TYPE(ctx), PTR_TYPE(ptr), SIZE_TYPE(n)) {
+  (void)ctx;
+  return (realloc(ptr, n));
+}
+
+static NONE_TYPE(heap_free)(PTR_TYPE(ctx), PTR_TYPE(ptr)) {
+  (void)ctx;
+  free(ptr);
+}
+
+array_allocator_t __array_allocator__ = {._memory_alloc = heap_alloc,
+                                         ._memory_realloc = heap_realloc,
+                                         ._memory_free = heap_free,
+                                         ._ctx = NULL};
+
+#if defined(ARRAY_SPEC_HOOKS)
+/* Only built for the specs: called by a thread whose reservation did not
+ * fit, right before it tries to grow the buffer, to force interleavings.
+ */
+void (*__array_appender_hook__)(array_appender_t *) = NULL;
+#endif
 
 /* Aligns the size by the machine word.
  */
@@ -15,8 +47,47 @@ static inline SIZE_TYPE(size_align)(SIZE_TYPE(n)) {
   return (n + sizeof(PTR_TYPE()) - 1) & ~(sizeof(PTR_TYPE()) - 1);
 }
 
-static inline BOOL_TYPE(array_init)(ARRAY_TYPE(*self), size_t size) {
-  *self = __array_allocator__._memory_alloc(sizeof(**self));
+/* Aligns the size by the page size.
+ */
+static inline SIZE_TYPE(page_align)(SIZE_TYPE(n)) {
+  return (n + ARRAY_PAGE_SIZE - 1) & ~(size_t)(ARRAY_PAGE_SIZE - 1);
+}
+
+/* The inline buffer starts right after the header, at a word boundary.
+ */
+#define _inline_data(array) ((char *)(array) + size_align(sizeof(array_t)))
+
+static inline BOOL_TYPE(array_init_inline)(ARRAY_TYPE(*self),
+                                            const array_allocator_t *allocator,
+                                            size_t size) {
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_ADD(size, sizeof(array_t)) == false);
+
+  *self = _allocator_alloc(allocator, size_align(sizeof(**self)) + size);
+
+  if (unlikely(!*self)) {
+    return (false);
+  }
+
+  (void)builtin_memset(*self, 0x00, sizeof(array_t));
+
+  _allocator((*self)) = allocator;
+  _data((*self)) = _inline_data(*self);
+  _storage((*self)) = ARRAY_STORAGE_INLINE;
+
+  return (true);
+}
+
+/* Small buffers are always made inline, so they cost a single allocation
+ * and share the cache lines of the header until they outgrow it.
+ */
+static inline BOOL_TYPE(array_init)(ARRAY_TYPE(*self),
+                                     const array_allocator_t *allocator,
+                                     size_t size) {
+  if (size <= ARRAY_SBO_SIZE) {
+    return (array_init_inline(self, allocator, size));
+  }
+
+  *self = _allocator_alloc(allocator, sizeof(**self));
 
   if (unlikely(!*self)) {
     return (false);
@@ -24,10 +95,11 @@ static inline BOOL_TYPE(array_init)(ARRAY_TYPE(*self), size_t size) {
 
   (void)builtin_memset(*self, 0x00, sizeof(array_t));
 
-  _data((*self)) = __array_allocator__._memory_alloc(size);
+  _allocator((*self)) = allocator;
+  _data((*self)) = _allocator_alloc(allocator, size);
 
   if (unlikely(!_data((*self)))) {
-    __array_allocator__._memory_free(*self);
+    _allocator_free(allocator, *self);
     return (false);
   }
 
@@ -36,6 +108,19 @@ static inline BOOL_TYPE(array_init)(ARRAY_TYPE(*self), size_t size) {
 
 ARRAY_TYPE(array_create)
 (SIZE_TYPE(elt_size), SIZE_TYPE(n), void (*free)(void *)) {
+  return (array_create_with_allocator(&__array_allocator__, elt_size, n, free));
+}
+
+ARRAY_TYPE(array_create_inline)
+(SIZE_TYPE(elt_size), SIZE_TYPE(n), void (*free)(void *)) {
+  return (array_create_inline_with_allocator(&__array_allocator__, elt_size, n,
+                                             free));
+}
+
+ARRAY_TYPE(array_create_inline_with_allocator)
+(const array_allocator_t *allocator, SIZE_TYPE(elt_size), SIZE_TYPE(n),
+ void (*free)(void *)) {
+  HR_COMPLAIN_IF(allocator == NULL);
   HR_COMPLAIN_IF(elt_size == 0);
   HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(elt_size, n) == false);
 
@@ -46,7 +131,31 @@ ARRAY_TYPE(array_create)
   ARRAY_TYPE(array) = NULL;
   SIZE_TYPE(init_cap) = size_align(elt_size * n);
 
-  if (likely(array_init(&array, init_cap))) {
+  if (likely(array_init_inline(&array, allocator, init_cap))) {
+    _typesize(array) = elt_size;
+    _capacity(array) = init_cap;
+    _freefunc(array) = free;
+    _is_owner(array) = true;
+  }
+
+  return (array);
+}
+
+ARRAY_TYPE(array_create_with_allocator)
+(const array_allocator_t *allocator, SIZE_TYPE(elt_size), SIZE_TYPE(n),
+ void (*free)(void *)) {
+  HR_COMPLAIN_IF(allocator == NULL);
+  HR_COMPLAIN_IF(elt_size == 0);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(elt_size, n) == false);
+
+  if (!n) {
+    n = ARRAY_INITIAL_SIZE;
+  }
+
+  ARRAY_TYPE(array) = NULL;
+  SIZE_TYPE(init_cap) = size_align(elt_size * n);
+
+  if (likely(array_init(&array, allocator, init_cap))) {
     _typesize(array) = elt_size;
     _capacity(array) = init_cap;
     _freefunc(array) = free;
@@ -59,15 +168,24 @@ ARRAY_TYPE(array_create)
 ARRAY_TYPE(array_seize_buffer)
 (PTR_TYPE(*buffer), SIZE_TYPE(bufsize), SIZE_TYPE(elt_size), SIZE_TYPE(n),
  void (*_free)(void *)) {
+  return (array_seize_buffer_with_allocator(&__array_allocator__, buffer, bufsize,
+                                          elt_size, n, _free));
+}
+
+ARRAY_TYPE(array_seize_buffer_with_allocator)
+(const array_allocator_t *allocator, PTR_TYPE(*buffer), SIZE_TYPE(bufsize),
+ SIZE_TYPE(elt_size), SIZE_TYPE(n), void (*_free)(void *)) {
+  HR_COMPLAIN_IF(allocator == NULL);
   HR_COMPLAIN_IF(elt_size == 0);
   HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(elt_size, n) == false);
 
   ARRAY_TYPE(self) = NULL;
 
-  self = __array_allocator__._memory_alloc(sizeof(*self));
+  self = _allocator_alloc(allocator, sizeof(*self));
 
   if (likely(self)) {
     (void)builtin_memset(self, 0x00, sizeof(array_t));
+    _allocator(self) = allocator;
     _capacity(self) = bufsize;
     _size(self) = n;
     _typesize(self) = elt_size;
@@ -83,15 +201,24 @@ ARRAY_TYPE(array_seize_buffer)
 ARRAY_TYPE(array_borrow_buffer)
 (PTR_TYPE(*buffer), SIZE_TYPE(bufsize), SIZE_TYPE(elt_size), SIZE_TYPE(n),
  void (*_free)(void *)) {
+  return (array_borrow_buffer_with_allocator(&__array_allocator__, buffer, bufsize,
+                                          elt_size, n, _free));
+}
+
+ARRAY_TYPE(array_borrow_buffer_with_allocator)
+(const array_allocator_t *allocator, PTR_TYPE(*buffer), SIZE_TYPE(bufsize),
+ SIZE_TYPE(elt_size), SIZE_TYPE(n), void (*_free)(void *)) {
+  HR_COMPLAIN_IF(allocator == NULL);
   HR_COMPLAIN_IF(elt_size == 0);
   HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(elt_size, n) == false);
 
   ARRAY_TYPE(self) = NULL;
 
-  self = __array_allocator__._memory_alloc(sizeof(*self));
+  self = _allocator_alloc(allocator, sizeof(*self));
 
   if (likely(self)) {
     (void)builtin_memset(self, 0x00, sizeof(array_t));
+    _allocator(self) = allocator;
     _capacity(self) = bufsize;
     _size(self) = n;
     _typesize(self) = elt_size;
@@ -104,13 +231,73 @@ ARRAY_TYPE(array_borrow_buffer)
   return (self);
 }
 
+ARRAY_TYPE(array_map_file)
+(const char *path, SIZE_TYPE(elt_size), array_map_mode_t mode) {
+  HR_COMPLAIN_IF(path == NULL);
+  HR_COMPLAIN_IF(elt_size == 0);
+
+  bool writable = (mode == ARRAY_MAP_RDWR);
+  int fd = writable ? open(path, O_RDWR | O_CREAT, 0644) : open(path, O_RDONLY);
+  struct stat st;
+
+  if (unlikely(fd == -1)) {
+    return (NULL);
+  }
+
+  if (unlikely(fstat(fd, &st) == -1)) {
+    goto error;
+  }
+
+  SIZE_TYPE(size) = (size_t)st.st_size;
+  HR_COMPLAIN_IF(size % elt_size != 0);
+
+  /* The file is left as it is until the array needs more room: only then
+   * is it extended, to whole pages, and remapped. */
+  SIZE_TYPE(cap) = size;
+  PTR_TYPE(ptr) = NULL;
+
+  if (cap) {
+    ptr = pages_map_file(fd, cap, writable);
+    if (unlikely(!ptr)) {
+      goto error;
+    }
+  }
+
+  ARRAY_TYPE(self) = _allocator_alloc(&__array_allocator__, sizeof(*self));
+
+  if (unlikely(!self)) {
+    if (ptr) {
+      pages_unmap(ptr, cap);
+    }
+    goto error;
+  }
+
+  (void)builtin_memset(self, 0x00, sizeof(array_t));
+  _allocator(self) = &__array_allocator__;
+  _data(self) = ptr;
+  _capacity(self) = cap;
+  _size(self) = size / elt_size;
+  _typesize(self) = elt_size;
+  _storage(self) = ARRAY_STORAGE_FILE;
+  _fd(self) = fd;
+  _is_owner(self) = writable;
+  _settled(self) = !writable;
+
+  return (self);
+
+error:
+  (void)close(fd);
+  return (NULL);
+}
+
 ARRAY_TYPE(array_filter)
 (RDONLY_ARRAY_TYPE(self), bool (*callback)(RDONLY_PTR_TYPE(elem))) {
   HR_COMPLAIN_IF(self == NULL);
   HR_COMPLAIN_IF(callback == NULL);
 
   ARRAY_TYPE(array) =
-      array_create(_typesize(self), ARRAY_INITIAL_SIZE, _freefunc(self));
+      array_create_with_allocator(_allocator(self), _typesize(self),
+                                  ARRAY_INITIAL_SIZE, _freefunc(self));
 
   if (unlikely(!array)) {
     return (NULL);
@@ -137,6 +324,241 @@ error:
   return (NULL);
 }
 
+BOOL_TYPE(array_foreach)(ARRAY_TYPE(self), bool (*callback)(PTR_TYPE(elem))) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(callback == NULL);
+
+  for (SIZE_TYPE(i) = 0; i < _size(self); i++) {
+    if (!callback(_relative_data(self, i))) {
+      return (false);
+    }
+  }
+
+  return (true);
+}
+
+/* Copies the elements of 'src' in [start, end) whose bit is set in 'keep'
+ * to 'dst', each run of consecutive elements at once. Returns the number of
+ * elements copied.
+ */
+static SIZE_TYPE(array_copy_selected)
+(PTR_TYPE(dst), RDONLY_ARRAY_TYPE(src), const ut64_t *keep, SIZE_TYPE(start),
+ SIZE_TYPE(end)) {
+  SIZE_TYPE(out) = 0;
+
+  for (SIZE_TYPE(w) = start; w < end; w += 64) {
+    ut64_t bits = keep[w / 64];
+
+    if (end - w < 64) {
+      bits &= ((ut64_t)1 << (end - w)) - 1;
+    }
+
+    while (bits) {
+      SIZE_TYPE(first) = (size_t)__builtin_ctzll(bits);
+      ut64_t rest = ~(bits >> first);
+      SIZE_TYPE(len) = rest ? (size_t)__builtin_ctzll(rest) : 64 - first;
+
+      (void)builtin_memcpy((char *)dst + out * _typesize(src),
+                           _relative_data(src, w + first),
+                           len * _typesize(src));
+      out += len;
+      bits &= first + len < 64 ? ~(ut64_t)0 << (first + len) : 0;
+    }
+  }
+
+  return (out);
+}
+
+ARRAY_TYPE(array_filter_batch)
+(RDONLY_ARRAY_TYPE(self),
+ void (*callback)(RDONLY_PTR_TYPE(elems), SIZE_TYPE(n), ut64_t *keep)) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(callback == NULL);
+
+  SIZE_TYPE(size) = _size(self);
+  SIZE_TYPE(nwords) = (size + 63) / 64;
+  SIZE_TYPE(total) = 0;
+  ut64_t *keep = _allocator_alloc(_allocator(self),
+                                  sizeof(*keep) * MAX(nwords, 1));
+  ARRAY_TYPE(array) = NULL;
+
+  if (unlikely(!keep)) {
+    return (NULL);
+  }
+
+  (void)builtin_memset(keep, 0x00, sizeof(*keep) * nwords);
+
+  /* ARRAY_BATCH_SIZE is a multiple of 64, every batch starts on a word */
+  for (SIZE_TYPE(i) = 0; i < size; i += ARRAY_BATCH_SIZE) {
+    callback(_relative_data(self, i), MIN(ARRAY_BATCH_SIZE, size - i),
+             keep + i / 64);
+  }
+
+  if (size % 64) {
+    keep[nwords - 1] &= ((ut64_t)1 << (size % 64)) - 1;
+  }
+  for (SIZE_TYPE(i) = 0; i < nwords; i++) {
+    total += (size_t)__builtin_popcountll(keep[i]);
+  }
+
+  array = array_create_with_allocator(_allocator(self), _typesize(self), total,
+                                      _freefunc(self));
+
+  if (likely(array)) {
+    _size(array) = array_copy_selected(_data(array), self, keep, 0, size);
+  }
+
+  _allocator_free(_allocator(self), keep);
+
+  return (array);
+}
+
+BOOL_TYPE(array_foreach_batch)
+(ARRAY_TYPE(self), bool (*callback)(PTR_TYPE(elems), SIZE_TYPE(n))) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(callback == NULL);
+
+  SIZE_TYPE(size) = _size(self);
+
+  for (SIZE_TYPE(i) = 0; i < size; i += ARRAY_BATCH_SIZE) {
+    if (!callback(_relative_data(self, i), MIN(ARRAY_BATCH_SIZE, size - i))) {
+      return (false);
+    }
+  }
+
+  return (true);
+}
+
+SSIZE_TYPE(array_find_index_batch)
+(ARRAY_TYPE(self),
+ SIZE_TYPE((*callback)(RDONLY_PTR_TYPE(elems), SIZE_TYPE(n)))) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(callback == NULL);
+
+  SIZE_TYPE(size) = _size(self);
+
+  for (SIZE_TYPE(i) = 0; i < size; i += ARRAY_BATCH_SIZE) {
+    SIZE_TYPE(n) = MIN(ARRAY_BATCH_SIZE, size - i);
+    SIZE_TYPE(found) = callback(_relative_data(self, i), n);
+
+    if (found < n) {
+      return ((st64_t)(i + found));
+    }
+  }
+
+  return (-1);
+}
+
+PTR_TYPE(array_find_batch)
+(ARRAY_TYPE(self),
+ SIZE_TYPE((*callback)(RDONLY_PTR_TYPE(elems), SIZE_TYPE(n)))) {
+  SSIZE_TYPE(i) = array_find_index_batch(self, callback);
+
+  return (i == -1 ? NULL : _relative_data(self, (size_t)i));
+}
+
+__attr_pure
+    SSIZE_TYPE(array_find_index)(ARRAY_TYPE(self),
+                                 bool (*callback)(RDONLY_PTR_TYPE(elem))) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(callback == NULL);
+
+  for (SIZE_TYPE(i) = 0; i < _size(self); i++) {
+    if (callback(_relative_data(self, i))) {
+      return ((st64_t)i);
+    }
+  }
+
+  return (-1);
+}
+
+__attr_pure PTR_TYPE(array_find)(ARRAY_TYPE(self),
+                                 bool (*callback)(RDONLY_PTR_TYPE(elem))) {
+  SSIZE_TYPE(i) = array_find_index(self, callback);
+
+  return (i == -1 ? NULL : _relative_data(self, (size_t)i));
+}
+
+__attr_pure
+    SSIZE_TYPE(array_rfind_index)(ARRAY_TYPE(self),
+                                  bool (*callback)(RDONLY_PTR_TYPE(elem))) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(callback == NULL);
+
+  for (SIZE_TYPE(i) = _size(self); i > 0; i--) {
+    if (callback(_relative_data(self, i - 1))) {
+      return ((st64_t)(i - 1));
+    }
+  }
+
+  return (-1);
+}
+
+__attr_pure PTR_TYPE(array_rfind)(ARRAY_TYPE(self),
+                                  bool (*callback)(RDONLY_PTR_TYPE(elem))) {
+  SSIZE_TYPE(i) = array_rfind_index(self, callback);
+
+  return (i == -1 ? NULL : _relative_data(self, (size_t)i));
+}
+
+__attr_pure SSIZE_TYPE(array_find_value_index)(RDONLY_ARRAY_TYPE(self),
+                                               RDONLY_PTR_TYPE(value)) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(value == NULL);
+
+  SIZE_TYPE(i) = search_find(_data(self), _size(self), _typesize(self), value);
+
+  return (i == _size(self) ? -1 : (st64_t)i);
+}
+
+__attr_pure PTR_TYPE(array_find_value)(RDONLY_ARRAY_TYPE(self),
+                                       RDONLY_PTR_TYPE(value)) {
+  SSIZE_TYPE(i) = array_find_value_index(self, value);
+
+  return (i == -1 ? NULL : _relative_data(self, (size_t)i));
+}
+
+__attr_pure BOOL_TYPE(array_contains_value)(RDONLY_ARRAY_TYPE(self),
+                                            RDONLY_PTR_TYPE(value)) {
+  return (array_find_value_index(self, value) != -1);
+}
+
+__attr_pure SIZE_TYPE(array_count_value)(RDONLY_ARRAY_TYPE(self),
+                                         RDONLY_PTR_TYPE(value)) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(value == NULL);
+
+  return (search_count(_data(self), _size(self), _typesize(self), value));
+}
+
+BOOL_TYPE(array_minmax)
+(RDONLY_ARRAY_TYPE(self), BOOL_TYPE(is_signed), PTR_TYPE(min), PTR_TYPE(max)) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  SIZE_TYPE(size) = _typesize(self);
+  BOOL_TYPE(is_integer) = size == 1 || size == 2 || size == 4 || size == 8;
+  ut64_t lo;
+  ut64_t hi;
+
+  HR_COMPLAIN_IF(is_integer == false);
+
+  /* Any other size has no kernel, and would not fit in 'lo' and 'hi'. */
+  if (unlikely(!is_integer || !_size(self))) {
+    return (false);
+  }
+
+  search_minmax(_data(self), _size(self), _typesize(self), is_signed, &lo,
+                &hi);
+  if (min) {
+    (void)builtin_memcpy(min, &lo, _typesize(self));
+  }
+  if (max) {
+    (void)builtin_memcpy(max, &hi, _typesize(self));
+  }
+
+  return (true);
+}
+
 PTR_TYPE(array_extract)
 (RDONLY_ARRAY_TYPE(src), SIZE_TYPE(start), SIZE_TYPE(end)) {
   HR_COMPLAIN_IF(src == NULL);
@@ -146,7 +568,7 @@ PTR_TYPE(array_extract)
   HR_COMPLAIN_IF((_size(src) - start) < (end - start));
 
   PTR_TYPE(ptr) =
-      __array_allocator__._memory_alloc((end - start) * _typesize(src));
+      _allocator_alloc(_allocator(src), (end - start) * _typesize(src));
 
   if (likely(ptr)) {
     (void)builtin_memcpy(ptr, _relative_data(src, start),
@@ -177,7 +599,7 @@ ARRAY_TYPE(array_pull)
   SIZE_TYPE(n_elems) = labs(start - end);
   SIZE_TYPE(buffersize) = n_elems * _typesize(src);
 
-  if (unlikely(!array_init(&arr, buffersize))) {
+  if (unlikely(!array_init(&arr, _allocator(src), buffersize))) {
     return (NULL);
   }
 
@@ -220,13 +642,118 @@ NONE_TYPE(array_clear)(ARRAY_TYPE(self)) {
 NONE_TYPE(array_kill)(ARRAY_TYPE(self)) {
   HR_COMPLAIN_IF(self == NULL);
 
+  SIZE_TYPE(used) = array_sizeof(self);
+
   array_clear(self);
 
   if (_is_owner(self)) {
-    __array_allocator__._memory_free(_data(self));
+    if (_storage(self) == ARRAY_STORAGE_SEPARATE) {
+      _allocator_free(_allocator(self), _data(self));
+    } else if (_storage(self) == ARRAY_STORAGE_MAPPED) {
+      pages_unmap(_data(self), _capacity(self));
+    }
+  }
+
+  if (_storage(self) == ARRAY_STORAGE_FILE) {
+    if (_data(self)) {
+      /* The records of a read-only mapping may start past the beginning of
+       * the first page (see 'array_load_mapped'). */
+      char *base = (char *)((uintptr_t)_data(self) &
+                            ~(uintptr_t)(ARRAY_PAGE_SIZE - 1));
+      pages_unmap(base, _capacity(self) + ((char *)_data(self) - base));
+    }
+    if (_is_owner(self)) {
+      (void)ftruncate(_fd(self), (off_t)used);
+    }
+    (void)close(_fd(self));
+  }
+
+  _allocator_free(_allocator(self), self);
+}
+
+/* Returns the capacity the growth policy of 'self' asks for when the
+ * buffer is full.
+ */
+static inline SIZE_TYPE(array_grown_capacity)(RDONLY_ARRAY_TYPE(self)) {
+  switch (_growth(self)) {
+  case ARRAY_GROWTH_HALF:
+    return (_capacity(self) + _capacity(self) / 2);
+  case ARRAY_GROWTH_CHUNK:
+    return (_capacity(self) + _growth_step(self) * _typesize(self));
+  case ARRAY_GROWTH_PAGES:
+    return (page_align(_capacity(self) + _capacity(self) / 2));
+  case ARRAY_GROWTH_DOUBLE:
+  default:
+    return (_capacity(self) * 2);
+  }
+}
+
+/* Gives 'self' a bigger buffer of (at least) 'new_size' bytes, holding the
+ * current data.
+ */
+static BOOL_TYPE(array_move)(ARRAY_TYPE(self), SIZE_TYPE(new_size)) {
+  PTR_TYPE(ptr) = NULL;
+
+  if (_storage(self) == ARRAY_STORAGE_FILE) {
+    new_size = page_align(new_size);
+
+    if (unlikely(ftruncate(_fd(self), (off_t)new_size) == -1)) {
+      return (false);
+    }
+
+    /* The mapping of a file opened by 'array_map_file' covers the whole
+     * pages its records were on. */
+    if (_data(self)) {
+      ptr = pages_remap_file(_fd(self), _data(self),
+                             page_align(_capacity(self)), new_size);
+    } else {
+      ptr = pages_map_file(_fd(self), new_size, true);
+    }
+
+    if (unlikely(!ptr)) {
+      (void)ftruncate(_fd(self), (off_t)_capacity(self));
+    }
+
+  } else if (_storage(self) == ARRAY_STORAGE_MAPPED) {
+    new_size = page_align(new_size);
+    ptr = pages_remap(_data(self), _capacity(self), new_size);
+
+  } else if (new_size >= ARRAY_MMAP_THRESHOLD &&
+             _allocator(self) == &__array_allocator__) {
+    new_size = page_align(new_size);
+    ptr = pages_map(new_size);
+
+    if (likely(ptr)) {
+      (void)builtin_memcpy(ptr, _data(self), array_sizeof(self));
+      if (_storage(self) == ARRAY_STORAGE_SEPARATE) {
+        _allocator_free(_allocator(self), _data(self));
+      }
+      _storage(self) = ARRAY_STORAGE_MAPPED;
+    }
+
+  } else if (_storage(self) == ARRAY_STORAGE_INLINE) {
+    /* The inline buffer cannot be reallocated, the data moves out to a
+     * buffer of its own and the inline space is left unused. */
+    ptr = _allocator_alloc(_allocator(self), new_size);
+
+    if (likely(ptr)) {
+      (void)builtin_memcpy(ptr, _data(self), array_sizeof(self));
+      _storage(self) = ARRAY_STORAGE_SEPARATE;
+    }
+
+  } else {
+    ptr = _allocator_realloc(_allocator(self), _data(self), new_size);
   }
 
-  __array_allocator__._memory_free(self);
+  if (unlikely(!ptr)) {
+    return (false);
+  }
+
+  _data(self) = ptr;
+  _capacity(self) = new_size;
+  _reallocs(self)++;
+
+  return (true);
 }
 
 BOOL_TYPE(array_adjust)(ARRAY_TYPE(self), SIZE_TYPE(n)) {
@@ -237,6 +764,13 @@ BOOL_TYPE(array_adjust)(ARRAY_TYPE(self), SIZE_TYPE(n)) {
 
   SIZE_TYPE(new_size) = 0;
 
+  /* A size that does not fit in memory must not wrap around into one that
+   * seems to fit. */
+  if (unlikely(!SIZE_T_SAFE_TO_ADD(_size(self), n) ||
+               !SIZE_T_SAFE_TO_MUL(_size(self) + n, _typesize(self)))) {
+    return (false);
+  }
+
   n += _size(self);
   n *= _typesize(self);
 
@@ -248,31 +782,23 @@ BOOL_TYPE(array_adjust)(ARRAY_TYPE(self), SIZE_TYPE(n)) {
     return (false);
   }
 
-  SIZE_TYPE(cap_2x) = _capacity(self) * 2;
+  SIZE_TYPE(grown) = size_align(array_grown_capacity(self));
 
-  if (cap_2x < ARRAY_INITIAL_SIZE) {
-    cap_2x = ARRAY_INITIAL_SIZE;
+  if (grown < ARRAY_INITIAL_SIZE) {
+    grown = ARRAY_INITIAL_SIZE;
   } else {
-    if (unlikely(cap_2x > SIZE_TYPE_MAX))
+    if (unlikely(grown < _capacity(self)))
       return (false);
   }
 
-  if (n > cap_2x) {
-    new_size = size_align(n);
+  if (n > grown) {
+    new_size = _growth(self) == ARRAY_GROWTH_PAGES ? page_align(n)
+                                                   : size_align(n);
   } else {
-    new_size = cap_2x;
+    new_size = grown;
   }
 
-  PTR_TYPE(ptr) = __array_allocator__._memory_realloc(_data(self), new_size);
-
-  if (unlikely(!ptr)) {
-    return (false);
-  }
-
-  _data(self) = ptr;
-  _capacity(self) = new_size;
-
-  return (true);
+  return (array_move(self, new_size));
 }
 
 BOOL_TYPE(array_push)(ARRAY_TYPE(self), RDONLY_PTR_TYPE(e)) {
@@ -396,6 +922,253 @@ BOOL_TYPE(array_append)(ARRAY_TYPE(self), RDONLY_PTR_TYPE(src), SIZE_TYPE(n)) {
   return (true);
 }
 
+array_appender_t *array_appender_begin(ARRAY_TYPE(self)) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  array_appender_t *app = _allocator_alloc(_allocator(self), sizeof(*app));
+
+  if (unlikely(!app)) {
+    return (NULL);
+  }
+
+  (void)builtin_memset(app, 0x00, sizeof(*app));
+  app->_array = self;
+  atomic_init(&app->_cursor, _size(self));
+  atomic_init(&app->_overflow, SIZE_MAX);
+  atomic_init(&app->_writers, 0);
+  atomic_init(&app->_growing, false);
+
+  return (app);
+}
+
+static NONE_TYPE(array_release_buffer)(ARRAY_TYPE(self), array_retired_t *old) {
+  if (old->_storage == ARRAY_STORAGE_SEPARATE) {
+    _allocator_free(_allocator(self), old->_ptr);
+  } else if (old->_storage == ARRAY_STORAGE_MAPPED ||
+             old->_storage == ARRAY_STORAGE_FILE) {
+    pages_unmap(old->_ptr, old->_cap);
+  }
+}
+
+NONE_TYPE(array_appender_end)(array_appender_t *app) {
+  HR_COMPLAIN_IF(app == NULL);
+  HR_COMPLAIN_IF(atomic_load(&app->_writers) != 0);
+
+  ARRAY_TYPE(self) = app->_array;
+  array_retired_t *next = NULL;
+
+  _size(self) = MIN(atomic_load(&app->_cursor), atomic_load(&app->_overflow));
+
+  for (array_retired_t *old = app->_retired; old; old = next) {
+    next = old->_next;
+    array_release_buffer(self, old);
+    _allocator_free(_allocator(self), old);
+  }
+
+  _allocator_free(_allocator(self), app);
+}
+
+/* Same as 'array_move', except that the old buffer is never released nor
+ * remapped: it goes to the retired list of 'app' instead. Only the first
+ * 'used' bytes are carried over.
+ */
+static BOOL_TYPE(array_move_retiring)
+(array_appender_t *app, SIZE_TYPE(new_size), SIZE_TYPE(used)) {
+  ARRAY_TYPE(self) = app->_array;
+  PTR_TYPE(ptr) = NULL;
+  array_storage_t storage = _storage(self);
+  array_retired_t *old = NULL;
+
+  if (_is_owner(self) && _data(self) && storage != ARRAY_STORAGE_INLINE) {
+    old = _allocator_alloc(_allocator(self), sizeof(*old));
+    if (unlikely(!old)) {
+      return (false);
+    }
+  }
+
+  if (storage == ARRAY_STORAGE_FILE) {
+    /* Both mappings share the file pages, nothing needs to be copied. */
+    new_size = page_align(new_size);
+
+    if (likely(ftruncate(_fd(self), (off_t)new_size) != -1)) {
+      ptr = pages_map_file(_fd(self), new_size, true);
+    }
+
+  } else if (new_size >= ARRAY_MMAP_THRESHOLD &&
+             _allocator(self) == &__array_allocator__) {
+    new_size = page_align(new_size);
+    ptr = pages_map(new_size);
+    storage = ARRAY_STORAGE_MAPPED;
+
+  } else {
+    ptr = _allocator_alloc(_allocator(self), new_size);
+    storage = ARRAY_STORAGE_SEPARATE;
+  }
+
+  if (unlikely(!ptr)) {
+    if (old) {
+      _allocator_free(_allocator(self), old);
+    }
+    return (false);
+  }
+
+  if (_storage(self) != ARRAY_STORAGE_FILE) {
+    (void)builtin_memcpy(ptr, _data(self), used);
+  }
+
+  if (old) {
+    old->_ptr = _data(self);
+    old->_cap = _capacity(self);
+    old->_storage = _storage(self);
+    old->_next = app->_retired;
+    app->_retired = old;
+  }
+
+  _data(self) = ptr;
+  _capacity(self) = new_size;
+  _storage(self) = storage;
+  _is_owner(self) = true;
+  _reallocs(self)++;
+
+  return (true);
+}
+
+/* Makes room for 'n' more elements once a reservation did not fit. Returns
+ * false if the buffer cannot grow.
+ */
+static BOOL_TYPE(array_appender_grow)(array_appender_t *app, SIZE_TYPE(n)) {
+  ARRAY_TYPE(self) = app->_array;
+  BOOL_TYPE(expected) = false;
+  BOOL_TYPE(ret) = true;
+
+  if (unlikely(_settled(self))) {
+    return (false);
+  }
+
+  if (!atomic_compare_exchange_strong(&app->_growing, &expected, true)) {
+    /* Another thread is growing the buffer, try again after it's done. */
+    while (atomic_load(&app->_growing)) {
+      sched_yield();
+    }
+    return (true);
+  }
+
+  /* Another thread may have grown the buffer after this one overflowed,
+   * in which case the overflow it recorded is gone already. */
+  if (atomic_load(&app->_overflow) == SIZE_MAX) {
+    atomic_store(&app->_growing, false);
+    return (true);
+  }
+
+  /* The reservations that fitted are all below the first one that didn't,
+   * wait until they are filled. */
+  while (atomic_load(&app->_writers) != 0) {
+    sched_yield();
+  }
+
+  SIZE_TYPE(used) = atomic_load(&app->_overflow);
+
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_ADD(used, n) == false);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(used + n, _typesize(self)) == false);
+
+  SIZE_TYPE(needed) = (used + n) * _typesize(self);
+
+  if (needed > _capacity(self)) {
+    SIZE_TYPE(new_size) = size_align(array_grown_capacity(self));
+
+    if (new_size < ARRAY_INITIAL_SIZE) {
+      new_size = ARRAY_INITIAL_SIZE;
+    }
+    if (needed > new_size) {
+      new_size = _growth(self) == ARRAY_GROWTH_PAGES ? page_align(needed)
+                                                     : size_align(needed);
+    }
+    ret = array_move_retiring(app, new_size, used * _typesize(self));
+  }
+
+  if (likely(ret)) {
+    atomic_store(&app->_cursor, used);
+    atomic_store(&app->_overflow, SIZE_MAX);
+  }
+  atomic_store(&app->_growing, false);
+
+  return (ret);
+}
+
+PTR_TYPE(array_reserve_concurrent)
+(array_appender_t *app, SIZE_TYPE(n), SIZE_TYPE(*index)) {
+  HR_COMPLAIN_IF(app == NULL);
+
+  ARRAY_TYPE(self) = app->_array;
+
+  for (;;) {
+    atomic_fetch_add(&app->_writers, 1);
+
+    if (unlikely(atomic_load(&app->_growing))) {
+      atomic_fetch_sub(&app->_writers, 1);
+      while (atomic_load(&app->_growing)) {
+        sched_yield();
+      }
+      continue;
+    }
+
+    /* The buffer can only be replaced once '_writers' drops to zero, so
+     * it is safe to use until the reservation is committed. */
+    SIZE_TYPE(at) =
+        atomic_fetch_add_explicit(&app->_cursor, n, memory_order_relaxed);
+    SIZE_TYPE(cap) = _capacity(self) / _typesize(self);
+
+    if (likely(at <= cap && n <= cap - at)) {
+      if (index) {
+        *index = at;
+      }
+      return (_relative_data(self, at));
+    }
+
+    /* Remember where the usable part ends, then let the buffer grow. */
+    SIZE_TYPE(first) = atomic_load(&app->_overflow);
+
+    while (at < first &&
+           !atomic_compare_exchange_weak(&app->_overflow, &first, at))
+      ;
+
+    atomic_fetch_sub(&app->_writers, 1);
+
+#if defined(ARRAY_SPEC_HOOKS)
+    if (__array_appender_hook__) {
+      __array_appender_hook__(app);
+    }
+#endif
+
+    if (unlikely(!array_appender_grow(app, n))) {
+      return (NULL);
+    }
+  }
+}
+
+NONE_TYPE(array_commit_concurrent)(array_appender_t *app) {
+  HR_COMPLAIN_IF(app == NULL);
+
+  atomic_fetch_sub_explicit(&app->_writers, 1, memory_order_release);
+}
+
+BOOL_TYPE(array_append_concurrent)
+(array_appender_t *app, RDONLY_PTR_TYPE(src), SIZE_TYPE(n)) {
+  HR_COMPLAIN_IF(app == NULL);
+  HR_COMPLAIN_IF(src == NULL);
+
+  PTR_TYPE(slots) = array_reserve_concurrent(app, n, NULL);
+
+  if (unlikely(!slots)) {
+    return (false);
+  }
+
+  (void)builtin_memcpy(slots, src, _typesize(app->_array) * n);
+  array_commit_concurrent(app);
+
+  return (true);
+}
+
 __attr_pure RDONLY_PTR_TYPE(array_at)(RDONLY_ARRAY_TYPE(self), SIZE_TYPE(p)) {
   HR_COMPLAIN_IF(self == NULL);
   HR_COMPLAIN_IF(p >= _size(self));
@@ -449,23 +1222,96 @@ NONE_TYPE(array_evict)(ARRAY_TYPE(self), SIZE_TYPE(p)) {
 NONE_TYPE(array_wipe)(ARRAY_TYPE(self), SIZE_TYPE(start), SIZE_TYPE(end)) {
   HR_COMPLAIN_IF(self == NULL);
   HR_COMPLAIN_IF(SIZE_T_SAFE_TO_SUB(end, start) == false);
-  HR_COMPLAIN_IF(end - start > _size(self));
-
-  SIZE_TYPE(n) = end - start;
+  HR_COMPLAIN_IF(end > _size(self));
 
   if (_freefunc(self)) {
-    size_t i = 0;
-
-    while (i < n) {
+    for (SIZE_TYPE(i) = start; i < end; i++) {
       _freefunc(self)(_relative_data(self, i));
-      i++;
     }
   }
 
   (void)builtin_memmove(_relative_data(self, start), _relative_data(self, end),
-                        (_size(self) - start - n) * _typesize(self));
+                        (_size(self) - end) * _typesize(self));
+
+  _size(self) -= end - start;
+}
+
+SIZE_TYPE(array_erase_if)
+(ARRAY_TYPE(self), bool (*callback)(RDONLY_PTR_TYPE(elem))) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(callback == NULL);
+
+  SIZE_TYPE(size) = _size(self);
+  SIZE_TYPE(kept) = 0;
+
+  /* Every run of kept elements moves down at once, after the callback has
+   * seen all of them in place. */
+  for (SIZE_TYPE(i) = 0; i < size; i++) {
+    SIZE_TYPE(run) = i;
+
+    while (i < size && !callback(_relative_data(self, i))) {
+      i++;
+    }
+
+    if (kept != run) {
+      (void)builtin_memmove(_relative_data(self, kept),
+                            _relative_data(self, run),
+                            (i - run) * _typesize(self));
+    }
+    kept += i - run;
+
+    if (i < size && _freefunc(self)) {
+      _freefunc(self)(_relative_data(self, i));
+    }
+  }
+
+  _size(self) = kept;
 
-  _size(self) -= n;
+  return (size - kept);
+}
+
+NONE_TYPE(array_remove_indices)
+(ARRAY_TYPE(self), const SIZE_TYPE(*indices), SIZE_TYPE(n)) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(indices == NULL && n);
+
+  SIZE_TYPE(size) = _size(self);
+
+  HR_COMPLAIN_IF(n && indices[0] >= size);
+
+  if (!n || unlikely(indices[0] >= size)) {
+    return;
+  }
+
+  SIZE_TYPE(kept) = indices[0];
+
+  for (SIZE_TYPE(k) = 0; k < n; k++) {
+    SIZE_TYPE(i) = indices[k];
+    SIZE_TYPE(next) = k + 1 < n ? indices[k + 1] : size;
+    BOOL_TYPE(valid) = k + 1 == n || (i < next && next < size);
+
+    HR_COMPLAIN_IF(valid == false);
+
+    /* An unsorted, duplicated or out of range index would move memory
+     * outside of the array: the indices left are dropped, and the elements
+     * after this one are kept. */
+    if (unlikely(!valid)) {
+      next = size;
+      n = k + 1;
+    }
+
+    if (_freefunc(self)) {
+      _freefunc(self)(_relative_data(self, i));
+    }
+
+    /* the elements between two removed ones move down at once */
+    (void)builtin_memmove(_relative_data(self, kept),
+                          _relative_data(self, i + 1),
+                          (next - i - 1) * _typesize(self));
+    kept += next - i - 1;
+  }
+
+  _size(self) = kept;
 }
 
 NONE_TYPE(array_swap_elems)(ARRAY_TYPE(self), SIZE_TYPE(a), SIZE_TYPE(b)) {
@@ -473,16 +1319,23 @@ NONE_TYPE(array_swap_elems)(ARRAY_TYPE(self), SIZE_TYPE(a), SIZE_TYPE(b)) {
   HR_COMPLAIN_IF(a >= _size(self));
   HR_COMPLAIN_IF(b >= _size(self));
 
-  SIZE_TYPE(n) = _typesize(self);
+  if (likely(a != b)) {
+    swap_kernel(_typesize(self))(_relative_data(self, a),
+                                 _relative_data(self, b), _typesize(self));
+  }
+}
 
-  char *p = _relative_data(self, a);
-  char *q = _relative_data(self, b);
+NONE_TYPE(array_reverse)(ARRAY_TYPE(self)) {
+  HR_COMPLAIN_IF(self == NULL);
 
-  for (; n--; ++p, ++q) {
-    *p ^= *q;
-    *q ^= *p;
-    *p ^= *q;
-  }
+  swap_reverse(_data(self), _size(self), _typesize(self));
+}
+
+NONE_TYPE(array_rotate)(ARRAY_TYPE(self), SIZE_TYPE(k)) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(k > _size(self));
+
+  swap_rotate(_data(self), _size(self), k, _typesize(self));
 }
 
 __attr_pure PTR_TYPE(array_head)(RDONLY_ARRAY_TYPE(self)) {
@@ -561,11 +1414,33 @@ BOOL_TYPE(array_slimcheck)(ARRAY_TYPE(self)) {
     return (false);
   }
 
+  if (_storage(self) == ARRAY_STORAGE_INLINE) {
+    return (true);
+  }
+
+  if (_storage(self) == ARRAY_STORAGE_MAPPED ||
+      _storage(self) == ARRAY_STORAGE_FILE) {
+    SIZE_TYPE(size) = page_align(MAX(array_sizeof(self), 1));
+
+    if (size < _capacity(self) / 2) {
+      _data(self) =
+          pages_remap(_data(self), page_align(_capacity(self)), size);
+      _capacity(self) = size;
+      _reallocs(self)++;
+
+      if (_storage(self) == ARRAY_STORAGE_FILE) {
+        (void)ftruncate(_fd(self), (off_t)size);
+      }
+    }
+
+    return (true);
+  }
+
   if (likely(_capacity(self))) {
     SIZE_TYPE(size) = array_sizeof(self);
 
     if (size < _capacity(self) / 2) {
-      PTR_TYPE(ptr) = __array_allocator__._memory_realloc(_data(self), size);
+      PTR_TYPE(ptr) = _allocator_realloc(_allocator(self), _data(self), size);
 
       if (unlikely(!ptr)) {
         return (false);
@@ -573,6 +1448,7 @@ BOOL_TYPE(array_slimcheck)(ARRAY_TYPE(self)) {
 
       _data(self) = ptr;
       _capacity(self) = size;
+      _reallocs(self)++;
     }
   }
 
@@ -597,3 +1473,30 @@ __attr_pure BOOL_TYPE(array_is_settled)(RDONLY_ARRAY_TYPE(self)) {
 
   return (_settled(self));
 }
+
+NONE_TYPE(array_set_growth)
+(ARRAY_TYPE(self), array_growth_t policy, SIZE_TYPE(step)) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(policy == ARRAY_GROWTH_CHUNK && step == 0);
+
+  _growth(self) = policy;
+  _growth_step(self) = step;
+}
+
+__attr_pure array_stats_t array_stats(RDONLY_ARRAY_TYPE(self)) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  array_stats_t stats = {._reallocs = _reallocs(self),
+                         ._cap = _capacity(self),
+                         ._used = array_sizeof(self)};
+
+  stats._slack = stats._cap - stats._used;
+
+  return (stats);
+}
+
+__attr_pure const array_allocator_t *array_allocator(RDONLY_ARRAY_TYPE(self)) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (_allocator(self));
+}
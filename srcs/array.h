@@ -2,18 +2,58 @@
 #define __ARRAY_H__
 
 #include "internal.h"
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
 
 typedef struct {
-  void *(*_memory_alloc)(size_t);
-  void *(*_memory_realloc)(void *, size_t);
-  void (*_memory_free)(void *);
+  void *(*_memory_alloc)(void *, size_t);
+  void *(*_memory_realloc)(void *, void *, size_t);
+  void (*_memory_free)(void *, void *);
+  void *_ctx; /* User context, passed as the first argument of every call */
 } array_allocator_t;
 
+/* The default allocator (malloc, realloc, free), used by every function
+ * that does not take an allocator explicitly.
+ */
 extern array_allocator_t __array_allocator__;
 
+#define _allocator_alloc(allocator, n)                                         \
+  (allocator)->_memory_alloc((allocator)->_ctx, n)
+#define _allocator_realloc(allocator, ptr, n)                                  \
+  (allocator)->_memory_realloc((allocator)->_ctx, ptr, n)
+#define _allocator_free(allocator, ptr)                                        \
+  (allocator)->_memory_free((allocator)->_ctx, ptr)
+
+typedef enum {
+  ARRAY_STORAGE_SEPARATE, /* The buffer is an allocation of its own */
+  ARRAY_STORAGE_INLINE,   /* The buffer follows the array header, in the same
+                           * allocation */
+  ARRAY_STORAGE_MAPPED,   /* The buffer is an anonymous memory mapping */
+  ARRAY_STORAGE_FILE,     /* The buffer is a shared mapping of a file */
+} array_storage_t;
+
+typedef enum {
+  ARRAY_MAP_RDONLY, /* The records can only be read */
+  ARRAY_MAP_RDWR,   /* The records can be modified and appended to */
+} array_map_mode_t;
+
+typedef enum {
+  ARRAY_GROWTH_DOUBLE, /* The capacity doubles (the default) */
+  ARRAY_GROWTH_HALF,   /* The capacity grows by half of itself */
+  ARRAY_GROWTH_CHUNK,  /* The capacity grows by a fixed number of elements */
+  ARRAY_GROWTH_PAGES,  /* The capacity grows by half of itself, rounded up to
+                        * a multiple of ARRAY_PAGE_SIZE */
+} array_growth_t;
+
+typedef struct {
+  size_t _reallocs; /* The number of times the buffer was reallocated */
+  size_t _cap;      /* The number of bytes reserved */
+  size_t _used;     /* The number of bytes in use */
+  size_t _slack;    /* The number of bytes reserved but not in use */
+} array_stats_t;
+
 typedef struct {
   void *_ptr;       /* A pointer to the start of the buffer */
   size_t _nmemb;    /* The number of elements in the buffer */
@@ -24,9 +64,18 @@ typedef struct {
   bool _settled; /* Once settled, any attempts to reallocate the buffer are
                   * blocked so new pointers to the data are guaranteed to
                   * stay valid until the array is freed, or unsettled. */
+  array_storage_t _storage; /* Where the buffer lives */
+  array_growth_t _growth;   /* How the capacity grows once the buffer is full */
+  size_t _growth_step;      /* The increment of ARRAY_GROWTH_CHUNK (in
+                             * elements) */
+  size_t _reallocs;         /* The number of times the buffer was reallocated */
+  int _fd;                  /* The file backing the buffer (ARRAY_STORAGE_FILE
+                             * only) */
 
   void (*_free)(void *); /* the element destructor function */
 
+  const array_allocator_t *_allocator; /* Allocator of both the array and its
+                                        * buffer */
 } array_t;
 
 #define _data(array) array->_ptr
@@ -36,15 +85,69 @@ typedef struct {
 #define _settled(array) array->_settled
 #define _freefunc(array) array->_free
 #define _is_owner(array) array->_is_own_buffer
+#define _allocator(array) array->_allocator
+#define _storage(array) array->_storage
+#define _growth(array) array->_growth
+#define _growth_step(array) array->_growth_step
+#define _reallocs(array) array->_reallocs
+#define _fd(array) array->_fd
+
+/* A buffer replaced during a concurrent append session, kept alive until
+ * the session ends.
+ */
+typedef struct array_retired_s {
+  struct array_retired_s *_next;
+  void *_ptr;               /* The old buffer */
+  size_t _cap;              /* Its size (in bytes) */
+  array_storage_t _storage; /* How to release it */
+} array_retired_t;
+
+/* A concurrent append session on an array (see 'array_appender_begin').
+ */
+typedef struct {
+  array_t *_array;            /* The array being appended to */
+  array_retired_t *_retired;  /* The buffers replaced so far */
+
+  char _pad0[ARRAY_CACHE_LINE_SIZE];
+
+  atomic_size_t _cursor;   /* The end of the reserved elements */
+  atomic_size_t _overflow; /* The first reserved index that did not fit */
+
+  char _pad1[ARRAY_CACHE_LINE_SIZE - sizeof(size_t) * 2];
+
+  atomic_size_t _writers; /* The number of reservations not committed yet */
+  atomic_bool _growing;   /* Is a thread replacing the buffer */
+
+  char _pad2[ARRAY_CACHE_LINE_SIZE - sizeof(size_t) * 2];
+} array_appender_t;
 
 #define _relative_data(array, pos)                                             \
   ((char *)(array)->_ptr + (array)->_elt_size * (pos))
 /* Creates an array and adjusts its starting capacity to be at least
- * enough to hold 'n' elements.
+ * enough to hold 'n' elements. Buffers of up to ARRAY_SBO_SIZE bytes are
+ * made inline (see 'create_inline').
  */
 ARRAY_TYPE(array_create)
 (SIZE_TYPE(elt_size), SIZE_TYPE(n), void (*_free)(void *));
 
+/* Same as 'create', but the array header and every buffer it ever holds are
+ * obtained from (and given back to) 'allocator', which must outlive the array.
+ */
+ARRAY_TYPE(array_create_with_allocator)
+(const array_allocator_t *allocator, SIZE_TYPE(elt_size), SIZE_TYPE(n),
+ void (*_free)(void *));
+
+/* Same as 'create', but the array header and its initial buffer are made
+ * in a single allocation. The buffer moves to an allocation of its own the
+ * first time the array outgrows it.
+ */
+ARRAY_TYPE(array_create_inline)
+(SIZE_TYPE(elt_size), SIZE_TYPE(n), void (*_free)(void *));
+
+ARRAY_TYPE(array_create_inline_with_allocator)
+(const array_allocator_t *allocator, SIZE_TYPE(elt_size), SIZE_TYPE(n),
+ void (*_free)(void *));
+
 /* Creates an array with 'buffer' as the data, if the buffer was not allocated
  * through the same allocator as the array, the behavior is undefined.
  * The array takes full responsability of the buffer once this function is
@@ -54,6 +157,12 @@ ARRAY_TYPE(array_seize_buffer)
 (PTR_TYPE(*buffer), SIZE_TYPE(bufsize), SIZE_TYPE(elt_size), SIZE_TYPE(n),
  void (*_free)(void *));
 
+/* Same as 'seize_buffer', 'buffer' must come from 'allocator'.
+ */
+ARRAY_TYPE(array_seize_buffer_with_allocator)
+(const array_allocator_t *allocator, PTR_TYPE(*buffer), SIZE_TYPE(bufsize),
+ SIZE_TYPE(elt_size), SIZE_TYPE(n), void (*_free)(void *));
+
 /* This function creates an for the buffer passed as params, but the array will
  * never try to reallocate or free the buffer in use so static buffers can
  * safely be used.
@@ -62,9 +171,45 @@ ARRAY_TYPE(array_borrow_buffer)
 (PTR_TYPE(*buffer), SIZE_TYPE(bufsize), SIZE_TYPE(elt_size), SIZE_TYPE(n),
  void (*_free)(void *));
 
+/* Same as 'borrow_buffer', only the array header is taken from 'allocator'.
+ */
+ARRAY_TYPE(array_borrow_buffer_with_allocator)
+(const array_allocator_t *allocator, PTR_TYPE(*buffer), SIZE_TYPE(bufsize),
+ SIZE_TYPE(elt_size), SIZE_TYPE(n), void (*_free)(void *));
+
+/* Sets how the capacity of the array grows once the buffer is full. 'step'
+ * is the number of elements added by ARRAY_GROWTH_CHUNK and is ignored by
+ * the other policies. Whatever the policy, the buffer always grows enough
+ * to hold the requested elements.
+ */
+NONE_TYPE(array_set_growth)
+(ARRAY_TYPE(self), array_growth_t policy, SIZE_TYPE(step));
+
+/* Returns the number of reallocations the array went through and the
+ * amount of memory it leaves unused, to tune the growth policy.
+ */
+__attr_pure array_stats_t array_stats(RDONLY_ARRAY_TYPE(self));
+
+/* Opens the file at 'path' as an array of records of 'elt_size' bytes,
+ * without copying: the buffer is a shared mapping of the file.
+ * - ARRAY_MAP_RDONLY: the array does not own its buffer and is settled.
+ * - ARRAY_MAP_RDWR: the file is created if needed, the array owns its
+ *   buffer and grows by extending the file. The file keeps its size until
+ *   the array needs more room, and is trimmed to the records in use when
+ *   the array is killed.
+ * Returns NULL if the file cannot be opened or mapped.
+ */
+ARRAY_TYPE(array_map_file)
+(const char *path, SIZE_TYPE(elt_size), array_map_mode_t mode);
+
+/* Returns the allocator used by the array.
+ */
+__attr_pure const array_allocator_t *array_allocator(RDONLY_ARRAY_TYPE(self));
+
 /* Reallocates the array if more than half of the current capacity is unused.
  * If the reallocation fails the array is untouched and the function
- * returns false.
+ * returns false. An inline buffer is left as is, the unused pages of a
+ * mapped buffer are given back to the system.
  */
 BOOL_TYPE(array_slimcheck)(ARRAY_TYPE(self));
 
@@ -109,7 +254,7 @@ __attr_pure SIZE_TYPE(array_uninitialized_size)(RDONLY_ARRAY_TYPE(self));
 __attr_pure PTR_TYPE(array_uninitialized_data)(RDONLY_ARRAY_TYPE(self));
 
 /* Returns the data contained in 'self' in between start -> end into a newly
- * allocated buffer.
+ * allocated buffer, obtained from the array's allocator.
  */
 PTR_TYPE(array_extract)
 (RDONLY_ARRAY_TYPE(src), SIZE_TYPE(start), SIZE_TYPE(end));
@@ -149,6 +294,7 @@ NONE_TYPE(array_pop)(ARRAY_TYPE(self), PTR_TYPE(into));
 /* Adds a new element to the front of the array, before the
  * first element. The content of 'e' is copied (or moved) to the
  * new element.
+ * Every element is moved, queues should use a 'deque_t' instead.
  */
 BOOL_TYPE(array_pushf)(ARRAY_TYPE(self), PTR_TYPE(e));
 
@@ -179,16 +325,89 @@ BOOL_TYPE(array_inject)
  */
 BOOL_TYPE(array_append)(ARRAY_TYPE(self), RDONLY_PTR_TYPE(src), SIZE_TYPE(n));
 
+/* Starts a concurrent append session on 'self': until 'array_appender_end'
+ * is called, any number of threads may append to the array through the
+ * session, and the array itself must not be used by any other function.
+ */
+array_appender_t *array_appender_begin(ARRAY_TYPE(self));
+
+/* Ends the session, every reservation must have been committed. The size of
+ * the array then covers all the elements appended during the session, and
+ * the buffers it went through are released.
+ */
+NONE_TYPE(array_appender_end)(array_appender_t *app);
+
+/* Reserves 'n' consecutive slots at the end of the array and returns a
+ * pointer to the first one, its index being stored in 'index' if not NULL.
+ * The caller fills the slots, then calls 'array_commit_concurrent' before
+ * reserving anything else.
+ *
+ * Reserving is a single atomic increment as long as the buffer has room.
+ * When it doesn't, one thread waits for the pending reservations to be
+ * committed and moves the elements to a new buffer, following the growth
+ * policy. The old buffer is only released by 'array_appender_end', so any
+ * pointer to the data taken during the session stays readable (it just
+ * stops seeing new writes).
+ *
+ * Returns NULL if the array is settled and the slots don't fit, or if the
+ * new buffer could not be allocated.
+ */
+PTR_TYPE(array_reserve_concurrent)
+(array_appender_t *app, SIZE_TYPE(n), SIZE_TYPE(*index));
+
+/* Marks a reservation as filled, the pointer it returned must not be used
+ * anymore.
+ */
+NONE_TYPE(array_commit_concurrent)(array_appender_t *app);
+
+/* Reserves 'n' slots, copies the elements pointed to by 'src' into them and
+ * commits them.
+ */
+BOOL_TYPE(array_append_concurrent)
+(array_appender_t *app, RDONLY_PTR_TYPE(src), SIZE_TYPE(n));
+
 /* Creates a new array, filtered down to just the elements from 'self' that
  * pass the test implemented by the callback.
  */
 ARRAY_TYPE(array_filter)
 (RDONLY_ARRAY_TYPE(self), bool (*callback)(RDONLY_PTR_TYPE(elem)));
 
-/* executes a provided function once for each array element.
+/* executes a provided function once for each array element, in order. The
+ * iteration stops at the first call returning false, in which case false is
+ * returned.
  */
 BOOL_TYPE(array_foreach)(ARRAY_TYPE(self), bool (*callback)(PTR_TYPE(elem)));
 
+/* Batch versions of 'filter', 'foreach' and 'find': the callback gets up to
+ * ARRAY_BATCH_SIZE contiguous elements at once instead of a single one, so
+ * the test can be inlined and vectorized on its side.
+ */
+
+/* The callback sets bit 'i % 64' of 'keep[i / 64]' to keep 'elems[i]', the
+ * bits come zeroed. The survivors are then copied in bulk into the new array,
+ * which is allocated once to their exact count.
+ */
+ARRAY_TYPE(array_filter_batch)
+(RDONLY_ARRAY_TYPE(self),
+ void (*callback)(RDONLY_PTR_TYPE(elems), SIZE_TYPE(n), ut64_t *keep));
+
+/* The iteration stops after the first batch for which the callback returns
+ * false, in which case false is returned.
+ */
+BOOL_TYPE(array_foreach_batch)
+(ARRAY_TYPE(self), bool (*callback)(PTR_TYPE(elems), SIZE_TYPE(n)));
+
+/* The callback returns the index of the first match among 'elems', or 'n'
+ * if there is none.
+ */
+PTR_TYPE(array_find_batch)
+(ARRAY_TYPE(self),
+ SIZE_TYPE((*callback)(RDONLY_PTR_TYPE(elems), SIZE_TYPE(n))));
+
+SSIZE_TYPE(array_find_index_batch)
+(ARRAY_TYPE(self),
+ SIZE_TYPE((*callback)(RDONLY_PTR_TYPE(elems), SIZE_TYPE(n))));
+
 /* Returns the first element in 'self' that satisfies the callback.
  * If no values satisfy the testing function, NULL is returned. */
 __attr_pure PTR_TYPE(array_find)(ARRAY_TYPE(self),
@@ -210,8 +429,33 @@ __attr_pure PTR_TYPE(array_rfind)(ARRAY_TYPE(self),
  * returns an index (that can be used with 'at'), or -1 if no element was found.
  */
 __attr_pure
-    PTR_TYPE(array_rfind_index)(ARRAY_TYPE(self),
-                                bool (*callback)(RDONLY_PTR_TYPE(elem)));
+    SSIZE_TYPE(array_rfind_index)(ARRAY_TYPE(self),
+                                  bool (*callback)(RDONLY_PTR_TYPE(elem)));
+
+/* Value versions of 'find': the elements are compared with the one pointed to
+ * by 'value' without any callback. Elements of 1, 2, 4 or 8 bytes are
+ * compared as integers, a vector at a time.
+ */
+__attr_pure PTR_TYPE(array_find_value)(RDONLY_ARRAY_TYPE(self),
+                                       RDONLY_PTR_TYPE(value));
+
+__attr_pure SSIZE_TYPE(array_find_value_index)(RDONLY_ARRAY_TYPE(self),
+                                               RDONLY_PTR_TYPE(value));
+
+__attr_pure BOOL_TYPE(array_contains_value)(RDONLY_ARRAY_TYPE(self),
+                                            RDONLY_PTR_TYPE(value));
+
+/* Returns the number of elements equal to the one pointed to by 'value'.
+ */
+__attr_pure SIZE_TYPE(array_count_value)(RDONLY_ARRAY_TYPE(self),
+                                         RDONLY_PTR_TYPE(value));
+
+/* Copies the smallest and the largest elements into 'min' and 'max' (either
+ * may be NULL), the elements being integers of 1, 2, 4 or 8 bytes. Returns
+ * false if the array is empty, or if its elements have any other size.
+ */
+BOOL_TYPE(array_minmax)
+(RDONLY_ARRAY_TYPE(self), BOOL_TYPE(is_signed), PTR_TYPE(min), PTR_TYPE(max));
 
 /* Returns a pointer to the element at the specified position.
  */
@@ -235,12 +479,36 @@ BOOL_TYPE(array_append_from_capacity)(ARRAY_TYPE(self), SIZE_TYPE(n));
  */
 NONE_TYPE(array_swap_elems)(ARRAY_TYPE(self), SIZE_TYPE(a), SIZE_TYPE(b));
 
+/* Reverses the order of the elements.
+ */
+NONE_TYPE(array_reverse)(ARRAY_TYPE(self));
+
+/* Rotates the elements to the left so that the element at position 'k'
+ * becomes the first one.
+ */
+NONE_TYPE(array_rotate)(ARRAY_TYPE(self), SIZE_TYPE(k));
+
 /* Removes all elements from the array within start -> end
  * (which are ran through v->free), leaving the container with
  * a size of v->_nmemb - abs(start - end).
  */
 NONE_TYPE(array_wipe)(ARRAY_TYPE(self), SIZE_TYPE(start), SIZE_TYPE(end));
 
+/* Removes all the elements for which the callback returns true (which are
+ * ran through v->free), in a single pass: each run of remaining elements is
+ * moved once. Returns the number of elements removed.
+ */
+SIZE_TYPE(array_erase_if)
+(ARRAY_TYPE(self), bool (*callback)(RDONLY_PTR_TYPE(elem)));
+
+/* Removes the 'n' elements at 'indices', which must be sorted in increasing
+ * order without duplicates, in a single pass like 'erase_if'. It stops at
+ * the first index that breaks this order or is out of range, only the ones
+ * before it being removed.
+ */
+NONE_TYPE(array_remove_indices)
+(ARRAY_TYPE(self), const SIZE_TYPE(*indices), SIZE_TYPE(n));
+
 /* Removes all the elements from the array and the capacity remains unchanged.
  */
 NONE_TYPE(array_clear)(ARRAY_TYPE(self));
@@ -252,6 +520,9 @@ NONE_TYPE(array_evict)(ARRAY_TYPE(self), SIZE_TYPE(p));
 
 /* Adjusts the array capacity to be at least enough to
  * contain the current + 'n' elements.
+ * Once an array using the default allocator needs ARRAY_MMAP_THRESHOLD bytes
+ * or more, its buffer moves to an anonymous memory mapping, which then grows
+ * without being copied (where the system allows it).
  */
 BOOL_TYPE(array_adjust)(ARRAY_TYPE(self), SIZE_TYPE(n));
 
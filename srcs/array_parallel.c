@@ -0,0 +1,382 @@
+#include "array_parallel.h"
+#include "array.h"
+#include "internal.h"
+#include "pool.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define _chunk_start(job, chunk) ((chunk) * (job)->grain)
+#define _chunk_end(job, chunk)                                                 \
+  MIN(_chunk_start(job, chunk) + (job)->grain, _size((job)->self))
+
+/* FILTER */
+
+typedef struct {
+  RDONLY_ARRAY_TYPE(self);
+  ARRAY_TYPE(filtered);
+  bool (*callback)(RDONLY_PTR_TYPE(elem));
+  size_t grain;  /* A multiple of 64, so no two chunks share a bitmap word */
+  ut64_t *keep;  /* One bit per element, set if it passed the test */
+  size_t *count; /* The number of elements kept per chunk, turned into
+                  * their offset in 'filtered' */
+} filter_job_t;
+
+static void filter_mark(void *ctx, size_t chunk) {
+  filter_job_t *job = ctx;
+  size_t end = _chunk_end(job, chunk);
+  size_t n = 0;
+
+  for (size_t i = _chunk_start(job, chunk); i < end; i++) {
+    if (job->callback(_relative_data(job->self, i))) {
+      job->keep[i / 64] |= (ut64_t)1 << (i % 64);
+      n++;
+    }
+  }
+  job->count[chunk] = n;
+}
+
+static void filter_copy(void *ctx, size_t chunk) {
+  filter_job_t *job = ctx;
+  size_t elt_size = _typesize(job->self);
+  size_t end = _chunk_end(job, chunk);
+  size_t out = job->count[chunk];
+
+  for (size_t w = _chunk_start(job, chunk); w < end; w += 64) {
+    ut64_t bits = job->keep[w / 64];
+
+    /* copies each run of kept elements at once */
+    while (bits) {
+      size_t start = (size_t)__builtin_ctzll(bits);
+      ut64_t rest = ~(bits >> start);
+      size_t len = rest ? (size_t)__builtin_ctzll(rest) : 64 - start;
+
+      (void)builtin_memcpy(_relative_data(job->filtered, out),
+                           _relative_data(job->self, w + start),
+                           len * elt_size);
+      out += len;
+      bits &= len + start < 64 ? ~(ut64_t)0 << (start + len) : 0;
+    }
+  }
+}
+
+ARRAY_TYPE(array_filter_parallel)
+(RDONLY_ARRAY_TYPE(self), bool (*callback)(RDONLY_PTR_TYPE(elem)),
+ pool_t *pool, SIZE_TYPE(grain)) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(callback == NULL);
+  HR_COMPLAIN_IF(pool == NULL);
+
+  const array_allocator_t *allocator = _allocator(self);
+  SIZE_TYPE(size) = _size(self);
+  SIZE_TYPE(total) = 0;
+
+  grain = grain ? grain : ARRAY_PARALLEL_GRAIN;
+  grain = (grain + 63) & ~(size_t)63;
+
+  SIZE_TYPE(nchunks) = (size + grain - 1) / grain;
+  SIZE_TYPE(nwords) = (size + 63) / 64;
+  filter_job_t job = {self, NULL, callback, grain, NULL, NULL};
+
+  job.keep = _allocator_alloc(allocator, sizeof(*job.keep) * MAX(nwords, 1));
+  job.count = _allocator_alloc(allocator, sizeof(*job.count) * MAX(nchunks, 1));
+
+  if (unlikely(!job.keep || !job.count)) {
+    goto end;
+  }
+
+  (void)builtin_memset(job.keep, 0x00, sizeof(*job.keep) * nwords);
+  pool_run(pool, nchunks, &filter_mark, &job);
+
+  /* Exclusive prefix sum: each chunk learns where its elements go. */
+  for (size_t i = 0; i < nchunks; i++) {
+    SIZE_TYPE(n) = job.count[i];
+
+    job.count[i] = total;
+    total += n;
+  }
+
+  job.filtered = array_create_with_allocator(allocator, _typesize(self), total,
+                                             _freefunc(self));
+  if (unlikely(!job.filtered)) {
+    goto end;
+  }
+
+  pool_run(pool, nchunks, &filter_copy, &job);
+  _size(job.filtered) = total;
+
+end:
+  if (job.keep) {
+    _allocator_free(allocator, job.keep);
+  }
+  if (job.count) {
+    _allocator_free(allocator, job.count);
+  }
+
+  return (job.filtered);
+}
+
+/* FOREACH */
+
+typedef struct {
+  ARRAY_TYPE(self);
+  bool (*callback)(PTR_TYPE(elem));
+  size_t grain;
+  atomic_bool stop; /* Set once a callback returned false */
+} foreach_job_t;
+
+static void foreach_chunk(void *ctx, size_t chunk) {
+  foreach_job_t *job = ctx;
+  size_t end = _chunk_end(job, chunk);
+
+  if (atomic_load_explicit(&job->stop, memory_order_relaxed)) {
+    return;
+  }
+
+  for (size_t i = _chunk_start(job, chunk); i < end; i++) {
+    if (!job->callback(_relative_data(job->self, i))) {
+      atomic_store_explicit(&job->stop, true, memory_order_relaxed);
+      return;
+    }
+  }
+}
+
+BOOL_TYPE(array_foreach_parallel)
+(ARRAY_TYPE(self), bool (*callback)(PTR_TYPE(elem)), pool_t *pool,
+ SIZE_TYPE(grain)) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(callback == NULL);
+  HR_COMPLAIN_IF(pool == NULL);
+
+  foreach_job_t job = {self, callback, grain ? grain : ARRAY_PARALLEL_GRAIN,
+                       false};
+
+  pool_run(pool, (_size(self) + job.grain - 1) / job.grain, &foreach_chunk,
+           &job);
+
+  return (!atomic_load(&job.stop));
+}
+
+/* FIND */
+
+typedef struct {
+  ARRAY_TYPE(self);
+  bool (*callback)(RDONLY_PTR_TYPE(elem));
+  size_t grain;
+  atomic_size_t found; /* The lowest matching index so far */
+} find_job_t;
+
+static void find_chunk(void *ctx, size_t chunk) {
+  find_job_t *job = ctx;
+  size_t end = _chunk_end(job, chunk);
+
+  for (size_t i = _chunk_start(job, chunk); i < end; i++) {
+    /* Gives up once a match was found before this point. */
+    if (!(i % 64) &&
+        atomic_load_explicit(&job->found, memory_order_relaxed) < i) {
+      return;
+    }
+
+    if (job->callback(_relative_data(job->self, i))) {
+      SIZE_TYPE(found) = atomic_load(&job->found);
+
+      while (i < found &&
+             !atomic_compare_exchange_weak(&job->found, &found, i))
+        ;
+      return;
+    }
+  }
+}
+
+SSIZE_TYPE(array_find_index_parallel)
+(ARRAY_TYPE(self), bool (*callback)(RDONLY_PTR_TYPE(elem)), pool_t *pool,
+ SIZE_TYPE(grain)) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(callback == NULL);
+  HR_COMPLAIN_IF(pool == NULL);
+
+  find_job_t job = {self, callback, grain ? grain : ARRAY_PARALLEL_GRAIN,
+                    SIZE_MAX};
+
+  pool_run(pool, (_size(self) + job.grain - 1) / job.grain, &find_chunk, &job);
+
+  SIZE_TYPE(found) = atomic_load(&job.found);
+
+  return (found == SIZE_MAX ? -1 : (st64_t)found);
+}
+
+PTR_TYPE(array_find_parallel)
+(ARRAY_TYPE(self), bool (*callback)(RDONLY_PTR_TYPE(elem)), pool_t *pool,
+ SIZE_TYPE(grain)) {
+  SSIZE_TYPE(i) = array_find_index_parallel(self, callback, pool, grain);
+
+  return (i == -1 ? NULL : _relative_data(self, (size_t)i));
+}
+
+/* SORT */
+
+/* One piece of the merge of the sorted runs [lo, mid) and [mid, hi):
+ * the elements that land in [lo + from, lo + to) once merged.
+ */
+typedef struct {
+  size_t lo;
+  size_t mid;
+  size_t hi;
+  size_t from;
+  size_t to;
+} merge_piece_t;
+
+typedef struct {
+  ARRAY_TYPE(self);
+  array_cmp_t cmp;
+  char *src; /* The runs being merged */
+  char *dst; /* Where the merged runs go */
+  size_t *bounds;        /* The bounds of the runs */
+  merge_piece_t *pieces; /* The pieces of the current round */
+} sort_job_t;
+
+static void sort_run(void *ctx, size_t run) {
+  sort_job_t *job = ctx;
+  array_t view = *job->self;
+
+  /* The run is sorted as an array of its own. Its part of 'dst' is free
+   * until the merges start, and is used as its scratch buffer: the workers
+   * never allocate, the array's allocator may not be thread-safe. */
+  _data((&view)) = _relative_data(job->self, job->bounds[run]);
+  _size((&view)) = job->bounds[run + 1] - job->bounds[run];
+
+  array_sort_stable_with_scratch(
+      &view, job->cmp, job->dst + job->bounds[run] * _typesize(job->self));
+}
+
+/* Returns how many of the first 'd' elements of the stable merge of 'a'
+ * (of 'na' elements) and 'b' (of 'nb' elements) come from 'a'.
+ */
+static size_t merge_split(const char *a, size_t na, const char *b, size_t nb,
+                          size_t d, size_t size, array_cmp_t cmp) {
+  size_t lo = d > nb ? d - nb : 0;
+  size_t hi = MIN(d, na);
+
+  while (lo < hi) {
+    size_t i = lo + (hi - lo) / 2;
+
+    /* a[i] goes first unless b[d - i - 1] is strictly smaller */
+    if (cmp(b + (d - i - 1) * size, a + i * size) >= 0) {
+      lo = i + 1;
+    } else {
+      hi = i;
+    }
+  }
+
+  return (lo);
+}
+
+static void sort_merge_piece(void *ctx, size_t piece) {
+  sort_job_t *job = ctx;
+  merge_piece_t *p = &job->pieces[piece];
+  size_t size = _typesize(job->self);
+  const char *a = job->src + p->lo * size;
+  const char *b = job->src + p->mid * size;
+  size_t na = p->mid - p->lo;
+  size_t nb = p->hi - p->mid;
+  size_t i = merge_split(a, na, b, nb, p->from, size, job->cmp);
+  size_t j = p->from - i;
+  size_t i_end = merge_split(a, na, b, nb, p->to, size, job->cmp);
+  size_t j_end = p->to - i_end;
+  char *out = job->dst + (p->lo + p->from) * size;
+
+  while (i < i_end && j < j_end) {
+    if (job->cmp(b + j * size, a + i * size) < 0) {
+      (void)builtin_memcpy(out, b + j++ * size, size);
+    } else {
+      (void)builtin_memcpy(out, a + i++ * size, size);
+    }
+    out += size;
+  }
+
+  (void)builtin_memcpy(out, a + i * size, (i_end - i) * size);
+  out += (i_end - i) * size;
+  (void)builtin_memcpy(out, b + j * size, (j_end - j) * size);
+}
+
+BOOL_TYPE(array_sort_parallel)
+(ARRAY_TYPE(self), array_cmp_t cmp, pool_t *pool) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(cmp == NULL);
+  HR_COMPLAIN_IF(pool == NULL);
+
+  const array_allocator_t *allocator = _allocator(self);
+  SIZE_TYPE(n) = _size(self);
+  SIZE_TYPE(size) = _typesize(self);
+  SIZE_TYPE(nruns) = MIN(pool_size(pool) * 2, n / ARRAY_PARALLEL_GRAIN);
+
+  if (nruns < 2) {
+    return (array_sort_stable(self, cmp));
+  }
+
+  /* Each merge is cut in pieces of at least a grain, a few per thread. */
+  SIZE_TYPE(piece) = MAX(n / (pool_size(pool) * 4), ARRAY_PARALLEL_GRAIN);
+  SIZE_TYPE(max_pieces) = n / piece + nruns;
+  BOOL_TYPE(ret) = false;
+  sort_job_t job = {self, cmp, _data(self), NULL, NULL, NULL};
+
+  job.dst = _allocator_alloc(allocator, n * size);
+  job.bounds = _allocator_alloc(allocator, sizeof(*job.bounds) * (nruns + 1));
+  job.pieces = _allocator_alloc(allocator, sizeof(*job.pieces) * max_pieces);
+
+  if (unlikely(!job.dst || !job.bounds || !job.pieces)) {
+    goto end;
+  }
+
+  for (SIZE_TYPE(r) = 0; r <= nruns; r++) {
+    job.bounds[r] = n / nruns * r + MIN(r, n % nruns);
+  }
+
+  pool_run(pool, nruns, &sort_run, &job);
+
+  while (nruns > 1) {
+    SIZE_TYPE(npieces) = 0;
+
+    /* pairs up the runs, an odd one out is merged with nothing */
+    for (SIZE_TYPE(r) = 0; r < nruns; r += 2) {
+      SIZE_TYPE(lo) = job.bounds[r];
+      SIZE_TYPE(mid) = job.bounds[r + 1];
+      SIZE_TYPE(hi) = r + 2 <= nruns ? job.bounds[r + 2] : mid;
+
+      for (SIZE_TYPE(from) = 0; from < hi - lo; from += piece) {
+        job.pieces[npieces++] =
+            (merge_piece_t){lo, mid, hi, from, MIN(from + piece, hi - lo)};
+      }
+      job.bounds[r / 2] = lo;
+    }
+    job.bounds[(nruns + 1) / 2] = n;
+    nruns = (nruns + 1) / 2;
+
+    pool_run(pool, npieces, &sort_merge_piece, &job);
+
+    char *tmp = job.src;
+
+    job.src = job.dst;
+    job.dst = tmp;
+  }
+
+  if (job.src != _data(self)) {
+    (void)builtin_memcpy(_data(self), job.src, n * size);
+    job.dst = job.src;
+  }
+  ret = true;
+
+end:
+  if (job.dst) {
+    _allocator_free(allocator, job.dst);
+  }
+  if (job.bounds) {
+    _allocator_free(allocator, job.bounds);
+  }
+  if (job.pieces) {
+    _allocator_free(allocator, job.pieces);
+  }
+
+  return (ret);
+}
@@ -0,0 +1,52 @@
+#ifndef __ARRAY_PARALLEL_H__
+#define __ARRAY_PARALLEL_H__
+
+#include "array.h"
+#include "array_sort.h"
+#include "internal.h"
+#include "pool.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Parallel versions of the array traversals. The array is cut into chunks of
+ * 'grain' elements (ARRAY_PARALLEL_GRAIN if 0) which the threads of 'pool'
+ * take one after the other, so the callbacks must be safe to call from
+ * several threads at once. The array must not be modified meanwhile.
+ */
+
+/* Same as 'array_filter', the elements keep their order.
+ */
+ARRAY_TYPE(array_filter_parallel)
+(RDONLY_ARRAY_TYPE(self), bool (*callback)(RDONLY_PTR_TYPE(elem)),
+ pool_t *pool, SIZE_TYPE(grain));
+
+/* Same as 'array_foreach'. When a callback returns false, the chunks that
+ * have not been started are skipped, but the elements of the other chunks
+ * may or may not have been visited.
+ */
+BOOL_TYPE(array_foreach_parallel)
+(ARRAY_TYPE(self), bool (*callback)(PTR_TYPE(elem)), pool_t *pool,
+ SIZE_TYPE(grain));
+
+/* Same as 'array_find': the first matching element is returned, whichever
+ * thread found it. The chunks past a match are not searched.
+ */
+PTR_TYPE(array_find_parallel)
+(ARRAY_TYPE(self), bool (*callback)(RDONLY_PTR_TYPE(elem)), pool_t *pool,
+ SIZE_TYPE(grain));
+
+SSIZE_TYPE(array_find_index_parallel)
+(ARRAY_TYPE(self), bool (*callback)(RDONLY_PTR_TYPE(elem)), pool_t *pool,
+ SIZE_TYPE(grain));
+
+/* Same as 'array_sort_stable', the result is the same whatever the number of
+ * threads. Chunks of the array are sorted on their own, then merged two by
+ * two until one is left, every merge being split between the threads. A
+ * scratch buffer the size of the array is taken from the array's allocator,
+ * false is returned if it cannot be allocated. Only the calling thread
+ * allocates, so the allocator does not need to be thread-safe.
+ */
+BOOL_TYPE(array_sort_parallel)
+(ARRAY_TYPE(self), array_cmp_t cmp, pool_t *pool);
+
+#endif /* __ARRAY_PARALLEL_H__ */
@@ -0,0 +1,381 @@
+#include "array_sort.h"
+#include "array.h"
+#include "internal.h"
+#include "swap.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define _at(base, i, size) ((char *)(base) + (i) * (size))
+
+/* Copies one element, the common sizes being copied without a call. */
+static inline NONE_TYPE(elt_copy)(PTR_TYPE(dst), RDONLY_PTR_TYPE(src),
+                                  SIZE_TYPE(size)) {
+  switch (size) {
+  case 4:
+    (void)builtin_memcpy(dst, src, 4);
+    break;
+  case 8:
+    (void)builtin_memcpy(dst, src, 8);
+    break;
+  case 16:
+    (void)builtin_memcpy(dst, src, 16);
+    break;
+  default:
+    (void)builtin_memcpy(dst, src, size);
+  }
+}
+
+/* INTROSORT */
+
+static NONE_TYPE(insertion_sort)
+(PTR_TYPE(base), SIZE_TYPE(n), SIZE_TYPE(size), array_cmp_t cmp,
+ swap_kernel_t swap) {
+  for (SIZE_TYPE(i) = 1; i < n; i++) {
+    for (SIZE_TYPE(j) = i;
+         j && cmp(_at(base, j - 1, size), _at(base, j, size)) > 0; j--) {
+      swap(_at(base, j - 1, size), _at(base, j, size), size);
+    }
+  }
+}
+
+static NONE_TYPE(sift_down)
+(PTR_TYPE(base), SIZE_TYPE(root), SIZE_TYPE(n), SIZE_TYPE(size),
+ array_cmp_t cmp, swap_kernel_t swap) {
+  SIZE_TYPE(child);
+
+  while ((child = root * 2 + 1) < n) {
+    if (child + 1 < n &&
+        cmp(_at(base, child, size), _at(base, child + 1, size)) < 0) {
+      child++;
+    }
+    if (cmp(_at(base, root, size), _at(base, child, size)) >= 0) {
+      return;
+    }
+    swap(_at(base, root, size), _at(base, child, size), size);
+    root = child;
+  }
+}
+
+static NONE_TYPE(heap_sort)
+(PTR_TYPE(base), SIZE_TYPE(n), SIZE_TYPE(size), array_cmp_t cmp,
+ swap_kernel_t swap) {
+  for (SIZE_TYPE(i) = n / 2; i--;) {
+    sift_down(base, i, n, size, cmp, swap);
+  }
+  while (n-- > 1) {
+    swap(base, _at(base, n, size), size);
+    sift_down(base, 0, n, size, cmp, swap);
+  }
+}
+
+static NONE_TYPE(intro_sort)
+(PTR_TYPE(base), SIZE_TYPE(n), SIZE_TYPE(size), array_cmp_t cmp,
+ swap_kernel_t swap, SIZE_TYPE(depth)) {
+  while (n > ARRAY_SORT_INSERTION) {
+    if (depth-- == 0) {
+      heap_sort(base, n, size, cmp, swap);
+      return;
+    }
+
+    char *mid = _at(base, n / 2, size);
+    char *last = _at(base, n - 1, size);
+
+    /* median of three, moved to the front as the pivot */
+    if (cmp(mid, base) < 0) {
+      swap(mid, base, size);
+    }
+    if (cmp(last, mid) < 0) {
+      swap(last, mid, size);
+      if (cmp(mid, base) < 0) {
+        swap(mid, base, size);
+      }
+    }
+    swap(base, mid, size);
+
+    /* Hoare partition: both scans stop on elements equal to the pivot, so
+     * runs of duplicates are split evenly. */
+    SIZE_TYPE(i) = 0;
+    SIZE_TYPE(j) = n;
+
+    for (;;) {
+      do {
+        i++;
+      } while (i < n && cmp(_at(base, i, size), base) < 0);
+      do {
+        j--;
+      } while (cmp(_at(base, j, size), base) > 0);
+
+      if (i >= j) {
+        break;
+      }
+      swap(_at(base, i, size), _at(base, j, size), size);
+    }
+    swap(base, _at(base, j, size), size);
+
+    /* recurses on the smaller side, loops on the larger one */
+    if (j < n - j - 1) {
+      intro_sort(base, j, size, cmp, swap, depth);
+      base = _at(base, j + 1, size);
+      n -= j + 1;
+    } else {
+      intro_sort(_at(base, j + 1, size), n - j - 1, size, cmp, swap,
+                 depth);
+      n = j;
+    }
+  }
+
+  insertion_sort(base, n, size, cmp, swap);
+}
+
+NONE_TYPE(array_sort)(ARRAY_TYPE(self), array_cmp_t cmp) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(cmp == NULL);
+
+  SIZE_TYPE(depth) = 0;
+
+  for (SIZE_TYPE(n) = _size(self); n; n >>= 1) {
+    depth += 2;
+  }
+
+  intro_sort(_data(self), _size(self), _typesize(self), cmp,
+             swap_kernel(_typesize(self)), depth);
+}
+
+/* MERGE SORT */
+
+static NONE_TYPE(merge_sort)
+(PTR_TYPE(base), SIZE_TYPE(n), SIZE_TYPE(size), array_cmp_t cmp,
+ swap_kernel_t swap, PTR_TYPE(scratch)) {
+  if (n <= ARRAY_SORT_INSERTION) {
+    insertion_sort(base, n, size, cmp, swap);
+    return;
+  }
+
+  SIZE_TYPE(half) = n / 2;
+  char *right = _at(base, half, size);
+
+  merge_sort(base, half, size, cmp, swap, scratch);
+  merge_sort(right, n - half, size, cmp, swap, scratch);
+
+  /* already in order */
+  if (cmp(_at(base, half - 1, size), right) <= 0) {
+    return;
+  }
+
+  /* The left half moves to the scratch buffer, then both halves are merged
+   * back from the front, which never overtakes the right half. */
+  (void)builtin_memcpy(scratch, base, half * size);
+
+  char *l = scratch;
+  char *l_end = _at(scratch, half, size);
+  char *r = right;
+  char *r_end = _at(base, n, size);
+  char *out = base;
+
+  while (l < l_end && r < r_end) {
+    if (cmp(r, l) < 0) {
+      elt_copy(out, r, size);
+      r += size;
+    } else {
+      elt_copy(out, l, size);
+      l += size;
+    }
+    out += size;
+  }
+
+  /* whatever is left of the right half is already in place */
+  (void)builtin_memcpy(out, l, (size_t)(l_end - l));
+}
+
+BOOL_TYPE(array_sort_stable)(ARRAY_TYPE(self), array_cmp_t cmp) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(cmp == NULL);
+
+  if (_size(self) <= ARRAY_SORT_INSERTION) {
+    insertion_sort(_data(self), _size(self), _typesize(self), cmp,
+                   swap_kernel(_typesize(self)));
+    return (true);
+  }
+
+  PTR_TYPE(scratch) = _allocator_alloc(
+      _allocator(self), (_size(self) / 2 + 1) * _typesize(self));
+
+  if (unlikely(!scratch)) {
+    return (false);
+  }
+
+  array_sort_stable_with_scratch(self, cmp, scratch);
+  _allocator_free(_allocator(self), scratch);
+
+  return (true);
+}
+
+NONE_TYPE(array_sort_stable_with_scratch)
+(ARRAY_TYPE(self), array_cmp_t cmp, PTR_TYPE(scratch)) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(cmp == NULL);
+  HR_COMPLAIN_IF(scratch == NULL && _size(self) > ARRAY_SORT_INSERTION);
+
+  merge_sort(_data(self), _size(self), _typesize(self), cmp,
+             swap_kernel(_typesize(self)), scratch);
+}
+
+/* RADIX SORT */
+
+/* Loads the key of 'elem' as an unsigned integer ordered like the key. */
+static inline ut64_t radix_key(RDONLY_PTR_TYPE(elem), array_key_t key) {
+  ut32_t k32;
+  ut64_t k64;
+
+  switch (key) {
+  case ARRAY_KEY_U32:
+  case ARRAY_KEY_I32:
+  case ARRAY_KEY_F32:
+    (void)builtin_memcpy(&k32, elem, sizeof(k32));
+    if (key == ARRAY_KEY_I32) {
+      k32 ^= (ut32_t)1 << 31;
+    } else if (key == ARRAY_KEY_F32) {
+      /* negative values are stored as a magnitude, their order flips */
+      k32 = (k32 >> 31) ? ~k32 : k32 | (ut32_t)1 << 31;
+    }
+    return (k32);
+  default:
+    (void)builtin_memcpy(&k64, elem, sizeof(k64));
+    if (key == ARRAY_KEY_I64) {
+      k64 ^= (ut64_t)1 << 63;
+    } else if (key == ARRAY_KEY_F64) {
+      k64 = (k64 >> 63) ? ~k64 : k64 | (ut64_t)1 << 63;
+    }
+    return (k64);
+  }
+}
+
+BOOL_TYPE(array_radix_sort)
+(ARRAY_TYPE(self), SIZE_TYPE(key_offset), array_key_t key) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  SIZE_TYPE(width) = key <= ARRAY_KEY_F32 ? 4 : 8;
+
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_ADD(key_offset, width) == false);
+  HR_COMPLAIN_IF(key_offset + width > _typesize(self));
+
+  SIZE_TYPE(n) = _size(self);
+  SIZE_TYPE(size) = _typesize(self);
+
+  if (n < 2) {
+    return (true);
+  }
+
+  char *src = _data(self);
+  char *dst = _allocator_alloc(_allocator(self), n * size);
+  char *scratch = dst;
+  size_t counts[8][256] = {{0}};
+
+  if (unlikely(!dst)) {
+    return (false);
+  }
+
+  /* All the histograms are built in a single pass. */
+  for (SIZE_TYPE(i) = 0; i < n; i++) {
+    ut64_t k = radix_key(_at(src, i, size) + key_offset, key);
+
+    for (SIZE_TYPE(d) = 0; d < width; d++) {
+      counts[d][(k >> (d * 8)) & 0xff]++;
+    }
+  }
+
+  ut64_t first = radix_key(src + key_offset, key);
+
+  for (SIZE_TYPE(d) = 0; d < width; d++) {
+    size_t *count = counts[d];
+
+    /* every key has the same byte here, the pass would not move anything */
+    if (count[(first >> (d * 8)) & 0xff] == n) {
+      continue;
+    }
+
+    for (SIZE_TYPE(b) = 0, sum = 0; b < 256; b++) {
+      SIZE_TYPE(c) = count[b];
+
+      count[b] = sum;
+      sum += c;
+    }
+
+    for (SIZE_TYPE(i) = 0; i < n; i++) {
+      char *elem = _at(src, i, size);
+      ut64_t k = radix_key(elem + key_offset, key);
+
+      elt_copy(_at(dst, count[(k >> (d * 8)) & 0xff]++, size), elem, size);
+    }
+
+    char *tmp = src;
+
+    src = dst;
+    dst = tmp;
+  }
+
+  if (src != _data(self)) {
+    (void)builtin_memcpy(_data(self), src, n * size);
+  }
+  _allocator_free(_allocator(self), scratch);
+
+  return (true);
+}
+
+/* SEARCH */
+
+__attr_pure SIZE_TYPE(array_lower_bound)
+(RDONLY_ARRAY_TYPE(self), RDONLY_PTR_TYPE(key), array_cmp_t cmp) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(cmp == NULL);
+
+  SIZE_TYPE(lo) = 0;
+  SIZE_TYPE(n) = _size(self);
+
+  while (n) {
+    SIZE_TYPE(half) = n / 2;
+
+    if (cmp(_relative_data(self, lo + half), key) < 0) {
+      lo += half + 1;
+      n -= half + 1;
+    } else {
+      n = half;
+    }
+  }
+
+  return (lo);
+}
+
+__attr_pure SIZE_TYPE(array_upper_bound)
+(RDONLY_ARRAY_TYPE(self), RDONLY_PTR_TYPE(key), array_cmp_t cmp) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(cmp == NULL);
+
+  SIZE_TYPE(lo) = 0;
+  SIZE_TYPE(n) = _size(self);
+
+  while (n) {
+    SIZE_TYPE(half) = n / 2;
+
+    if (cmp(key, _relative_data(self, lo + half)) >= 0) {
+      lo += half + 1;
+      n -= half + 1;
+    } else {
+      n = half;
+    }
+  }
+
+  return (lo);
+}
+
+__attr_pure PTR_TYPE(array_bsearch)
+(RDONLY_ARRAY_TYPE(self), RDONLY_PTR_TYPE(key), array_cmp_t cmp) {
+  SIZE_TYPE(i) = array_lower_bound(self, key, cmp);
+
+  if (i < _size(self) && cmp(_relative_data(self, i), key) == 0) {
+    return (_relative_data(self, i));
+  }
+
+  return (NULL);
+}
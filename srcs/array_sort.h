@@ -0,0 +1,75 @@
+#ifndef __ARRAY_SORT_H__
+#define __ARRAY_SORT_H__
+
+#include "array.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/* The comparison functions follow the 'qsort' convention: negative if 'a'
+ * goes before 'b', 0 if they are equivalent, positive otherwise.
+ */
+typedef int (*array_cmp_t)(const void *a, const void *b);
+
+/* The type of a numeric key embedded in the elements.
+ */
+typedef enum {
+  ARRAY_KEY_U32,
+  ARRAY_KEY_I32,
+  ARRAY_KEY_F32,
+  ARRAY_KEY_U64,
+  ARRAY_KEY_I64,
+  ARRAY_KEY_F64,
+} array_key_t;
+
+/* Sorts the array in place (introsort: quicksort with a median of three
+ * pivot, switching to heapsort when the recursion gets too deep, and to
+ * insertion sort on small ranges). Equivalent elements may be reordered.
+ */
+NONE_TYPE(array_sort)(ARRAY_TYPE(self), array_cmp_t cmp);
+
+/* Sorts the array in place, equivalent elements keeping their order (merge
+ * sort). A scratch buffer of half the array is taken from the array's
+ * allocator, false is returned if it cannot be allocated.
+ */
+BOOL_TYPE(array_sort_stable)(ARRAY_TYPE(self), array_cmp_t cmp);
+
+/* Same as 'array_sort_stable', using the caller's 'scratch' buffer, which
+ * must hold at least half of the elements plus one. Nothing is allocated.
+ */
+NONE_TYPE(array_sort_stable_with_scratch)
+(ARRAY_TYPE(self), array_cmp_t cmp, PTR_TYPE(scratch));
+
+/* Sorts the array in place by the key of type 'key' found 'key_offset'
+ * bytes into every element, without calling any comparison function (LSD
+ * radix sort, one pass per key byte, skipping the bytes every key shares).
+ * The sort is stable. Floating point keys are ordered by their value, with
+ * the negative NaNs first and the positive ones last. A scratch buffer the
+ * size of the array is taken from the array's allocator, false is returned
+ * if it cannot be allocated.
+ */
+BOOL_TYPE(array_radix_sort)
+(ARRAY_TYPE(self), SIZE_TYPE(key_offset), array_key_t key);
+
+/* The array must be sorted according to 'cmp', and 'key' points to an
+ * element (or anything 'cmp' can compare to one).
+ */
+
+/* Returns an element equivalent to 'key', or NULL if there is none.
+ */
+__attr_pure PTR_TYPE(array_bsearch)
+(RDONLY_ARRAY_TYPE(self), RDONLY_PTR_TYPE(key), array_cmp_t cmp);
+
+/* Returns the index of the first element that does not go before 'key'
+ * (the size of the array if there is none).
+ */
+__attr_pure SIZE_TYPE(array_lower_bound)
+(RDONLY_ARRAY_TYPE(self), RDONLY_PTR_TYPE(key), array_cmp_t cmp);
+
+/* Returns the index of the first element that goes after 'key' (the size of
+ * the array if there is none).
+ */
+__attr_pure SIZE_TYPE(array_upper_bound)
+(RDONLY_ARRAY_TYPE(self), RDONLY_PTR_TYPE(key), array_cmp_t cmp);
+
+#endif /* __ARRAY_SORT_H__ */
@@ -0,0 +1,84 @@
+#ifndef __ARRAY_TYPED_H__
+#define __ARRAY_TYPED_H__
+
+#include "array.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Declares a typed front end for arrays of 'T', named 'array_<name>_*'.
+ * The arrays are regular 'array_t' (same layout, allocator and growth),
+ * so they can still be passed to the generic API, but the element size is
+ * known at compile time: push, pop and indexing compile down to plain
+ * loads and stores, 'array_adjust' is only called when the buffer is full.
+ * Typed arrays have no element destructor.
+ *
+ *   Example:
+ *     ARRAY_DECLARE(int32, int32_t)
+ *
+ *     array_t *v = array_int32_create(0);
+ *     array_int32_push(v, 42);
+ *     int32_t x = array_int32_at(v, 0);
+ */
+#define ARRAY_DECLARE(name, T)                                                 \
+  static inline array_t *array_##name##_create(size_t n) {                     \
+    return (array_create(sizeof(T), n, NULL));                                 \
+  }                                                                            \
+                                                                               \
+  static inline array_t *array_##name##_create_with_allocator(                 \
+      const array_allocator_t *allocator, size_t n) {                          \
+    return (array_create_with_allocator(allocator, sizeof(T), n, NULL));       \
+  }                                                                            \
+                                                                               \
+  static inline T *array_##name##_data(const array_t *self) {                  \
+    return ((T *)_data(self));                                                 \
+  }                                                                            \
+                                                                               \
+  static inline size_t array_##name##_size(const array_t *self) {              \
+    return (_size(self));                                                      \
+  }                                                                            \
+                                                                               \
+  /* Only decides when the elements obviously fit, without any overflow:  \
+   * growth, settled arrays and invalid sizes are left to 'array_adjust'. */  \
+  static inline bool array_##name##_reserve(array_t *self, size_t n) {         \
+    HR_COMPLAIN_IF(_typesize(self) != sizeof(T));                              \
+    if (likely(n < _capacity(self) / sizeof(T) - _size(self))) {              \
+      return (true);                                                           \
+    }                                                                          \
+    return (array_adjust(self, n));                                            \
+  }                                                                            \
+                                                                               \
+  static inline bool array_##name##_push(array_t *self, T value) {             \
+    if (unlikely(!array_##name##_reserve(self, 1))) {                          \
+      return (false);                                                          \
+    }                                                                          \
+    ((T *)_data(self))[_size(self)++] = value;                                 \
+    return (true);                                                             \
+  }                                                                            \
+                                                                               \
+  static inline T array_##name##_pop(array_t *self) {                          \
+    HR_COMPLAIN_IF(_size(self) == 0);                                          \
+    return (((T *)_data(self))[--_size(self)]);                                \
+  }                                                                            \
+                                                                               \
+  static inline T array_##name##_at(const array_t *self, size_t p) {           \
+    HR_COMPLAIN_IF(p >= _size(self));                                          \
+    return (((const T *)_data(self))[p]);                                      \
+  }                                                                            \
+                                                                               \
+  static inline void array_##name##_set(array_t *self, size_t p, T value) {    \
+    HR_COMPLAIN_IF(p >= _size(self));                                          \
+    ((T *)_data(self))[p] = value;                                             \
+  }                                                                            \
+                                                                               \
+  static inline bool array_##name##_append(array_t *self, const T *src,        \
+                                           size_t n) {                         \
+    if (unlikely(!array_##name##_reserve(self, n))) {                          \
+      return (false);                                                          \
+    }                                                                          \
+    (void)builtin_memcpy((T *)_data(self) + _size(self), src, n * sizeof(T));  \
+    _size(self) += n;                                                          \
+    return (true);                                                             \
+  }
+
+#endif /* __ARRAY_TYPED_H__ */
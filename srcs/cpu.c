@@ -0,0 +1,20 @@
+#include "cpu.h"
+
+unsigned int cpu_features(void) {
+  unsigned int features = 0;
+
+#ifdef CPU_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("sse2")) {
+    features |= CPU_SSE2;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    features |= CPU_AVX2;
+  }
+  if (__builtin_cpu_supports("popcnt")) {
+    features |= CPU_POPCNT;
+  }
+#endif
+  return (features);
+}
@@ -0,0 +1,29 @@
+#ifndef __CPU_H__
+#define __CPU_H__
+
+/* Instruction set extensions used by the wide kernels.
+ *
+ * The modules with wide kernels (search, numeric, swap) keep a scalar
+ * version of each, which is the reference and handles their tails, and
+ * build the wide ones with a 'target' attribute so the library runs on any
+ * CPU of the architecture. Each module points its kernel tables at the
+ * scalar versions, then a constructor swaps in the wide ones that
+ * 'cpu_features' reports. Constructors run once, before 'main' and before
+ * any thread exists, so the tables are never written while being read.
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_X86
+#include <immintrin.h>
+#endif
+
+#define CPU_SSE2 (1U << 0)
+#define CPU_AVX2 (1U << 1)
+#define CPU_POPCNT (1U << 2)
+
+/* Returns the CPU_* flags of the extensions the CPU supports, or 0 on other
+ * architectures.
+ */
+unsigned int cpu_features(void);
+
+#endif /* __CPU_H__ */
@@ -0,0 +1,276 @@
+#include "deque.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define _slot(deque, i)                                                        \
+  ((char *)(deque)->_ptr +                                                     \
+   (deque)->_elt_size * (((deque)->_head + (i)) & ((deque)->_cap - 1)))
+
+static inline size_t round_pow2(size_t n) {
+  size_t p = 1;
+
+  while (p < n) {
+    p <<= 1;
+  }
+  return (p);
+}
+
+deque_t *deque_create(size_t elt_size, size_t n, void (*_free)(void *)) {
+  return (deque_create_with_allocator(&__array_allocator__, elt_size, n, _free));
+}
+
+deque_t *deque_create_with_allocator(const array_allocator_t *allocator,
+                                     size_t elt_size, size_t n,
+                                     void (*_free)(void *)) {
+  HR_COMPLAIN_IF(allocator == NULL);
+  HR_COMPLAIN_IF(elt_size == 0);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(elt_size, n) == false);
+
+  size_t cap = round_pow2(n ? n : ARRAY_INITIAL_SIZE);
+  deque_t *self = _allocator_alloc(allocator, sizeof(*self));
+
+  if (unlikely(!self)) {
+    return (NULL);
+  }
+
+  (void)builtin_memset(self, 0x00, sizeof(*self));
+  self->_ptr = _allocator_alloc(allocator, cap * elt_size);
+
+  if (unlikely(!self->_ptr)) {
+    _allocator_free(allocator, self);
+    return (NULL);
+  }
+
+  self->_cap = cap;
+  self->_elt_size = elt_size;
+  self->_free = _free;
+  self->_allocator = allocator;
+
+  return (self);
+}
+
+void deque_kill(deque_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  deque_clear(self);
+  _allocator_free(self->_allocator, self->_ptr);
+  _allocator_free(self->_allocator, self);
+}
+
+bool deque_adjust(deque_t *self, size_t n) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_ADD(self->_nmemb, n) == false);
+
+  n += self->_nmemb;
+
+  if (likely(n <= self->_cap)) {
+    return (true);
+  }
+
+  size_t cap = round_pow2(MAX(n, self->_cap * 2));
+
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(cap, self->_elt_size) == false);
+
+  void *ptr =
+      _allocator_realloc(self->_allocator, self->_ptr, cap * self->_elt_size);
+
+  if (unlikely(!ptr)) {
+    return (false);
+  }
+
+  /* The elements that wrapped around the end of the old buffer are moved
+   * right after it, where they now belong. */
+  if (self->_head + self->_nmemb > self->_cap) {
+    size_t wrapped = self->_head + self->_nmemb - self->_cap;
+
+    (void)builtin_memcpy((char *)ptr + self->_cap * self->_elt_size, ptr,
+                         wrapped * self->_elt_size);
+  }
+
+  self->_ptr = ptr;
+  self->_cap = cap;
+
+  return (true);
+}
+
+bool deque_push(deque_t *self, const void *e) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(e == NULL);
+
+  if (unlikely(!deque_adjust(self, 1))) {
+    return (false);
+  }
+
+  (void)builtin_memcpy(_slot(self, self->_nmemb), e, self->_elt_size);
+  self->_nmemb++;
+
+  return (true);
+}
+
+bool deque_pushf(deque_t *self, const void *e) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(e == NULL);
+
+  if (unlikely(!deque_adjust(self, 1))) {
+    return (false);
+  }
+
+  self->_head = (self->_head - 1) & (self->_cap - 1);
+  (void)builtin_memcpy(_slot(self, 0), e, self->_elt_size);
+  self->_nmemb++;
+
+  return (true);
+}
+
+void deque_pop(deque_t *self, void *into) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(self->_nmemb == 0);
+
+  self->_nmemb--;
+
+  void *ptr = _slot(self, self->_nmemb);
+
+  if (into) {
+    (void)builtin_memcpy(into, ptr, self->_elt_size);
+  }
+
+  if (self->_free) {
+    self->_free(ptr);
+  }
+}
+
+void deque_popf(deque_t *self, void *into) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(self->_nmemb == 0);
+
+  void *ptr = _slot(self, 0);
+
+  if (into) {
+    (void)builtin_memcpy(into, ptr, self->_elt_size);
+  }
+
+  if (self->_free) {
+    self->_free(ptr);
+  }
+
+  self->_head = (self->_head + 1) & (self->_cap - 1);
+  self->_nmemb--;
+}
+
+__attr_pure void *deque_access(const deque_t *self, size_t p) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(p >= self->_nmemb);
+
+  if (unlikely(p >= self->_nmemb)) {
+    return (NULL);
+  }
+
+  return (_slot(self, p));
+}
+
+__attr_pure void *deque_head(const deque_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  if (likely(self->_nmemb)) {
+    return (_slot(self, 0));
+  }
+
+  return (NULL);
+}
+
+__attr_pure void *deque_tail(const deque_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  if (likely(self->_nmemb)) {
+    return (_slot(self, self->_nmemb - 1));
+  }
+
+  return (NULL);
+}
+
+__attr_pure size_t deque_size(const deque_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (self->_nmemb);
+}
+
+void deque_clear(deque_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  if (self->_free) {
+    while (self->_nmemb--) {
+      self->_free(_slot(self, self->_nmemb));
+    }
+  }
+
+  self->_nmemb = 0;
+  self->_head = 0;
+}
+
+/* Copies the elements, in order, into 'dst'.
+ */
+static void deque_copy_out(const deque_t *self, void *dst) {
+  size_t first = MIN(self->_nmemb, self->_cap - self->_head);
+
+  (void)builtin_memcpy(dst, _slot(self, 0), first * self->_elt_size);
+  (void)builtin_memcpy((char *)dst + first * self->_elt_size, self->_ptr,
+                       (self->_nmemb - first) * self->_elt_size);
+}
+
+bool deque_linearize(deque_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  if (self->_head + self->_nmemb <= self->_cap) {
+    (void)builtin_memmove(self->_ptr, _slot(self, 0),
+                          self->_nmemb * self->_elt_size);
+    self->_head = 0;
+    return (true);
+  }
+
+  void *ptr = _allocator_alloc(self->_allocator, self->_cap * self->_elt_size);
+
+  if (unlikely(!ptr)) {
+    return (false);
+  }
+
+  deque_copy_out(self, ptr);
+  _allocator_free(self->_allocator, self->_ptr);
+  self->_ptr = ptr;
+  self->_head = 0;
+
+  return (true);
+}
+
+array_t *deque_to_array(const deque_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  array_t *array = array_create_with_allocator(
+      self->_allocator, self->_elt_size, MAX(self->_nmemb, 1), self->_free);
+
+  if (likely(array)) {
+    deque_copy_out(self, array->_ptr);
+    array->_nmemb = self->_nmemb;
+  }
+
+  return (array);
+}
+
+array_t *deque_into_array(deque_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  if (unlikely(!deque_linearize(self))) {
+    return (NULL);
+  }
+
+  array_t *array = array_seize_buffer_with_allocator(
+      self->_allocator, (void **)self->_ptr, self->_cap * self->_elt_size,
+      self->_elt_size, self->_nmemb, self->_free);
+
+  if (likely(array)) {
+    _allocator_free(self->_allocator, self);
+  }
+
+  return (array);
+}
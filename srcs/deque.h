@@ -0,0 +1,94 @@
+#ifndef __DEQUE_H__
+#define __DEQUE_H__
+
+#include "array.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/* A double-ended queue stored in a circular buffer: pushing and popping at
+ * either end never moves the other elements.
+ */
+typedef struct {
+  void *_ptr;       /* A pointer to the start of the buffer */
+  size_t _head;     /* The slot of the first element */
+  size_t _nmemb;    /* The number of elements in the buffer */
+  size_t _cap;      /* The number of slots in the buffer (a power of 2) */
+  size_t _elt_size; /* The size of one element (in bytes) */
+
+  void (*_free)(void *); /* the element destructor function */
+
+  const array_allocator_t *_allocator; /* Allocator of both the deque and its
+                                        * buffer */
+} deque_t;
+
+/* Creates a deque with room for at least 'n' elements.
+ */
+deque_t *deque_create(size_t elt_size, size_t n, void (*_free)(void *));
+
+deque_t *deque_create_with_allocator(const array_allocator_t *allocator,
+                                     size_t elt_size, size_t n,
+                                     void (*_free)(void *));
+
+/* Frees the deque, clearing the content beforhand.
+ */
+void deque_kill(deque_t *self);
+
+/* Adds a copy of the element pointed to by 'e' after the last element.
+ */
+bool deque_push(deque_t *self, const void *e);
+
+/* Adds a copy of the element pointed to by 'e' before the first element.
+ */
+bool deque_pushf(deque_t *self, const void *e);
+
+/* Removes the last element, copying it into 'into' first if not NULL.
+ */
+void deque_pop(deque_t *self, void *into);
+
+/* Removes the first element, copying it into 'into' first if not NULL.
+ */
+void deque_popf(deque_t *self, void *into);
+
+/* Returns a pointer to the element at position 'p' (from the first
+ * element), or NULL if out of bounds.
+ */
+__attr_pure void *deque_access(const deque_t *self, size_t p);
+
+/* Returns a pointer to the first element, or NULL if the deque is empty.
+ */
+__attr_pure void *deque_head(const deque_t *self);
+
+/* Returns a pointer to the last element, or NULL if the deque is empty.
+ */
+__attr_pure void *deque_tail(const deque_t *self);
+
+/* Returns the number of elements contained in the deque.
+ */
+__attr_pure size_t deque_size(const deque_t *self);
+
+/* Removes all the elements from the deque, the capacity remains unchanged.
+ */
+void deque_clear(deque_t *self);
+
+/* Adjusts the deque capacity to be at least enough to contain the
+ * current + 'n' elements.
+ */
+bool deque_adjust(deque_t *self, size_t n);
+
+/* Moves the elements so they are contiguous and start at the beginning of
+ * the buffer.
+ */
+bool deque_linearize(deque_t *self);
+
+/* Returns a new array holding a copy of the elements, in order.
+ */
+array_t *deque_to_array(const deque_t *self);
+
+/* Turns the deque into an array holding the same elements, which are only
+ * moved if they wrap around the end of the buffer. On success the deque is
+ * freed, on failure it is left untouched and NULL is returned.
+ */
+array_t *deque_into_array(deque_t *self);
+
+#endif /* __DEQUE_H__ */
@@ -5,9 +5,15 @@
 #include <stddef.h>
 
 dynstr_t *dynstr_create(size_t n) {
+  return (dynstr_create_with_allocator(&__array_allocator__, n));
+}
+
+dynstr_t *dynstr_create_with_allocator(const array_allocator_t *allocator,
+                                       size_t n) {
   HR_COMPLAIN_IF(LONG_MAX - 1 <= n);
 
-  array_t *dynstr = array_create(sizeof(char), n + 1, NULL);
+  array_t *dynstr =
+      array_create_with_allocator(allocator, sizeof(char), n + 1, NULL);
 
   if (likely(dynstr)) {
     *(char *)dynstr->_ptr = '\0';
@@ -17,11 +23,17 @@ dynstr_t *dynstr_create(size_t n) {
 }
 
 dynstr_t *dynstr_assign(const char *src, st64_t n) {
+  return (dynstr_assign_with_allocator(&__array_allocator__, src, n));
+}
+
+dynstr_t *dynstr_assign_with_allocator(const array_allocator_t *allocator,
+                                       const char *src, st64_t n) {
   HR_COMPLAIN_IF(src == NULL);
   HR_COMPLAIN_IF(LONG_MAX - 1 <= n);
 
   size_t init_size = (n == -1) ? strlen(src) : n;
-  array_t *dynstr = array_create(sizeof(char), init_size + 1, NULL);
+  array_t *dynstr =
+      array_create_with_allocator(allocator, sizeof(char), init_size + 1, NULL);
 
   if (likely(dynstr)) {
     (void)memmove(dynstr->_ptr, src, init_size);
@@ -28,6 +28,11 @@ typedef struct {
  */
 dynstr_t *dynstr_create(size_t n);
 
+/* Same as 'create', but the string is allocated through 'allocator'.
+ */
+dynstr_t *dynstr_create_with_allocator(const array_allocator_t *allocator,
+                                       size_t n);
+
 /* Marks the dynamic string as 'settled', which means that the pointer
  * '_ptr' will no longer change due to a reallocation. The buffer cannot be
  * reallocated.
@@ -39,6 +44,11 @@ void dynstr_done(SELF);
  */
 dynstr_t *dynstr_assign(const char *src, st64_t n);
 
+/* Same as 'assign', but the string is allocated through 'allocator'.
+ */
+dynstr_t *dynstr_assign_with_allocator(const array_allocator_t *allocator,
+                                       const char *src, st64_t n);
+
 /* Frees the dynamic string.
  */
 void dynstr_kill(SELF);
@@ -56,6 +66,8 @@ dynstr_t *dynstr_pull(SELF_RDONLY, st64_t sp, st64_t ep);
 
 /* Injects the string pointed to by 'src' into the dynamic string 'self', at
  * potitions 'p'.
+ * Everything after 'p' is moved, many edits in a long string should use a
+ * 'gapstr_t' instead.
  */
 bool dynstr_inject(SELF, size_t pos, const char *src, st64_t n);
 
@@ -0,0 +1,179 @@
+#include "gapstr.h"
+#include "array.h"
+#include "dynstr.h"
+#include "internal.h"
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define _gap_size(str) ((str)->_gap_end - (str)->_gap)
+#define _tail_size(str) ((str)->_cap - (str)->_gap_end)
+
+/* Moves the gap to 'pos': only the characters in between cross it. */
+static void gapstr_move_gap(gapstr_t *self, size_t pos) {
+  if (pos < self->_gap) {
+    size_t n = self->_gap - pos;
+
+    (void)builtin_memmove(self->_ptr + self->_gap_end - n, self->_ptr + pos,
+                          n);
+    self->_gap_end -= n;
+  } else if (pos > self->_gap) {
+    size_t n = pos - self->_gap;
+
+    (void)builtin_memmove(self->_ptr + self->_gap, self->_ptr + self->_gap_end,
+                          n);
+    self->_gap_end += n;
+  }
+  self->_gap = pos;
+}
+
+gapstr_t *gapstr_create(size_t n) {
+  return (gapstr_create_with_allocator(&__array_allocator__, n));
+}
+
+gapstr_t *gapstr_create_with_allocator(const array_allocator_t *allocator,
+                                       size_t n) {
+  HR_COMPLAIN_IF(allocator == NULL);
+  HR_COMPLAIN_IF(LONG_MAX - 1 <= n);
+
+  gapstr_t *self = _allocator_alloc(allocator, sizeof(*self));
+
+  if (unlikely(!self)) {
+    return (NULL);
+  }
+
+  /* The gap is never empty, there is always room for the terminator. */
+  size_t cap = MAX(n + 1, ARRAY_INITIAL_SIZE);
+
+  self->_ptr = _allocator_alloc(allocator, cap);
+  if (unlikely(!self->_ptr)) {
+    _allocator_free(allocator, self);
+    return (NULL);
+  }
+
+  self->_gap = 0;
+  self->_gap_end = cap;
+  self->_cap = cap;
+  self->_allocator = allocator;
+
+  return (self);
+}
+
+gapstr_t *gapstr_assign(const char *src, st64_t n) {
+  HR_COMPLAIN_IF(src == NULL);
+  HR_COMPLAIN_IF(LONG_MAX - 1 <= n);
+
+  size_t size = (n == -1) ? strlen(src) : (size_t)n;
+  gapstr_t *self = gapstr_create(size);
+
+  if (likely(self)) {
+    (void)builtin_memcpy(self->_ptr, src, size);
+    self->_gap = size;
+  }
+
+  return (self);
+}
+
+void gapstr_kill(gapstr_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  _allocator_free(self->_allocator, self->_ptr);
+  _allocator_free(self->_allocator, self);
+}
+
+bool gapstr_adjust(gapstr_t *self, size_t n) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_ADD(self->_cap, n) == false);
+
+  if (likely(n < _gap_size(self))) {
+    return (true);
+  }
+
+  size_t cap = MAX(self->_cap - _gap_size(self) + n + 1, self->_cap * 2);
+  size_t tail = _tail_size(self);
+  char *ptr = _allocator_realloc(self->_allocator, self->_ptr, cap);
+
+  if (unlikely(!ptr)) {
+    return (false);
+  }
+
+  /* The text after the gap goes back to the end of the buffer. */
+  (void)builtin_memmove(ptr + cap - tail, ptr + self->_gap_end, tail);
+  self->_ptr = ptr;
+  self->_gap_end = cap - tail;
+  self->_cap = cap;
+
+  return (true);
+}
+
+bool gapstr_inject(gapstr_t *self, size_t pos, const char *src, st64_t n) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(src == NULL);
+  HR_COMPLAIN_IF(LONG_MAX - 1 <= n);
+  HR_COMPLAIN_IF(pos > gapstr_size(self));
+
+  size_t size = (n == -1) ? strlen(src) : (size_t)n;
+
+  if (unlikely(!gapstr_adjust(self, size))) {
+    return (false);
+  }
+
+  gapstr_move_gap(self, pos);
+  (void)builtin_memcpy(self->_ptr + self->_gap, src, size);
+  self->_gap += size;
+
+  return (true);
+}
+
+bool gapstr_append(gapstr_t *self, const char *src, st64_t n) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (gapstr_inject(self, gapstr_size(self), src, n));
+}
+
+void gapstr_wipe(gapstr_t *self, size_t start, size_t end) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_SUB(end, start) == false);
+  HR_COMPLAIN_IF(end > gapstr_size(self));
+
+  /* The removed characters just join the gap. */
+  gapstr_move_gap(self, start);
+  self->_gap_end += end - start;
+}
+
+__attr_pure size_t gapstr_size(const gapstr_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (self->_cap - _gap_size(self));
+}
+
+__attr_pure char gapstr_at(const gapstr_t *self, size_t p) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(p >= gapstr_size(self));
+
+  return (p < self->_gap ? self->_ptr[p] : self->_ptr[p + _gap_size(self)]);
+}
+
+const char *gapstr_view(gapstr_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  gapstr_move_gap(self, gapstr_size(self));
+  self->_ptr[self->_gap] = '\0';
+
+  return (self->_ptr);
+}
+
+dynstr_t *gapstr_pull(const gapstr_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  dynstr_t *str =
+      dynstr_create_with_allocator(self->_allocator, gapstr_size(self));
+
+  if (likely(str)) {
+    (void)dynstr_append(str, self->_ptr, (st64_t)self->_gap);
+    (void)dynstr_append(str, self->_ptr + self->_gap_end,
+                        (st64_t)_tail_size(self));
+  }
+
+  return (str);
+}
@@ -0,0 +1,83 @@
+#ifndef __GAPSTR_H__
+#define __GAPSTR_H__
+
+#include "array.h"
+#include "dynstr.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/* A string stored in a gap buffer: the free space of the buffer sits where
+ * the last edit happened, so a run of edits around the same position only
+ * moves the characters between two consecutive edits, not the whole tail.
+ *
+ *   [ before the gap | gap ........ | after the gap ]
+ *   0                _gap      _gap_end            _cap
+ */
+typedef struct {
+  char *_ptr;      /* A pointer to the start of the buffer */
+  size_t _gap;     /* The position of the gap, which is the size of the text
+                    * before it */
+  size_t _gap_end; /* The end of the gap, where the text after it starts */
+  size_t _cap;     /* The size of the buffer */
+
+  const array_allocator_t *_allocator; /* Allocator of both the string and
+                                        * its buffer */
+} gapstr_t;
+
+/* Creates a new empty string with room for at least 'n' characters.
+ */
+gapstr_t *gapstr_create(size_t n);
+
+gapstr_t *gapstr_create_with_allocator(const array_allocator_t *allocator,
+                                       size_t n);
+
+/* Creates a new string from the data pointed to by 'src', copying it until
+ * '\0' if 'n' == -1, or 'n' bytes.
+ */
+gapstr_t *gapstr_assign(const char *src, st64_t n);
+
+/* Frees the string.
+ */
+void gapstr_kill(gapstr_t *self);
+
+/* Injects the string pointed to by 'src' at position 'pos', copying it until
+ * '\0' if 'n' == -1, or 'n' bytes. The gap moves to the end of the injected
+ * string.
+ */
+bool gapstr_inject(gapstr_t *self, size_t pos, const char *src, st64_t n);
+
+/* Same as 'inject', at the end of the string.
+ */
+bool gapstr_append(gapstr_t *self, const char *src, st64_t n);
+
+/* Removes the characters within start -> end (excluded), the gap moves to
+ * 'start'.
+ */
+void gapstr_wipe(gapstr_t *self, size_t start, size_t end);
+
+/* Makes room for 'n' more characters without reallocating.
+ */
+bool gapstr_adjust(gapstr_t *self, size_t n);
+
+/* Returns the number of characters.
+ */
+__attr_pure size_t gapstr_size(const gapstr_t *self);
+
+/* Returns the character at position 'p'.
+ */
+__attr_pure char gapstr_at(const gapstr_t *self, size_t p);
+
+/* Returns the whole string, contiguous and terminated by '\0'. The gap moves
+ * to the end first, which costs nothing if it is already there (only the
+ * characters after it are moved otherwise). The pointer is valid until the
+ * next edit.
+ */
+const char *gapstr_view(gapstr_t *self);
+
+/* Creates a new dynamic string holding a copy of the string, the gap does
+ * not move.
+ */
+dynstr_t *gapstr_pull(const gapstr_t *self);
+
+#endif /* __GAPSTR_H__ */
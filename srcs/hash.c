@@ -0,0 +1,41 @@
+#include "hash.h"
+#include "internal.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define HASH_P1 0x9e3779b97f4a7c15ULL
+#define HASH_P2 0xc2b2ae3d27d4eb4fULL
+
+static inline ut64_t rotl(ut64_t x, unsigned r) {
+  return ((x << r) | (x >> (64 - r)));
+}
+
+/* The finalizer of MurmurHash3, spreads every bit over the whole word. */
+static inline ut64_t hash_avalanche(ut64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return (h);
+}
+
+__attr_pure uint64_t hash_bytes(const void *data, size_t size) {
+  const ut8_t *p = data;
+  ut64_t h = HASH_P1 ^ (size * HASH_P2);
+  ut64_t w;
+
+  for (; size >= sizeof(w); size -= sizeof(w), p += sizeof(w)) {
+    (void)builtin_memcpy(&w, p, sizeof(w));
+    h ^= rotl(w * HASH_P2, 31) * HASH_P1;
+    h = rotl(h, 27) * 5 + 0x52dce729;
+  }
+
+  if (size) {
+    w = 0;
+    (void)builtin_memcpy(&w, p, size);
+    h ^= rotl(w * HASH_P2, 31) * HASH_P1;
+  }
+
+  return (hash_avalanche(h));
+}
@@ -0,0 +1,14 @@
+#ifndef __HASH_H__
+#define __HASH_H__
+
+#include "internal.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/* Hashes 'size' bytes, 8 at a time. Every bit of the input affects every bit
+ * of the result, so both the low bits (bucket index) and the high bits can
+ * be used.
+ */
+__attr_pure uint64_t hash_bytes(const void *data, size_t size);
+
+#endif /* __HASH_H__ */
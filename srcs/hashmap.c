@@ -0,0 +1,441 @@
+#include "hashmap.h"
+#include "hash.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CTRL_EMPTY ((ut8_t)0x80)
+#define CTRL_DELETED ((ut8_t)0xfe)
+
+/* GROUPS
+ *
+ * A group is GROUP_WIDTH consecutive control bytes, starting anywhere. The
+ * 'group_*' functions return a mask with one bit per matching slot, and
+ * 'group_lowest' turns its lowest bit back into a position in the group.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+#define GROUP_WIDTH 16
+typedef ut32_t group_mask_t;
+
+static inline group_mask_t group_match(const ut8_t *ctrl, ut8_t h2) {
+  __m128i g = _mm_loadu_si128((const __m128i *)ctrl);
+
+  return ((ut32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)h2))));
+}
+
+static inline group_mask_t group_match_empty(const ut8_t *ctrl) {
+  return (group_match(ctrl, CTRL_EMPTY));
+}
+
+/* empty or deleted, the only control bytes with the high bit set */
+static inline group_mask_t group_match_free(const ut8_t *ctrl) {
+  return ((ut32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl)));
+}
+
+static inline size_t group_lowest(group_mask_t m) {
+  return ((size_t)__builtin_ctz(m));
+}
+
+/* The number of slots after the highest bit. */
+static inline size_t group_leading(group_mask_t m) {
+  return ((size_t)__builtin_clz(m) - (32 - GROUP_WIDTH));
+}
+
+#else /* Portable version, 8 bytes packed in a word */
+
+#define GROUP_WIDTH 8
+#define GROUP_LSBS 0x0101010101010101ULL
+#define GROUP_MSBS 0x8080808080808080ULL
+typedef ut64_t group_mask_t;
+
+static inline ut64_t group_load(const ut8_t *ctrl) {
+  ut64_t g;
+
+  (void)builtin_memcpy(&g, ctrl, sizeof(g));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  g = __builtin_bswap64(g);
+#endif
+  return (g);
+}
+
+/* May report a false positive just above a real match, the key comparison
+ * sorts it out. */
+static inline group_mask_t group_match(const ut8_t *ctrl, ut8_t h2) {
+  ut64_t x = group_load(ctrl) ^ (GROUP_LSBS * h2);
+
+  return ((x - GROUP_LSBS) & ~x & GROUP_MSBS);
+}
+
+/* 0x80 is the only control byte with the high bit set and bit 1 clear */
+static inline group_mask_t group_match_empty(const ut8_t *ctrl) {
+  ut64_t g = group_load(ctrl);
+
+  return (g & ~(g << 6) & GROUP_MSBS);
+}
+
+static inline group_mask_t group_match_free(const ut8_t *ctrl) {
+  return (group_load(ctrl) & GROUP_MSBS);
+}
+
+static inline size_t group_lowest(group_mask_t m) {
+  return ((size_t)__builtin_ctzll(m) >> 3);
+}
+
+static inline size_t group_leading(group_mask_t m) {
+  return ((size_t)__builtin_clzll(m) >> 3);
+}
+
+#endif
+
+/* HELPERS */
+
+#define _slot(map, i) ((ut8_t *)(map)->_slots + (i) * (map)->_slot_size)
+#define _h1(hash) ((hash) >> 7)
+#define _h2(hash) ((ut8_t)((hash)&0x7f))
+
+static inline size_t max_load(size_t cap) { return (cap - cap / 8); }
+
+static inline size_t ctrl_bytes(size_t cap) {
+  return ((cap + GROUP_WIDTH + 15) & ~(size_t)15);
+}
+
+static inline void set_ctrl(hashmap_t *self, size_t i, ut8_t c) {
+  self->_ctrl[i] = c;
+  if (i < GROUP_WIDTH) {
+    self->_ctrl[self->_cap + i] = c;
+  }
+}
+
+static bool bytes_eq(const void *a, const void *b, size_t size) {
+  return (memcmp(a, b, size) == 0);
+}
+
+/* The largest power of 2 dividing 'size', up to 8. */
+static inline size_t natural_align(size_t size) {
+  return (size ? MIN(size & -size, 8) : 1);
+}
+
+/* Returns the slot holding 'key', or SIZE_MAX. */
+static size_t hashmap_find(const hashmap_t *self, const void *key,
+                           ut64_t hash) {
+  if (unlikely(!self->_cap)) {
+    return (SIZE_MAX);
+  }
+
+  size_t mask = self->_cap - 1;
+  size_t pos = _h1(hash) & mask;
+
+  /* Triangular probing visits every group once the table wraps around. */
+  for (size_t step = GROUP_WIDTH;; pos = (pos + step) & mask,
+              step += GROUP_WIDTH) {
+    group_mask_t m = group_match(self->_ctrl + pos, _h2(hash));
+
+    for (; m; m &= m - 1) {
+      size_t i = (pos + group_lowest(m)) & mask;
+
+      if (likely(self->_eq(_slot(self, i), key, self->_key_size))) {
+        return (i);
+      }
+    }
+
+    if (likely(group_match_empty(self->_ctrl + pos))) {
+      return (SIZE_MAX);
+    }
+  }
+}
+
+/* Returns the first empty or deleted slot on the probe sequence of 'hash'. */
+static size_t hashmap_find_free(const hashmap_t *self, ut64_t hash) {
+  size_t mask = self->_cap - 1;
+  size_t pos = _h1(hash) & mask;
+
+  for (size_t step = GROUP_WIDTH;; pos = (pos + step) & mask,
+              step += GROUP_WIDTH) {
+    group_mask_t m = group_match_free(self->_ctrl + pos);
+
+    if (likely(m)) {
+      return ((pos + group_lowest(m)) & mask);
+    }
+  }
+}
+
+/* Moves every entry to a new buffer of 'cap' slots, leaving the tombstones
+ * behind. */
+static bool hashmap_rehash(hashmap_t *self, size_t cap) {
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(cap, self->_slot_size) == false);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_ADD(cap * self->_slot_size, ctrl_bytes(cap)) ==
+                 false);
+
+  hashmap_t old = *self;
+  ut8_t *buffer = _allocator_alloc(self->_allocator,
+                                   ctrl_bytes(cap) + cap * self->_slot_size);
+
+  if (unlikely(!buffer)) {
+    return (false);
+  }
+
+  (void)builtin_memset(buffer, CTRL_EMPTY, cap + GROUP_WIDTH);
+  self->_ctrl = buffer;
+  self->_slots = buffer + ctrl_bytes(cap);
+  self->_cap = cap;
+  self->_growth_left = max_load(cap) - self->_nmemb;
+
+  for (size_t i = 0; i < old._cap; i++) {
+    if (old._ctrl[i] & 0x80) {
+      continue;
+    }
+
+    ut64_t hash = self->_hash(_slot(&old, i), self->_key_size);
+    size_t j = hashmap_find_free(self, hash);
+
+    set_ctrl(self, j, _h2(hash));
+    (void)builtin_memcpy(_slot(self, j), _slot(&old, i), self->_slot_size);
+  }
+
+  if (old._ctrl) {
+    _allocator_free(self->_allocator, old._ctrl);
+  }
+
+  return (true);
+}
+
+/* API */
+
+hashmap_t *hashmap_create(size_t key_size, size_t value_size,
+                          void (*_free)(void *)) {
+  return (hashmap_create_with_allocator(&__array_allocator__, key_size,
+                                        value_size, _free));
+}
+
+hashmap_t *hashmap_create_with_allocator(const array_allocator_t *allocator,
+                                         size_t key_size, size_t value_size,
+                                         void (*_free)(void *)) {
+  HR_COMPLAIN_IF(allocator == NULL);
+  HR_COMPLAIN_IF(key_size == 0);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_ADD(key_size, (value_size + 16)) == false);
+
+  hashmap_t *self = _allocator_alloc(allocator, sizeof(*self));
+
+  if (unlikely(!self)) {
+    return (NULL);
+  }
+
+  size_t key_align = natural_align(key_size);
+  size_t value_align = natural_align(value_size);
+  size_t align = MAX(key_align, value_align);
+
+  (void)builtin_memset(self, 0x00, sizeof(*self));
+  self->_key_size = key_size;
+  self->_value_size = value_size;
+  self->_value_offset = (key_size + value_align - 1) & ~(value_align - 1);
+  self->_slot_size =
+      (self->_value_offset + value_size + align - 1) & ~(align - 1);
+  self->_hash = &hash_bytes;
+  self->_eq = &bytes_eq;
+  self->_free = _free;
+  self->_allocator = allocator;
+
+  return (self);
+}
+
+void hashmap_set_hasher(hashmap_t *self,
+                        uint64_t (*hash)(const void *, size_t),
+                        bool (*eq)(const void *, const void *, size_t)) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(self->_nmemb != 0);
+
+  self->_hash = hash ? hash : &hash_bytes;
+  self->_eq = eq ? eq : &bytes_eq;
+}
+
+void hashmap_kill(hashmap_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  hashmap_clear(self);
+  if (self->_ctrl) {
+    _allocator_free(self->_allocator, self->_ctrl);
+  }
+  _allocator_free(self->_allocator, self);
+}
+
+void hashmap_clear(hashmap_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  if (!self->_cap) {
+    return;
+  }
+
+  if (self->_free) {
+    for (size_t i = 0; i < self->_cap; i++) {
+      if (!(self->_ctrl[i] & 0x80)) {
+        self->_free(_slot(self, i));
+      }
+    }
+  }
+
+  (void)builtin_memset(self->_ctrl, CTRL_EMPTY, self->_cap + GROUP_WIDTH);
+  self->_nmemb = 0;
+  self->_growth_left = max_load(self->_cap);
+}
+
+bool hashmap_reserve(hashmap_t *self, size_t n) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  if (n <= self->_nmemb + self->_growth_left) {
+    return (true);
+  }
+
+  size_t cap = MAX(self->_cap, GROUP_WIDTH);
+
+  while (max_load(cap) < n) {
+    HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(cap, 2) == false);
+    cap *= 2;
+  }
+
+  return (hashmap_rehash(self, cap));
+}
+
+__attr_pure void *hashmap_get(const hashmap_t *self, const void *key) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(key == NULL);
+
+  size_t i = hashmap_find(self, key, self->_hash(key, self->_key_size));
+
+  if (i == SIZE_MAX) {
+    return (NULL);
+  }
+
+  return (_slot(self, i) + self->_value_offset);
+}
+
+void *hashmap_emplace(hashmap_t *self, const void *key, bool *inserted) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(key == NULL);
+  HR_COMPLAIN_IF(inserted == NULL);
+
+  ut64_t hash = self->_hash(key, self->_key_size);
+  size_t i = hashmap_find(self, key, hash);
+
+  *inserted = false;
+  if (i != SIZE_MAX) {
+    return (_slot(self, i) + self->_value_offset);
+  }
+
+  i = self->_cap ? hashmap_find_free(self, hash) : 0;
+
+  /* A tombstone can be reused for free, an empty slot needs some room. */
+  if (unlikely(!self->_cap ||
+               (!self->_growth_left && self->_ctrl[i] != CTRL_DELETED))) {
+    /* Up to 25/32 full, the room is mostly tombstones: they go away
+     * without growing the table. */
+    size_t cap = self->_cap;
+
+    if (self->_nmemb > cap - cap / 4 - cap / 32) {
+      HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(cap, 2) == false);
+      cap *= 2;
+    }
+
+    if (unlikely(!hashmap_rehash(self, MAX(cap, GROUP_WIDTH)))) {
+      return (NULL);
+    }
+    i = hashmap_find_free(self, hash);
+  }
+
+  self->_growth_left -= (self->_ctrl[i] == CTRL_EMPTY);
+  self->_nmemb++;
+  set_ctrl(self, i, _h2(hash));
+  (void)builtin_memcpy(_slot(self, i), key, self->_key_size);
+  *inserted = true;
+
+  return (_slot(self, i) + self->_value_offset);
+}
+
+void *hashmap_put(hashmap_t *self, const void *key, const void *value) {
+  HR_COMPLAIN_IF(value == NULL && self->_value_size);
+
+  bool inserted;
+  ut8_t *v = hashmap_emplace(self, key, &inserted);
+
+  if (unlikely(!v)) {
+    return (NULL);
+  }
+
+  if (!inserted && self->_free) {
+    ut8_t *entry = v - self->_value_offset;
+
+    self->_free(entry);
+    (void)builtin_memcpy(entry, key, self->_key_size);
+  }
+  if (self->_value_size) {
+    (void)builtin_memcpy(v, value, self->_value_size);
+  }
+
+  return (v);
+}
+
+bool hashmap_erase(hashmap_t *self, const void *key) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(key == NULL);
+
+  size_t i = hashmap_find(self, key, self->_hash(key, self->_key_size));
+
+  if (i == SIZE_MAX) {
+    return (false);
+  }
+
+  if (self->_free) {
+    self->_free(_slot(self, i));
+  }
+
+  /* If no group covering this slot was ever seen full, no probe sequence
+   * went past it, so it can go back to empty instead of becoming a
+   * tombstone. */
+  size_t before = (i - GROUP_WIDTH) & (self->_cap - 1);
+  group_mask_t empty_before = group_match_empty(self->_ctrl + before);
+  group_mask_t empty_after = group_match_empty(self->_ctrl + i);
+
+  if (empty_before && empty_after &&
+      group_lowest(empty_after) + group_leading(empty_before) < GROUP_WIDTH) {
+    set_ctrl(self, i, CTRL_EMPTY);
+    self->_growth_left++;
+  } else {
+    set_ctrl(self, i, CTRL_DELETED);
+  }
+  self->_nmemb--;
+
+  return (true);
+}
+
+__attr_pure size_t hashmap_size(const hashmap_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (self->_nmemb);
+}
+
+bool hashmap_next(const hashmap_t *self, size_t *it, void **key,
+                  void **value) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(it == NULL);
+
+  for (size_t i = *it; i < self->_cap; i++) {
+    if (self->_ctrl[i] & 0x80) {
+      continue;
+    }
+
+    if (key) {
+      *key = _slot(self, i);
+    }
+    if (value) {
+      *value = _slot(self, i) + self->_value_offset;
+    }
+    *it = i + 1;
+    return (true);
+  }
+
+  *it = self->_cap;
+  return (false);
+}
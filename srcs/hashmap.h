@@ -0,0 +1,105 @@
+#ifndef __HASHMAP_H__
+#define __HASHMAP_H__
+
+#include "array.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* A hash map storing fixed-size keys and values inline, in a single flat
+ * buffer (open addressing, Swiss table layout).
+ *
+ * Every slot has a control byte telling whether it is empty, deleted or
+ * full, and in the latter case holding 7 bits of the hash of its key. A
+ * lookup compares the control bytes of a whole group of slots at once
+ * (with SSE2 when available), and only looks at the keys whose 7 bits
+ * match.
+ */
+typedef struct {
+  ut8_t *_ctrl;  /* The control bytes, the first group being repeated after
+                  * the last slot so any group can be loaded at once */
+  void *_slots;  /* The entries: the key, then the value at '_value_offset' */
+  size_t _cap;   /* The number of slots (0, or a power of 2) */
+  size_t _nmemb; /* The number of entries */
+  size_t _growth_left; /* The number of empty slots that can be filled before
+                        * the map is rehashed */
+
+  size_t _key_size;
+  size_t _value_size;
+  size_t _value_offset; /* The offset of the value in an entry */
+  size_t _slot_size;    /* The size of an entry */
+
+  uint64_t (*_hash)(const void *, size_t); /* The key hash function */
+  bool (*_eq)(const void *, const void *, size_t); /* The key equality
+                                                    * function */
+  void (*_free)(void *); /* the entry destructor function */
+
+  const array_allocator_t *_allocator; /* Allocator of both the map and its
+                                        * buffer */
+} hashmap_t;
+
+/* Creates an empty map, nothing is allocated for the entries until the first
+ * insertion. '_free', if not NULL, is called with a pointer to each entry
+ * removed from the map. With a 'value_size' of 0 the map is a set.
+ */
+hashmap_t *hashmap_create(size_t key_size, size_t value_size,
+                          void (*_free)(void *));
+
+hashmap_t *hashmap_create_with_allocator(const array_allocator_t *allocator,
+                                         size_t key_size, size_t value_size,
+                                         void (*_free)(void *));
+
+/* Replaces the key hash function ('hash_bytes' by default) and the key
+ * equality function (byte comparison by default). The map must be empty.
+ */
+void hashmap_set_hasher(hashmap_t *self,
+                        uint64_t (*hash)(const void *, size_t),
+                        bool (*eq)(const void *, const void *, size_t));
+
+/* Frees the map, clearing the content beforehand.
+ */
+void hashmap_kill(hashmap_t *self);
+
+/* Removes all the entries, the capacity remains unchanged.
+ */
+void hashmap_clear(hashmap_t *self);
+
+/* Makes room for 'n' entries in total, so inserting them won't rehash.
+ */
+bool hashmap_reserve(hashmap_t *self, size_t n);
+
+/* Returns a pointer to the value stored for 'key', or NULL if there is none.
+ * The pointer is valid until the next insertion.
+ */
+__attr_pure void *hashmap_get(const hashmap_t *self, const void *key);
+
+/* Returns a pointer to the value stored for 'key', inserting the key first
+ * if needed, in which case '*inserted' is set to true and the value is left
+ * for the caller to initialize. Returns NULL if the map could not grow.
+ */
+void *hashmap_emplace(hashmap_t *self, const void *key, bool *inserted);
+
+/* Stores a copy of 'value' for 'key', destroying the entry previously
+ * stored for that key. Returns a pointer to the stored value, or NULL if the
+ * map could not grow.
+ */
+void *hashmap_put(hashmap_t *self, const void *key, const void *value);
+
+/* Destroys and removes the entry of 'key'. Returns false if there is none.
+ */
+bool hashmap_erase(hashmap_t *self, const void *key);
+
+/* Returns the number of entries.
+ */
+__attr_pure size_t hashmap_size(const hashmap_t *self);
+
+/* Iterates over the entries in the order they are laid out in memory:
+ * starting with '*it' set to 0, every call stores the next entry in 'key'
+ * and 'value' (either may be NULL) and returns true, until there are no
+ * more. The map must not be modified during the iteration.
+ */
+bool hashmap_next(const hashmap_t *self, size_t *it, void **key,
+                  void **value);
+
+#endif /* __HASHMAP_H__ */
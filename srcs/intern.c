@@ -0,0 +1,191 @@
+#include "intern.h"
+#include "array.h"
+#include "hash.h"
+#include "hashmap.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* The index is keyed by the views themselves: the key hash and equality
+ * functions look through them to the bytes. */
+static uint64_t view_hash(const void *key, size_t size) {
+  const x_str_t *view = key;
+
+  (void)size;
+  return (hash_bytes(view->_ptr, view->_size));
+}
+
+static bool view_eq(const void *a, const void *b, size_t size) {
+  const x_str_t *x = a;
+  const x_str_t *y = b;
+
+  (void)size;
+  return (x->_size == y->_size && memcmp(x->_ptr, y->_ptr, x->_size) == 0);
+}
+
+static void slab_kill(void *slab) { array_kill(*(array_t **)slab); }
+
+/* Copies 'size' bytes and a terminator into a slab, and returns the copy. */
+static const char *intern_store(intern_t *self, const char *str, size_t size) {
+  size_t nslabs = array_size(self->_slabs);
+  array_t *slab = nslabs ? *(array_t **)array_at(self->_slabs, nslabs - 1)
+                         : NULL;
+
+  /* Slabs are settled, they refuse to append rather than move. */
+  if (!slab || !array_adjust(slab, size + 1)) {
+    slab = array_create_with_allocator(self->_allocator, sizeof(char),
+                                       MAX(self->_slab_size, size + 2), NULL);
+    if (unlikely(!slab)) {
+      return (NULL);
+    }
+    array_settle(slab);
+
+    if (unlikely(!array_push(self->_slabs, &slab))) {
+      array_kill(slab);
+      return (NULL);
+    }
+
+    /* An oversized string fills its slab, the previous one stays last to
+     * keep being filled. */
+    if (size + 2 > self->_slab_size && nslabs) {
+      array_swap_elems(self->_slabs, nslabs - 1, nslabs);
+    }
+  }
+
+  char *copy = (char *)slab->_ptr + slab->_nmemb;
+
+  (void)array_append(slab, str, size);
+  (void)array_push(slab, "");
+  self->_bytes += size + 1;
+
+  return (copy);
+}
+
+intern_t *intern_create(size_t slab_size) {
+  return (intern_create_with_allocator(&__array_allocator__, slab_size));
+}
+
+intern_t *intern_create_with_allocator(const array_allocator_t *allocator,
+                                       size_t slab_size) {
+  HR_COMPLAIN_IF(allocator == NULL);
+
+  intern_t *self = _allocator_alloc(allocator, sizeof(*self));
+
+  if (unlikely(!self)) {
+    return (NULL);
+  }
+
+  (void)builtin_memset(self, 0x00, sizeof(*self));
+  self->_allocator = allocator;
+  self->_slab_size = slab_size ? slab_size : INTERN_SLAB_SIZE;
+  self->_slabs =
+      array_create_with_allocator(allocator, sizeof(array_t *), 0, &slab_kill);
+  self->_strings =
+      array_create_with_allocator(allocator, sizeof(x_str_t), 0, NULL);
+  self->_index = hashmap_create_with_allocator(allocator, sizeof(x_str_t),
+                                               sizeof(ut32_t), NULL);
+
+  if (unlikely(!self->_slabs || !self->_strings || !self->_index)) {
+    intern_kill(self);
+    return (NULL);
+  }
+  hashmap_set_hasher(self->_index, &view_hash, &view_eq);
+
+  return (self);
+}
+
+void intern_kill(intern_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  if (self->_index) {
+    hashmap_kill(self->_index);
+  }
+  if (self->_strings) {
+    array_kill(self->_strings);
+  }
+  if (self->_slabs) {
+    array_kill(self->_slabs);
+  }
+  _allocator_free(self->_allocator, self);
+}
+
+bool intern_put(intern_t *self, const char *str, st64_t n, ut32_t *id) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(str == NULL);
+  HR_COMPLAIN_IF(id == NULL);
+  HR_COMPLAIN_IF(n < -1);
+
+  x_str_t view = {._ptr = str, ._size = n == -1 ? strlen(str) : (size_t)n};
+  bool inserted;
+  ut32_t *value = hashmap_emplace(self->_index, &view, &inserted);
+
+  if (unlikely(!value)) {
+    return (false);
+  }
+
+  if (!inserted) {
+    *id = *value;
+    return (true);
+  }
+
+  /* The key still points to the caller's bytes, it is redirected to the
+   * copy before anything else can look at it. */
+  x_str_t *key = (x_str_t *)((char *)value - self->_index->_value_offset);
+
+  HR_COMPLAIN_IF(array_size(self->_strings) >= UINT32_MAX);
+  key->_ptr = intern_store(self, str, view._size);
+
+  if (unlikely(!key->_ptr || !array_push(self->_strings, key))) {
+    key->_ptr = str;
+    (void)hashmap_erase(self->_index, &view);
+    return (false);
+  }
+
+  *value = (ut32_t)(array_size(self->_strings) - 1);
+  *id = *value;
+
+  return (true);
+}
+
+bool intern_put_dynstr(intern_t *self, const dynstr_t *str, ut32_t *id) {
+  HR_COMPLAIN_IF(str == NULL);
+
+  return (intern_put(self, str->_ptr, str->_nmemb - 1, id));
+}
+
+bool intern_find(const intern_t *self, const char *str, st64_t n, ut32_t *id) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(str == NULL);
+  HR_COMPLAIN_IF(id == NULL);
+  HR_COMPLAIN_IF(n < -1);
+
+  x_str_t view = {._ptr = str, ._size = n == -1 ? strlen(str) : (size_t)n};
+  ut32_t *value = hashmap_get(self->_index, &view);
+
+  if (!value) {
+    return (false);
+  }
+
+  *id = *value;
+  return (true);
+}
+
+__attr_pure x_str_t intern_view(const intern_t *self, ut32_t id) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(id >= array_size(self->_strings));
+
+  return (*(const x_str_t *)array_at(self->_strings, id));
+}
+
+__attr_pure size_t intern_size(const intern_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (array_size(self->_strings));
+}
+
+__attr_pure size_t intern_bytes(const intern_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (self->_bytes);
+}
@@ -0,0 +1,70 @@
+#ifndef __INTERN_H__
+#define __INTERN_H__
+
+#include "array.h"
+#include "dynstr.h"
+#include "hashmap.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* A string interning table: every distinct string is stored once and named
+ * by a 32-bit id, given in insertion order starting from 0.
+ *
+ * The bytes live in a few large append-only slabs that never move, so the
+ * views handed out stay valid until the table is killed. Each string is
+ * followed by a '\0' in its slab, the views can be used as C strings.
+ */
+typedef struct {
+  array_t *_slabs;   /* The slabs ('array_t *'), the one being filled last */
+  array_t *_strings; /* The view of every string ('x_str_t'), by id */
+  hashmap_t *_index; /* A set of views, mapping each string to its id */
+  size_t _slab_size; /* The capacity of a new slab */
+  size_t _bytes;     /* The number of bytes stored, terminators included */
+
+  const array_allocator_t *_allocator;
+} intern_t;
+
+/* Creates an empty table whose slabs hold 'slab_size' bytes
+ * ('INTERN_SLAB_SIZE' if 0). Longer strings get a slab of their own.
+ */
+intern_t *intern_create(size_t slab_size);
+
+/* Same as 'create', but everything is allocated through 'allocator'.
+ */
+intern_t *intern_create_with_allocator(const array_allocator_t *allocator,
+                                       size_t slab_size);
+
+/* Frees the table and all its strings.
+ */
+void intern_kill(intern_t *self);
+
+/* Stores the id of 'str' in 'id', adding a copy of the string to the table
+ * if it is not there yet. It reads the string until '\0' if 'n' == -1, or
+ * 'n' bytes. Returns false if the table could not grow.
+ */
+bool intern_put(intern_t *self, const char *str, st64_t n, ut32_t *id);
+
+/* Same as 'put', with the content of a dynamic string.
+ */
+bool intern_put_dynstr(intern_t *self, const dynstr_t *str, ut32_t *id);
+
+/* Stores the id of 'str' in 'id' if the table holds it, otherwise returns
+ * false.
+ */
+bool intern_find(const intern_t *self, const char *str, st64_t n, ut32_t *id);
+
+/* Returns the string named 'id'.
+ */
+__attr_pure x_str_t intern_view(const intern_t *self, ut32_t id);
+
+/* Returns the number of distinct strings.
+ */
+__attr_pure size_t intern_size(const intern_t *self);
+
+/* Returns the number of bytes used by the strings, terminators included.
+ */
+__attr_pure size_t intern_bytes(const intern_t *self);
+
+#endif /* __INTERN_H__ */
@@ -10,14 +10,24 @@
 
 // # define DISABLE_HARDENED_RUNTIME
 // # define DISABLE_HARDENED_RUNTIME_LOGGING
+// # define DISABLE_TRANSPARENT_HUGEPAGES
 
 #define ARRAY_INITIAL_SIZE 64
+#define ARRAY_SBO_SIZE 64
+#define ARRAY_MMAP_THRESHOLD (64UL << 20)
+#define ARRAY_CACHE_LINE_SIZE 64
+#define ARRAY_PARALLEL_GRAIN 4096
+#define ARRAY_BATCH_SIZE 256
+#define ARRAY_SORT_INSERTION 16
+#define ARENA_CHUNK_SIZE 65536
+#define INTERN_SLAB_SIZE 65536
+#define ROPE_CHUNK_SIZE 4096
 #define META_TRACE_SIZE 10
 
 /* DEFINED TYPES */
 #define SIZE_TYPE(__n) size_t __n
 #define SSIZE_TYPE(__n) int64_t __n
-#define SIZE_TYPE_MAX INT_MAX
+#define SIZE_TYPE_MAX SIZE_MAX
 #define SIZE_TYPE_MIN INT_MIN
 
 #define ARRAY_TYPE(__x) array_t *__x
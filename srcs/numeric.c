@@ -0,0 +1,727 @@
+#include "numeric.h"
+#include "array.h"
+#include "array_sort.h"
+#include "cpu.h"
+#include "internal.h"
+#include "search.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* A multiplication followed by an addition must not be fused into a single
+ * rounding, or the scalar and the wide kernels would disagree. */
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#define NUMERIC_LANES 8
+
+#define LANE_ADD(a, b) ((a) + (b))
+#define LANE_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define LANE_MAX(a, b) ((a) > (b) ? (a) : (b))
+#define LANES_REDUCE(r, op)                                                    \
+  op(op(op(r[0], r[4]), op(r[2], r[6])), op(op(r[1], r[5]), op(r[3], r[7])))
+
+typedef numeric_value_t (*sum_kernel_t)(const void *, size_t);
+typedef numeric_value_t (*dot_kernel_t)(const void *, const void *, size_t);
+typedef void (*minmax_kernel_t)(const void *, size_t, numeric_value_t *,
+                                numeric_value_t *);
+typedef void (*prefix_kernel_t)(void *, size_t);
+typedef void (*axpy_kernel_t)(void *, const void *, size_t, numeric_value_t);
+typedef void (*clamp_kernel_t)(void *, size_t, numeric_value_t,
+                               numeric_value_t);
+typedef void (*convert_kernel_t)(void *, const void *, size_t);
+
+static inline size_t key_width(array_key_t type) {
+  return (type <= ARRAY_KEY_F32 ? 4 : 8);
+}
+
+/* SCALAR KERNELS
+ *
+ * Integers go through unsigned types ('acc_t') so they wrap around.
+ */
+
+#define SCALAR_REDUCE(name, type, acc_t, field)                                \
+  static numeric_value_t sum_##name(const void *base, size_t n) {              \
+    const type *p = base;                                                      \
+    acc_t r[NUMERIC_LANES] = {0};                                              \
+    numeric_value_t sum;                                                       \
+                                                                               \
+    for (size_t i = 0; i < n; i++) {                                           \
+      r[i % NUMERIC_LANES] += (acc_t)p[i];                                     \
+    }                                                                          \
+    sum.field = LANES_REDUCE(r, LANE_ADD);                                     \
+    return (sum);                                                              \
+  }                                                                            \
+                                                                               \
+  static numeric_value_t dot_##name(const void *a, const void *b, size_t n) {  \
+    const type *p = a;                                                         \
+    const type *q = b;                                                         \
+    acc_t r[NUMERIC_LANES] = {0};                                              \
+    numeric_value_t dot;                                                       \
+                                                                               \
+    for (size_t i = 0; i < n; i++) {                                           \
+      r[i % NUMERIC_LANES] += (acc_t)p[i] * (acc_t)q[i];                       \
+    }                                                                          \
+    dot.field = LANES_REDUCE(r, LANE_ADD);                                     \
+    return (dot);                                                              \
+  }
+
+#define SCALAR_ELEMENTWISE(name, type, acc_t, field)                           \
+  static void prefix_##name(void *base, size_t n) {                            \
+    type *p = base;                                                            \
+    acc_t acc = 0;                                                             \
+                                                                               \
+    for (size_t i = 0; i < n; i++) {                                           \
+      acc += (acc_t)p[i];                                                      \
+      p[i] = (type)acc;                                                        \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  static void axpy_##name(void *y, const void *x, size_t n,                    \
+                          numeric_value_t a) {                                 \
+    type *p = y;                                                               \
+    const type *q = x;                                                         \
+    acc_t v = (acc_t)(type)a.field;                                            \
+                                                                               \
+    for (size_t i = 0; i < n; i++) {                                           \
+      p[i] = (type)(v * (acc_t)q[i] + (acc_t)p[i]);                            \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  static void clamp_##name(void *base, size_t n, numeric_value_t lo,          \
+                           numeric_value_t hi) {                               \
+    type *p = base;                                                            \
+    type l = (type)lo.field;                                                   \
+    type h = (type)hi.field;                                                   \
+                                                                               \
+    for (size_t i = 0; i < n; i++) {                                           \
+      type x = LANE_MAX(p[i], l);                                              \
+                                                                               \
+      p[i] = LANE_MIN(x, h);                                                   \
+    }                                                                          \
+  }
+
+#define SCALAR_MINMAX_FLOAT(name, type)                                        \
+  static void minmax_##name(const void *base, size_t n, numeric_value_t *min, \
+                            numeric_value_t *max) {                            \
+    const type *p = base;                                                      \
+    type lo[NUMERIC_LANES];                                                    \
+    type hi[NUMERIC_LANES];                                                    \
+                                                                               \
+    for (size_t j = 0; j < NUMERIC_LANES; j++) {                               \
+      lo[j] = p[0];                                                            \
+      hi[j] = p[0];                                                            \
+    }                                                                          \
+    for (size_t i = 0; i < n; i++) {                                           \
+      lo[i % NUMERIC_LANES] = LANE_MIN(p[i], lo[i % NUMERIC_LANES]);           \
+      hi[i % NUMERIC_LANES] = LANE_MAX(p[i], hi[i % NUMERIC_LANES]);           \
+    }                                                                          \
+    min->_f = LANES_REDUCE(lo, LANE_MIN);                                      \
+    max->_f = LANES_REDUCE(hi, LANE_MAX);                                      \
+  }
+
+/* Integers have no rounding, the search kernels do. */
+#define SCALAR_MINMAX_INT(name, type, field, is_signed)                        \
+  static void minmax_##name(const void *base, size_t n, numeric_value_t *min, \
+                            numeric_value_t *max) {                            \
+    type lo;                                                                   \
+    type hi;                                                                   \
+                                                                               \
+    search_minmax(base, n, sizeof(type), is_signed, &lo, &hi);                 \
+    min->field = lo;                                                           \
+    max->field = hi;                                                           \
+  }
+
+SCALAR_REDUCE(u32, ut32_t, ut64_t, _u)
+SCALAR_REDUCE(i32, st32_t, ut64_t, _u)
+SCALAR_REDUCE(f32, float, float, _f)
+SCALAR_REDUCE(u64, ut64_t, ut64_t, _u)
+SCALAR_REDUCE(f64, double, double, _f)
+
+SCALAR_ELEMENTWISE(u32, ut32_t, ut32_t, _u)
+SCALAR_ELEMENTWISE(i32, st32_t, ut32_t, _i)
+SCALAR_ELEMENTWISE(f32, float, float, _f)
+SCALAR_ELEMENTWISE(u64, ut64_t, ut64_t, _u)
+SCALAR_ELEMENTWISE(i64, st64_t, ut64_t, _i)
+SCALAR_ELEMENTWISE(f64, double, double, _f)
+
+SCALAR_MINMAX_INT(u32, ut32_t, _u, false)
+SCALAR_MINMAX_INT(i32, st32_t, _i, true)
+SCALAR_MINMAX_FLOAT(f32, float)
+SCALAR_MINMAX_INT(u64, ut64_t, _u, false)
+SCALAR_MINMAX_INT(i64, st64_t, _i, true)
+SCALAR_MINMAX_FLOAT(f64, double)
+
+#define CONVERT_LOOP(dst_t, src_t)                                             \
+  for (size_t i = 0; i < n; i++) {                                             \
+    ((dst_t *)dst)[i] = (dst_t)((const src_t *)src)[i];                        \
+  }                                                                            \
+  break
+
+#define CONVERT_FROM(src_t)                                                    \
+  switch (to) {                                                                \
+  case ARRAY_KEY_U32:                                                          \
+    CONVERT_LOOP(ut32_t, src_t);                                               \
+  case ARRAY_KEY_I32:                                                          \
+    CONVERT_LOOP(st32_t, src_t);                                               \
+  case ARRAY_KEY_F32:                                                          \
+    CONVERT_LOOP(float, src_t);                                                \
+  case ARRAY_KEY_U64:                                                          \
+    CONVERT_LOOP(ut64_t, src_t);                                               \
+  case ARRAY_KEY_I64:                                                          \
+    CONVERT_LOOP(st64_t, src_t);                                               \
+  case ARRAY_KEY_F64:                                                          \
+    CONVERT_LOOP(double, src_t);                                               \
+  }                                                                            \
+  break
+
+static void convert_scalar(void *dst, array_key_t to, const void *src,
+                           array_key_t from, size_t n) {
+  switch (from) {
+  case ARRAY_KEY_U32:
+    CONVERT_FROM(ut32_t);
+  case ARRAY_KEY_I32:
+    CONVERT_FROM(st32_t);
+  case ARRAY_KEY_F32:
+    CONVERT_FROM(float);
+  case ARRAY_KEY_U64:
+    CONVERT_FROM(ut64_t);
+  case ARRAY_KEY_I64:
+    CONVERT_FROM(st64_t);
+  case ARRAY_KEY_F64:
+    CONVERT_FROM(double);
+  }
+}
+
+#ifdef CPU_X86
+
+/* WIDE KERNELS
+ *
+ * A vector of 8 elements (or two of 4) holds the 8 partial results of a
+ * reduction, lane 'j' taking the elements 'i' with 'i % 8 == j' like the
+ * scalar version. The lanes are stored at the end, the tail is folded into
+ * them and they are combined in the same order.
+ */
+
+__attribute__((target("avx2"))) static numeric_value_t
+sum_f32_avx2(const void *base, size_t n) {
+  const float *p = base;
+  __m256 acc = _mm256_setzero_ps();
+  float r[NUMERIC_LANES];
+  numeric_value_t sum;
+  size_t i = 0;
+
+  for (; i + NUMERIC_LANES <= n; i += NUMERIC_LANES) {
+    acc = _mm256_add_ps(acc, _mm256_loadu_ps(p + i));
+  }
+  _mm256_storeu_ps(r, acc);
+  for (; i < n; i++) {
+    r[i % NUMERIC_LANES] += p[i];
+  }
+  sum._f = LANES_REDUCE(r, LANE_ADD);
+  return (sum);
+}
+
+__attribute__((target("avx2"))) static numeric_value_t
+sum_f64_avx2(const void *base, size_t n) {
+  const double *p = base;
+  __m256d lo = _mm256_setzero_pd();
+  __m256d hi = _mm256_setzero_pd();
+  double r[NUMERIC_LANES];
+  numeric_value_t sum;
+  size_t i = 0;
+
+  for (; i + NUMERIC_LANES <= n; i += NUMERIC_LANES) {
+    lo = _mm256_add_pd(lo, _mm256_loadu_pd(p + i));
+    hi = _mm256_add_pd(hi, _mm256_loadu_pd(p + i + 4));
+  }
+  _mm256_storeu_pd(r, lo);
+  _mm256_storeu_pd(r + 4, hi);
+  for (; i < n; i++) {
+    r[i % NUMERIC_LANES] += p[i];
+  }
+  sum._f = LANES_REDUCE(r, LANE_ADD);
+  return (sum);
+}
+
+/* 32-bit integers are widened to 64 bits, with or without their sign. */
+#define WIDE_SUM_32(name, type, widen)                                         \
+  __attribute__((target("avx2"))) static numeric_value_t sum_##name##_avx2(    \
+      const void *base, size_t n) {                                            \
+    const type *p = base;                                                      \
+    __m256i lo = _mm256_setzero_si256();                                       \
+    __m256i hi = _mm256_setzero_si256();                                       \
+    ut64_t r[NUMERIC_LANES];                                                   \
+    numeric_value_t sum;                                                       \
+    size_t i = 0;                                                              \
+                                                                               \
+    for (; i + NUMERIC_LANES <= n; i += NUMERIC_LANES) {                       \
+      lo = _mm256_add_epi64(                                                   \
+          lo, widen(_mm_loadu_si128((const __m128i *)(p + i))));               \
+      hi = _mm256_add_epi64(                                                   \
+          hi, widen(_mm_loadu_si128((const __m128i *)(p + i + 4))));           \
+    }                                                                          \
+    _mm256_storeu_si256((__m256i *)r, lo);                                     \
+    _mm256_storeu_si256((__m256i *)(r + 4), hi);                               \
+    for (; i < n; i++) {                                                       \
+      r[i % NUMERIC_LANES] += (ut64_t)p[i];                                    \
+    }                                                                          \
+    sum._u = LANES_REDUCE(r, LANE_ADD);                                        \
+    return (sum);                                                              \
+  }
+
+WIDE_SUM_32(u32, ut32_t, _mm256_cvtepu32_epi64)
+WIDE_SUM_32(i32, st32_t, _mm256_cvtepi32_epi64)
+
+__attribute__((target("avx2"))) static numeric_value_t
+sum_u64_avx2(const void *base, size_t n) {
+  const ut64_t *p = base;
+  __m256i lo = _mm256_setzero_si256();
+  __m256i hi = _mm256_setzero_si256();
+  ut64_t r[NUMERIC_LANES];
+  numeric_value_t sum;
+  size_t i = 0;
+
+  for (; i + NUMERIC_LANES <= n; i += NUMERIC_LANES) {
+    lo = _mm256_add_epi64(lo, _mm256_loadu_si256((const __m256i *)(p + i)));
+    hi = _mm256_add_epi64(hi,
+                          _mm256_loadu_si256((const __m256i *)(p + i + 4)));
+  }
+  _mm256_storeu_si256((__m256i *)r, lo);
+  _mm256_storeu_si256((__m256i *)(r + 4), hi);
+  for (; i < n; i++) {
+    r[i % NUMERIC_LANES] += p[i];
+  }
+  sum._u = LANES_REDUCE(r, LANE_ADD);
+  return (sum);
+}
+
+__attribute__((target("avx2"))) static numeric_value_t
+dot_f32_avx2(const void *a, const void *b, size_t n) {
+  const float *p = a;
+  const float *q = b;
+  __m256 acc = _mm256_setzero_ps();
+  float r[NUMERIC_LANES];
+  numeric_value_t dot;
+  size_t i = 0;
+
+  for (; i + NUMERIC_LANES <= n; i += NUMERIC_LANES) {
+    acc = _mm256_add_ps(
+        acc, _mm256_mul_ps(_mm256_loadu_ps(p + i), _mm256_loadu_ps(q + i)));
+  }
+  _mm256_storeu_ps(r, acc);
+  for (; i < n; i++) {
+    r[i % NUMERIC_LANES] += p[i] * q[i];
+  }
+  dot._f = LANES_REDUCE(r, LANE_ADD);
+  return (dot);
+}
+
+__attribute__((target("avx2"))) static numeric_value_t
+dot_f64_avx2(const void *a, const void *b, size_t n) {
+  const double *p = a;
+  const double *q = b;
+  __m256d lo = _mm256_setzero_pd();
+  __m256d hi = _mm256_setzero_pd();
+  double r[NUMERIC_LANES];
+  numeric_value_t dot;
+  size_t i = 0;
+
+  for (; i + NUMERIC_LANES <= n; i += NUMERIC_LANES) {
+    lo = _mm256_add_pd(
+        lo, _mm256_mul_pd(_mm256_loadu_pd(p + i), _mm256_loadu_pd(q + i)));
+    hi = _mm256_add_pd(hi, _mm256_mul_pd(_mm256_loadu_pd(p + i + 4),
+                                         _mm256_loadu_pd(q + i + 4)));
+  }
+  _mm256_storeu_pd(r, lo);
+  _mm256_storeu_pd(r + 4, hi);
+  for (; i < n; i++) {
+    r[i % NUMERIC_LANES] += p[i] * q[i];
+  }
+  dot._f = LANES_REDUCE(r, LANE_ADD);
+  return (dot);
+}
+
+/* 'min_ps(a, b)' is 'a < b ? a : b' and 'max_ps(a, b)' is 'a > b ? a : b',
+ * NaNs included, just like LANE_MIN and LANE_MAX. */
+__attribute__((target("avx2"))) static void
+minmax_f32_avx2(const void *base, size_t n, numeric_value_t *min,
+                numeric_value_t *max) {
+  const float *p = base;
+  __m256 lo = _mm256_set1_ps(p[0]);
+  __m256 hi = lo;
+  float l[NUMERIC_LANES];
+  float h[NUMERIC_LANES];
+  size_t i = 0;
+
+  for (; i + NUMERIC_LANES <= n; i += NUMERIC_LANES) {
+    __m256 x = _mm256_loadu_ps(p + i);
+
+    lo = _mm256_min_ps(x, lo);
+    hi = _mm256_max_ps(x, hi);
+  }
+  _mm256_storeu_ps(l, lo);
+  _mm256_storeu_ps(h, hi);
+  for (; i < n; i++) {
+    l[i % NUMERIC_LANES] = LANE_MIN(p[i], l[i % NUMERIC_LANES]);
+    h[i % NUMERIC_LANES] = LANE_MAX(p[i], h[i % NUMERIC_LANES]);
+  }
+  min->_f = LANES_REDUCE(l, LANE_MIN);
+  max->_f = LANES_REDUCE(h, LANE_MAX);
+}
+
+__attribute__((target("avx2"))) static void
+minmax_f64_avx2(const void *base, size_t n, numeric_value_t *min,
+                numeric_value_t *max) {
+  const double *p = base;
+  __m256d lo[2] = {_mm256_set1_pd(p[0]), _mm256_set1_pd(p[0])};
+  __m256d hi[2] = {lo[0], lo[0]};
+  double l[NUMERIC_LANES];
+  double h[NUMERIC_LANES];
+  size_t i = 0;
+
+  for (; i + NUMERIC_LANES <= n; i += NUMERIC_LANES) {
+    for (size_t k = 0; k < 2; k++) {
+      __m256d x = _mm256_loadu_pd(p + i + 4 * k);
+
+      lo[k] = _mm256_min_pd(x, lo[k]);
+      hi[k] = _mm256_max_pd(x, hi[k]);
+    }
+  }
+  for (size_t k = 0; k < 2; k++) {
+    _mm256_storeu_pd(l + 4 * k, lo[k]);
+    _mm256_storeu_pd(h + 4 * k, hi[k]);
+  }
+  for (; i < n; i++) {
+    l[i % NUMERIC_LANES] = LANE_MIN(p[i], l[i % NUMERIC_LANES]);
+    h[i % NUMERIC_LANES] = LANE_MAX(p[i], h[i % NUMERIC_LANES]);
+  }
+  min->_f = LANES_REDUCE(l, LANE_MIN);
+  max->_f = LANES_REDUCE(h, LANE_MAX);
+}
+
+/* Integer additions are exact, the 8 sums of a block are computed in
+ * log2(8) shifted additions, then offset by the last sum of the previous
+ * block. Signed and unsigned elements share the same bits. */
+__attribute__((target("avx2"))) static void prefix_32_avx2(void *base,
+                                                           size_t n) {
+  ut32_t *p = base;
+  __m256i carry = _mm256_setzero_si256();
+  size_t i = 0;
+
+  for (; i + NUMERIC_LANES <= n; i += NUMERIC_LANES) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(p + i));
+
+    /* within each half */
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+    /* the last sum of the low half goes to the high half */
+    __m256i t = _mm256_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+
+    x = _mm256_add_epi32(x, _mm256_permute2x128_si256(t, t, 0x08));
+    x = _mm256_add_epi32(x, carry);
+    _mm256_storeu_si256((__m256i *)(p + i), x);
+    carry = _mm256_permutevar8x32_epi32(x, _mm256_set1_epi32(7));
+  }
+
+  ut32_t acc = i ? p[i - 1] : 0;
+
+  for (; i < n; i++) {
+    acc += p[i];
+    p[i] = acc;
+  }
+}
+
+__attribute__((target("avx2"))) static void
+axpy_f32_avx2(void *y, const void *x, size_t n, numeric_value_t a) {
+  float *p = y;
+  const float *q = x;
+  float v = (float)a._f;
+  __m256 splat = _mm256_set1_ps(v);
+  size_t i = 0;
+
+  for (; i + NUMERIC_LANES <= n; i += NUMERIC_LANES) {
+    __m256 ax = _mm256_mul_ps(splat, _mm256_loadu_ps(q + i));
+
+    _mm256_storeu_ps(p + i, _mm256_add_ps(ax, _mm256_loadu_ps(p + i)));
+  }
+  for (; i < n; i++) {
+    p[i] = v * q[i] + p[i];
+  }
+}
+
+__attribute__((target("avx2"))) static void
+axpy_f64_avx2(void *y, const void *x, size_t n, numeric_value_t a) {
+  double *p = y;
+  const double *q = x;
+  double v = a._f;
+  __m256d splat = _mm256_set1_pd(v);
+  size_t i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    __m256d ax = _mm256_mul_pd(splat, _mm256_loadu_pd(q + i));
+
+    _mm256_storeu_pd(p + i, _mm256_add_pd(ax, _mm256_loadu_pd(p + i)));
+  }
+  for (; i < n; i++) {
+    p[i] = v * q[i] + p[i];
+  }
+}
+
+__attribute__((target("avx2"))) static inline void
+axpy_32_avx2(ut32_t *p, const ut32_t *q, size_t n, ut32_t v) {
+  __m256i splat = _mm256_set1_epi32((int)v);
+  size_t i = 0;
+
+  for (; i + NUMERIC_LANES <= n; i += NUMERIC_LANES) {
+    __m256i ax = _mm256_mullo_epi32(
+        splat, _mm256_loadu_si256((const __m256i *)(q + i)));
+
+    _mm256_storeu_si256(
+        (__m256i *)(p + i),
+        _mm256_add_epi32(ax, _mm256_loadu_si256((const __m256i *)(p + i))));
+  }
+  for (; i < n; i++) {
+    p[i] = v * q[i] + p[i];
+  }
+}
+
+__attribute__((target("avx2"))) static void
+axpy_u32_avx2(void *y, const void *x, size_t n, numeric_value_t a) {
+  axpy_32_avx2(y, x, n, (ut32_t)a._u);
+}
+
+__attribute__((target("avx2"))) static void
+axpy_i32_avx2(void *y, const void *x, size_t n, numeric_value_t a) {
+  axpy_32_avx2(y, x, n, (ut32_t)(st32_t)a._i);
+}
+
+#define WIDE_CLAMP(name, type, vec_t, field, lanes, loadu, storeu, set1, vmin, \
+                   vmax)                                                       \
+  __attribute__((target("avx2"))) static void clamp_##name##_avx2(             \
+      void *base, size_t n, numeric_value_t lo, numeric_value_t hi) {          \
+    type *p = base;                                                            \
+    type l = (type)lo.field;                                                   \
+    type h = (type)hi.field;                                                   \
+    vec_t vl = set1(l);                                                        \
+    vec_t vh = set1(h);                                                        \
+    size_t i = 0;                                                              \
+                                                                               \
+    for (; i + (lanes) <= n; i += (lanes)) {                                   \
+      storeu((void *)(p + i), vmin(vmax(loadu((const void *)(p + i)), vl), vh)); \
+    }                                                                          \
+    for (; i < n; i++) {                                                       \
+      type x = LANE_MAX(p[i], l);                                              \
+                                                                               \
+      p[i] = LANE_MIN(x, h);                                                   \
+    }                                                                          \
+  }
+
+static inline __attribute__((target("avx2"))) __m256i
+loadu_si256(const void *p) {
+  return (_mm256_loadu_si256((const __m256i *)p));
+}
+
+static inline __attribute__((target("avx2"))) void storeu_si256(void *p,
+                                                                __m256i x) {
+  _mm256_storeu_si256((__m256i *)p, x);
+}
+
+WIDE_CLAMP(f32, float, __m256, _f, 8, _mm256_loadu_ps, _mm256_storeu_ps,
+           _mm256_set1_ps, _mm256_min_ps, _mm256_max_ps)
+WIDE_CLAMP(f64, double, __m256d, _f, 4, _mm256_loadu_pd, _mm256_storeu_pd,
+           _mm256_set1_pd, _mm256_min_pd, _mm256_max_pd)
+WIDE_CLAMP(u32, ut32_t, __m256i, _u, 8, loadu_si256, storeu_si256,
+           _mm256_set1_epi32, _mm256_min_epu32, _mm256_max_epu32)
+WIDE_CLAMP(i32, st32_t, __m256i, _i, 8, loadu_si256, storeu_si256,
+           _mm256_set1_epi32, _mm256_min_epi32, _mm256_max_epi32)
+
+/* The conversions with a single rounding (or none) the CPU does the same way
+ * as C. */
+#define WIDE_CONVERT(name, dst_t, src_t, load, convert, store)                 \
+  __attribute__((target("avx2"))) static void convert_##name##_avx2(           \
+      void *dst, const void *src, size_t n) {                                  \
+    dst_t *p = dst;                                                            \
+    const src_t *q = src;                                                      \
+    size_t i = 0;                                                              \
+                                                                               \
+    for (; i + 4 <= n; i += 4) {                                               \
+      store((void *)(p + i), convert(load((const void *)(q + i))));            \
+    }                                                                          \
+    for (; i < n; i++) {                                                       \
+      p[i] = (dst_t)q[i];                                                      \
+    }                                                                          \
+  }
+
+static inline __attribute__((target("avx2"))) __m128i
+loadu_si128(const void *p) {
+  return (_mm_loadu_si128((const __m128i *)p));
+}
+
+static inline __attribute__((target("avx2"))) void storeu_si128(void *p,
+                                                                __m128i x) {
+  _mm_storeu_si128((__m128i *)p, x);
+}
+
+WIDE_CONVERT(f32_f64, double, float, _mm_loadu_ps, _mm256_cvtps_pd,
+             _mm256_storeu_pd)
+WIDE_CONVERT(f64_f32, float, double, _mm256_loadu_pd, _mm256_cvtpd_ps,
+             _mm_storeu_ps)
+WIDE_CONVERT(i32_f64, double, st32_t, loadu_si128, _mm256_cvtepi32_pd,
+             _mm256_storeu_pd)
+WIDE_CONVERT(i32_f32, float, st32_t, loadu_si128, _mm_cvtepi32_ps,
+             _mm_storeu_ps)
+WIDE_CONVERT(i32_i64, st64_t, st32_t, loadu_si128, _mm256_cvtepi32_epi64,
+             storeu_si256)
+WIDE_CONVERT(u32_u64, ut64_t, ut32_t, loadu_si128, _mm256_cvtepu32_epi64,
+             storeu_si256)
+
+#endif /* CPU_X86 */
+
+/* Indexed by 'array_key_t'. */
+static sum_kernel_t sum_kernels[6] = {&sum_u32, &sum_i32, &sum_f32,
+                                      &sum_u64, &sum_u64, &sum_f64};
+static dot_kernel_t dot_kernels[6] = {&dot_u32, &dot_i32, &dot_f32,
+                                      &dot_u64, &dot_u64, &dot_f64};
+static minmax_kernel_t minmax_kernels[6] = {&minmax_u32, &minmax_i32,
+                                            &minmax_f32, &minmax_u64,
+                                            &minmax_i64, &minmax_f64};
+static prefix_kernel_t prefix_kernels[6] = {&prefix_u32, &prefix_i32,
+                                            &prefix_f32, &prefix_u64,
+                                            &prefix_i64, &prefix_f64};
+static axpy_kernel_t axpy_kernels[6] = {&axpy_u32, &axpy_i32, &axpy_f32,
+                                        &axpy_u64, &axpy_i64, &axpy_f64};
+static clamp_kernel_t clamp_kernels[6] = {&clamp_u32, &clamp_i32, &clamp_f32,
+                                          &clamp_u64, &clamp_i64, &clamp_f64};
+/* Indexed by the source then the destination, NULL for the scalar loop. */
+static convert_kernel_t convert_kernels[6][6];
+
+__attribute__((constructor)) static void numeric_select_kernels(void) {
+#ifdef CPU_X86
+  if (cpu_features() & CPU_AVX2) {
+    sum_kernels[ARRAY_KEY_U32] = &sum_u32_avx2;
+    sum_kernels[ARRAY_KEY_I32] = &sum_i32_avx2;
+    sum_kernels[ARRAY_KEY_F32] = &sum_f32_avx2;
+    sum_kernels[ARRAY_KEY_U64] = &sum_u64_avx2;
+    sum_kernels[ARRAY_KEY_I64] = &sum_u64_avx2;
+    sum_kernels[ARRAY_KEY_F64] = &sum_f64_avx2;
+    dot_kernels[ARRAY_KEY_F32] = &dot_f32_avx2;
+    dot_kernels[ARRAY_KEY_F64] = &dot_f64_avx2;
+    minmax_kernels[ARRAY_KEY_F32] = &minmax_f32_avx2;
+    minmax_kernels[ARRAY_KEY_F64] = &minmax_f64_avx2;
+    prefix_kernels[ARRAY_KEY_U32] = &prefix_32_avx2;
+    prefix_kernels[ARRAY_KEY_I32] = &prefix_32_avx2;
+    axpy_kernels[ARRAY_KEY_U32] = &axpy_u32_avx2;
+    axpy_kernels[ARRAY_KEY_I32] = &axpy_i32_avx2;
+    axpy_kernels[ARRAY_KEY_F32] = &axpy_f32_avx2;
+    axpy_kernels[ARRAY_KEY_F64] = &axpy_f64_avx2;
+    clamp_kernels[ARRAY_KEY_U32] = &clamp_u32_avx2;
+    clamp_kernels[ARRAY_KEY_I32] = &clamp_i32_avx2;
+    clamp_kernels[ARRAY_KEY_F32] = &clamp_f32_avx2;
+    clamp_kernels[ARRAY_KEY_F64] = &clamp_f64_avx2;
+    convert_kernels[ARRAY_KEY_F32][ARRAY_KEY_F64] = &convert_f32_f64_avx2;
+    convert_kernels[ARRAY_KEY_F64][ARRAY_KEY_F32] = &convert_f64_f32_avx2;
+    convert_kernels[ARRAY_KEY_I32][ARRAY_KEY_F64] = &convert_i32_f64_avx2;
+    convert_kernels[ARRAY_KEY_I32][ARRAY_KEY_F32] = &convert_i32_f32_avx2;
+    convert_kernels[ARRAY_KEY_I32][ARRAY_KEY_I64] = &convert_i32_i64_avx2;
+    convert_kernels[ARRAY_KEY_U32][ARRAY_KEY_U64] = &convert_u32_u64_avx2;
+  }
+#endif
+}
+
+/* API */
+
+numeric_value_t numeric_sum(const array_t *self, array_key_t type) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(_typesize(self) != key_width(type));
+
+  return (sum_kernels[type](_data(self), _size(self)));
+}
+
+numeric_value_t numeric_dot(const array_t *a, const array_t *b,
+                            array_key_t type) {
+  HR_COMPLAIN_IF(a == NULL);
+  HR_COMPLAIN_IF(b == NULL);
+  HR_COMPLAIN_IF(_typesize(a) != key_width(type));
+  HR_COMPLAIN_IF(_typesize(b) != key_width(type));
+  HR_COMPLAIN_IF(_size(a) != _size(b));
+
+  return (dot_kernels[type](_data(a), _data(b), _size(a)));
+}
+
+bool numeric_minmax(const array_t *self, array_key_t type,
+                    numeric_value_t *min, numeric_value_t *max) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(_typesize(self) != key_width(type));
+
+  numeric_value_t lo;
+  numeric_value_t hi;
+
+  if (unlikely(!_size(self))) {
+    return (false);
+  }
+
+  minmax_kernels[type](_data(self), _size(self), &lo, &hi);
+  if (min) {
+    *min = lo;
+  }
+  if (max) {
+    *max = hi;
+  }
+
+  return (true);
+}
+
+void numeric_prefix_sum(array_t *self, array_key_t type) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(_typesize(self) != key_width(type));
+
+  prefix_kernels[type](_data(self), _size(self));
+}
+
+void numeric_axpy(array_t *y, numeric_value_t a, const array_t *x,
+                  array_key_t type) {
+  HR_COMPLAIN_IF(y == NULL);
+  HR_COMPLAIN_IF(x == NULL);
+  HR_COMPLAIN_IF(_typesize(y) != key_width(type));
+  HR_COMPLAIN_IF(_typesize(x) != key_width(type));
+  HR_COMPLAIN_IF(_size(y) != _size(x));
+
+  axpy_kernels[type](_data(y), _data(x), _size(y), a);
+}
+
+void numeric_clamp(array_t *self, array_key_t type, numeric_value_t lo,
+                   numeric_value_t hi) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(_typesize(self) != key_width(type));
+
+  clamp_kernels[type](_data(self), _size(self), lo, hi);
+}
+
+array_t *numeric_convert(const array_t *self, array_key_t from,
+                         array_key_t to) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(_typesize(self) != key_width(from));
+
+  array_t *array = array_create_with_allocator(
+      _allocator(self), key_width(to), _size(self), NULL);
+
+  if (unlikely(!array)) {
+    return (NULL);
+  }
+
+  if (from == to) {
+    (void)builtin_memcpy(_data(array), _data(self),
+                         _size(self) * _typesize(self));
+  } else if (convert_kernels[from][to]) {
+    convert_kernels[from][to](_data(array), _data(self), _size(self));
+  } else {
+    convert_scalar(_data(array), to, _data(self), from, _size(self));
+  }
+  _size(array) = _size(self);
+
+  return (array);
+}
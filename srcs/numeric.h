@@ -0,0 +1,74 @@
+#ifndef __NUMERIC_H__
+#define __NUMERIC_H__
+
+#include "array.h"
+#include "array_sort.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Numeric kernels over arrays of numbers, whose element type is given by the
+ * same tag the radix sort uses ('array_key_t'). The element size of the
+ * array must match the tag. The wide versions (AVX2) are picked once at
+ * startup from the features of the CPU the library runs on.
+ *
+ * Every kernel gives the same bits whichever version runs: integers wrap
+ * around, and floating-point numbers are added in a fixed order. The
+ * reductions ('sum', 'dot', 'minmax') fold element 'i' into partial result
+ * 'i % 8', then combine the 8 partial results pairwise:
+ * ((r0 . r4) . (r2 . r6)) . ((r1 . r5) . (r3 . r7)).
+ */
+
+/* A scalar argument or result: '_i' for the signed integer types, '_u' for
+ * the unsigned ones and '_f' for the floating-point ones.
+ */
+typedef union {
+  int64_t _i;
+  uint64_t _u;
+  double _f;
+} numeric_value_t;
+
+/* Returns the sum of the elements. Integers are summed on 64 bits, floats
+ * on 32 bits.
+ */
+numeric_value_t numeric_sum(const array_t *self, array_key_t type);
+
+/* Returns the sum of the products of the elements of 'a' and 'b', which must
+ * have the same size. Integer products are computed on 64 bits.
+ */
+numeric_value_t numeric_dot(const array_t *a, const array_t *b,
+                            array_key_t type);
+
+/* Stores the smallest and the largest elements into 'min' and 'max' (either
+ * may be NULL). A NaN is never kept over a number it is compared to, unless
+ * it is the first element. Returns false if the array is empty.
+ */
+bool numeric_minmax(const array_t *self, array_key_t type,
+                    numeric_value_t *min, numeric_value_t *max);
+
+/* Replaces every element with the sum of the elements up to it, included.
+ * Floating-point numbers are added one after the other.
+ */
+void numeric_prefix_sum(array_t *self, array_key_t type);
+
+/* Adds 'a' times the element of 'x' to each element of 'y', which must have
+ * the same size ('a' is converted to the element type first).
+ */
+void numeric_axpy(array_t *y, numeric_value_t a, const array_t *x,
+                  array_key_t type);
+
+/* Clamps every element between 'lo' and 'hi' (converted to the element type
+ * first). A NaN becomes 'lo'.
+ */
+void numeric_clamp(array_t *self, array_key_t type, numeric_value_t lo,
+                   numeric_value_t hi);
+
+/* Creates a new array holding the elements converted from 'from' to 'to',
+ * as a C cast would. Floating-point numbers out of the range of an integer
+ * type have no defined result.
+ */
+array_t *numeric_convert(const array_t *self, array_key_t from,
+                         array_key_t to);
+
+#endif /* __NUMERIC_H__ */
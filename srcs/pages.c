@@ -0,0 +1,130 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* mremap */
+#endif
+
+#include "pages.h"
+#include "internal.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+static inline void pages_advise(void *ptr, size_t size) {
+#if defined(MADV_HUGEPAGE) && !defined(DISABLE_TRANSPARENT_HUGEPAGES)
+  (void)madvise(ptr, size, MADV_HUGEPAGE);
+#else
+  (void)ptr;
+  (void)size;
+#endif
+}
+
+size_t pages_size(void) {
+  static atomic_size_t cached = 0;
+  size_t size = atomic_load_explicit(&cached, memory_order_relaxed);
+
+  /* 16 KiB on Apple Silicon, 4 KiB on most other systems. */
+  if (unlikely(!size)) {
+    long page = sysconf(_SC_PAGESIZE);
+
+    size = page > 0 ? (size_t)page : 4096;
+    atomic_store_explicit(&cached, size, memory_order_relaxed);
+  }
+
+  return (size);
+}
+
+void *pages_map(size_t size) {
+  HR_COMPLAIN_IF(size % ARRAY_PAGE_SIZE != 0);
+
+  void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (unlikely(ptr == MAP_FAILED)) {
+    return (NULL);
+  }
+
+  pages_advise(ptr, size);
+
+  return (ptr);
+}
+
+void *pages_remap(void *ptr, size_t old_size, size_t new_size) {
+  HR_COMPLAIN_IF(ptr == NULL);
+  HR_COMPLAIN_IF(old_size % ARRAY_PAGE_SIZE != 0);
+  HR_COMPLAIN_IF(new_size % ARRAY_PAGE_SIZE != 0);
+
+  if (new_size <= old_size) {
+    if (new_size < old_size) {
+      (void)munmap((char *)ptr + new_size, old_size - new_size);
+    }
+    return (ptr);
+  }
+
+#if defined(__linux__)
+  void *new_ptr = mremap(ptr, old_size, new_size, MREMAP_MAYMOVE);
+
+  if (unlikely(new_ptr == MAP_FAILED)) {
+    return (NULL);
+  }
+#else
+  void *new_ptr = pages_map(new_size);
+
+  if (unlikely(!new_ptr)) {
+    return (NULL);
+  }
+
+  (void)builtin_memcpy(new_ptr, ptr, old_size);
+  pages_unmap(ptr, old_size);
+#endif
+
+  return (new_ptr);
+}
+
+void *pages_map_file(int fd, size_t size, bool writable) {
+  HR_COMPLAIN_IF(fd < 0);
+
+  void *ptr = mmap(NULL, size, PROT_READ | (writable ? PROT_WRITE : 0),
+                   MAP_SHARED, fd, 0);
+
+  if (unlikely(ptr == MAP_FAILED)) {
+    return (NULL);
+  }
+
+  return (ptr);
+}
+
+void *pages_remap_file(int fd, void *ptr, size_t old_size, size_t new_size) {
+  HR_COMPLAIN_IF(fd < 0);
+  HR_COMPLAIN_IF(ptr == NULL);
+  HR_COMPLAIN_IF(old_size % ARRAY_PAGE_SIZE != 0);
+  HR_COMPLAIN_IF(new_size % ARRAY_PAGE_SIZE != 0);
+
+  if (new_size <= old_size) {
+    return (pages_remap(ptr, old_size, new_size));
+  }
+
+#if defined(__linux__)
+  (void)fd;
+  return (pages_remap(ptr, old_size, new_size));
+#else
+  /* The pages belong to the file, nothing is lost by mapping it again. */
+  void *new_ptr = pages_map_file(fd, new_size, true);
+
+  if (likely(new_ptr)) {
+    pages_unmap(ptr, old_size);
+  }
+
+  return (new_ptr);
+#endif
+}
+
+void pages_unmap(void *ptr, size_t size) {
+  HR_COMPLAIN_IF(ptr == NULL);
+
+  (void)munmap(ptr, size);
+}
@@ -0,0 +1,45 @@
+#ifndef __PAGES_H__
+#define __PAGES_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Thin layer over the virtual memory of the system, used by the containers
+ * to hold buffers that are too large for the heap. All sizes must be
+ * multiples of ARRAY_PAGE_SIZE.
+ */
+
+/* Returns the size of a page of the system, asked for once and cached.
+ */
+size_t pages_size(void);
+
+#define ARRAY_PAGE_SIZE (pages_size())
+
+/* Maps 'size' bytes of zeroed anonymous memory, or returns NULL. Unless
+ * DISABLE_TRANSPARENT_HUGEPAGES is defined, the mapping is eligible for
+ * transparent huge pages where the system supports them.
+ */
+void *pages_map(size_t size);
+
+/* Resizes the mapping at 'ptr' from 'old_size' to 'new_size' bytes, moving
+ * it if needed. The content is preserved up to the smallest of both sizes.
+ * Grows without copying where mremap(2) is available. On failure, NULL is
+ * returned and the mapping is untouched.
+ */
+void *pages_remap(void *ptr, size_t old_size, size_t new_size);
+
+/* Maps the first 'size' bytes of the file 'fd' as shared memory, writable
+ * or not, or returns NULL.
+ */
+void *pages_map_file(int fd, size_t size, bool writable);
+
+/* Same as 'remap', for a writable mapping of the file 'fd', which must
+ * already be at least 'new_size' bytes long.
+ */
+void *pages_remap_file(int fd, void *ptr, size_t old_size, size_t new_size);
+
+/* Unmaps the 'size' bytes mapped at 'ptr'.
+ */
+void pages_unmap(void *ptr, size_t size);
+
+#endif /* __PAGES_H__ */
@@ -0,0 +1,148 @@
+#include "pool.h"
+#include "internal.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static void pool_work(pool_job_t *job) {
+  size_t task;
+
+  while ((task = atomic_fetch_add_explicit(&job->_next, 1,
+                                           memory_order_relaxed)) <
+         job->_ntasks) {
+    job->_fn(job->_ctx, task);
+  }
+}
+
+static void *pool_worker(void *arg) {
+  pool_t *self = arg;
+  size_t seen = 0;
+
+  pthread_mutex_lock(&self->_lock);
+  for (;;) {
+    while (!self->_stop && self->_generation == seen) {
+      pthread_cond_wait(&self->_wake, &self->_lock);
+    }
+    if (self->_stop) {
+      break;
+    }
+
+    seen = self->_generation;
+    pool_job_t *job = self->_job;
+
+    pthread_mutex_unlock(&self->_lock);
+    pool_work(job);
+    pthread_mutex_lock(&self->_lock);
+
+    if (--self->_busy == 0) {
+      pthread_cond_signal(&self->_done);
+    }
+  }
+  pthread_mutex_unlock(&self->_lock);
+
+  return (NULL);
+}
+
+pool_t *pool_create(size_t nthreads) {
+  if (nthreads == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+
+    nthreads = online > 0 ? (size_t)online : 1;
+  }
+
+  pool_t *self = malloc(sizeof(*self));
+
+  if (unlikely(!self)) {
+    return (NULL);
+  }
+
+  (void)builtin_memset(self, 0x00, sizeof(*self));
+  self->_threads = malloc(sizeof(*self->_threads) * nthreads);
+
+  if (unlikely(!self->_threads)) {
+    free(self);
+    return (NULL);
+  }
+
+  pthread_mutex_init(&self->_run, NULL);
+  pthread_mutex_init(&self->_lock, NULL);
+  pthread_cond_init(&self->_wake, NULL);
+  pthread_cond_init(&self->_done, NULL);
+
+  /* the calling thread is the last one */
+  for (size_t i = 0; i < nthreads - 1; i++) {
+    if (unlikely(pthread_create(&self->_threads[i], NULL, &pool_worker,
+                                self) != 0)) {
+      break;
+    }
+    self->_nthreads++;
+  }
+
+  return (self);
+}
+
+void pool_kill(pool_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  pthread_mutex_lock(&self->_lock);
+  self->_stop = true;
+  pthread_cond_broadcast(&self->_wake);
+  pthread_mutex_unlock(&self->_lock);
+
+  for (size_t i = 0; i < self->_nthreads; i++) {
+    pthread_join(self->_threads[i], NULL);
+  }
+
+  pthread_cond_destroy(&self->_done);
+  pthread_cond_destroy(&self->_wake);
+  pthread_mutex_destroy(&self->_lock);
+  pthread_mutex_destroy(&self->_run);
+  free(self->_threads);
+  free(self);
+}
+
+__attr_pure size_t pool_size(const pool_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (self->_nthreads + 1);
+}
+
+void pool_run(pool_t *self, size_t ntasks, void (*fn)(void *, size_t),
+              void *ctx) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(fn == NULL);
+
+  pool_job_t job = {._fn = fn, ._ctx = ctx, ._ntasks = ntasks};
+
+  atomic_init(&job._next, 0);
+
+  /* Not worth waking anybody up */
+  if (ntasks <= 1 || self->_nthreads == 0) {
+    pool_work(&job);
+    return;
+  }
+
+  pthread_mutex_lock(&self->_run);
+
+  pthread_mutex_lock(&self->_lock);
+  self->_job = &job;
+  self->_generation++;
+  self->_busy = self->_nthreads;
+  pthread_cond_broadcast(&self->_wake);
+  pthread_mutex_unlock(&self->_lock);
+
+  pool_work(&job);
+
+  /* The job lives on this stack, wait until no worker can touch it */
+  pthread_mutex_lock(&self->_lock);
+  while (self->_busy) {
+    pthread_cond_wait(&self->_done, &self->_lock);
+  }
+  self->_job = NULL;
+  pthread_mutex_unlock(&self->_lock);
+
+  pthread_mutex_unlock(&self->_run);
+}
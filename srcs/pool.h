@@ -0,0 +1,61 @@
+#ifndef __POOL_H__
+#define __POOL_H__
+
+#include "internal.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* A job split into '_ntasks' tasks, each one being a call to
+ * '_fn(_ctx, task)'.
+ */
+typedef struct {
+  void (*_fn)(void *, size_t);
+  void *_ctx;
+  size_t _ntasks;
+  atomic_size_t _next; /* The next task to be claimed */
+} pool_job_t;
+
+/* A fixed set of worker threads running one job at a time. The threads
+ * claim the tasks of the current job one after the other, so a worker that
+ * is done with a cheap task goes on with the next one while the others are
+ * still busy.
+ */
+typedef struct {
+  pthread_t *_threads;
+  size_t _nthreads; /* The number of worker threads */
+
+  pthread_mutex_t _run; /* Serializes the calls to 'pool_run' */
+  pthread_mutex_t _lock;
+  pthread_cond_t _wake; /* Signals a new job (or the end of the pool) */
+  pthread_cond_t _done; /* Signals that every worker left the job */
+
+  pool_job_t *_job;   /* The job being run */
+  size_t _generation; /* Incremented for every job */
+  size_t _busy;       /* The number of workers still on the job */
+  bool _stop;
+} pool_t;
+
+/* Creates a pool of 'nthreads' threads (counting the thread that calls
+ * 'pool_run'), or as many as there are online CPUs if 'nthreads' is 0.
+ */
+pool_t *pool_create(size_t nthreads);
+
+/* Stops and joins the workers, then frees the pool.
+ */
+void pool_kill(pool_t *self);
+
+/* Returns the number of threads running the jobs, the caller included.
+ */
+__attr_pure size_t pool_size(const pool_t *self);
+
+/* Runs 'fn(ctx, task)' for every task in [0, ntasks), on the workers and on
+ * the calling thread, then returns once they are all done. The tasks are
+ * started in increasing order. 'fn' must not call 'pool_run' on the same
+ * pool.
+ */
+void pool_run(pool_t *self, size_t ntasks, void (*fn)(void *, size_t),
+              void *ctx);
+
+#endif /* __POOL_H__ */
@@ -0,0 +1,385 @@
+#include "queue.h"
+#include "internal.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static inline size_t round_pow2(size_t n) {
+  size_t p = 1;
+
+  while (p < n) {
+    p <<= 1;
+  }
+  return (p);
+}
+
+static inline bool is_pow2(size_t n) { return (n && !(n & (n - 1))); }
+
+/* Copies 'n' elements from 'src' into the ring starting at position 'pos',
+ * in at most two runs.
+ */
+static inline void ring_copy_in(void *ptr, size_t cap, size_t elt_size,
+                                size_t pos, const void *src, size_t n) {
+  size_t slot = pos & (cap - 1);
+  size_t first = MIN(n, cap - slot);
+
+  (void)builtin_memcpy((char *)ptr + slot * elt_size, src, first * elt_size);
+  if (first < n) {
+    (void)builtin_memcpy(ptr, (const char *)src + first * elt_size,
+                         (n - first) * elt_size);
+  }
+}
+
+static inline void ring_copy_out(const void *ptr, size_t cap, size_t elt_size,
+                                 size_t pos, void *into, size_t n) {
+  size_t slot = pos & (cap - 1);
+  size_t first = MIN(n, cap - slot);
+
+  (void)builtin_memcpy(into, (const char *)ptr + slot * elt_size,
+                       first * elt_size);
+  if (first < n) {
+    (void)builtin_memcpy((char *)into + first * elt_size, ptr,
+                         (n - first) * elt_size);
+  }
+}
+
+/* SPSC */
+
+static spsc_queue_t *spsc_queue_init(const array_allocator_t *allocator,
+                                     void *buffer, size_t elt_size,
+                                     size_t cap, bool is_owner) {
+  spsc_queue_t *self = _allocator_alloc(allocator, sizeof(*self));
+
+  if (unlikely(!self)) {
+    return (NULL);
+  }
+
+  (void)builtin_memset(self, 0x00, sizeof(*self));
+  self->_ptr = buffer;
+  self->_cap = cap;
+  self->_elt_size = elt_size;
+  self->_is_owner = is_owner;
+  self->_allocator = allocator;
+  atomic_init(&self->_head, 0);
+  atomic_init(&self->_tail, 0);
+
+  return (self);
+}
+
+spsc_queue_t *spsc_queue_create(size_t elt_size, size_t n) {
+  return (spsc_queue_create_with_allocator(&__array_allocator__, elt_size, n));
+}
+
+spsc_queue_t *spsc_queue_create_with_allocator(
+    const array_allocator_t *allocator, size_t elt_size, size_t n) {
+  HR_COMPLAIN_IF(allocator == NULL);
+  HR_COMPLAIN_IF(elt_size == 0);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(elt_size, n) == false);
+
+  size_t cap = round_pow2(n ? n : ARRAY_INITIAL_SIZE);
+  void *buffer = _allocator_alloc(allocator, cap * elt_size);
+
+  if (unlikely(!buffer)) {
+    return (NULL);
+  }
+
+  spsc_queue_t *self =
+      spsc_queue_init(allocator, buffer, elt_size, cap, true);
+
+  if (unlikely(!self)) {
+    _allocator_free(allocator, buffer);
+  }
+
+  return (self);
+}
+
+spsc_queue_t *spsc_queue_borrow_buffer(void *buffer, size_t elt_size,
+                                       size_t n) {
+  HR_COMPLAIN_IF(buffer == NULL);
+  HR_COMPLAIN_IF(elt_size == 0);
+  HR_COMPLAIN_IF(is_pow2(n) == false);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(elt_size, n) == false);
+
+  return (spsc_queue_init(&__array_allocator__, buffer, elt_size, n, false));
+}
+
+void spsc_queue_kill(spsc_queue_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  if (self->_is_owner) {
+    _allocator_free(self->_allocator, self->_ptr);
+  }
+  _allocator_free(self->_allocator, self);
+}
+
+bool spsc_queue_push(spsc_queue_t *self, const void *e) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(e == NULL);
+
+  return (spsc_queue_push_batch(self, e, 1) == 1);
+}
+
+bool spsc_queue_pop(spsc_queue_t *self, void *into) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (spsc_queue_pop_batch(self, into, 1) == 1);
+}
+
+size_t spsc_queue_push_batch(spsc_queue_t *self, const void *src, size_t n) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(src == NULL && n);
+
+  size_t tail = atomic_load_explicit(&self->_tail, memory_order_relaxed);
+  size_t room = self->_cap - (tail - self->_head_cache);
+
+  if (room < n) {
+    /* Only look at the consumer's cache line when the cached view says the
+     * queue is too full. */
+    self->_head_cache =
+        atomic_load_explicit(&self->_head, memory_order_acquire);
+    room = self->_cap - (tail - self->_head_cache);
+  }
+
+  n = MIN(n, room);
+  if (unlikely(n == 0)) {
+    return (0);
+  }
+
+  ring_copy_in(self->_ptr, self->_cap, self->_elt_size, tail, src, n);
+  atomic_store_explicit(&self->_tail, tail + n, memory_order_release);
+
+  return (n);
+}
+
+size_t spsc_queue_pop_batch(spsc_queue_t *self, void *into, size_t n) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  size_t head = atomic_load_explicit(&self->_head, memory_order_relaxed);
+  size_t avail = self->_tail_cache - head;
+
+  if (avail < n) {
+    self->_tail_cache =
+        atomic_load_explicit(&self->_tail, memory_order_acquire);
+    avail = self->_tail_cache - head;
+  }
+
+  n = MIN(n, avail);
+  if (unlikely(n == 0)) {
+    return (0);
+  }
+
+  if (into) {
+    ring_copy_out(self->_ptr, self->_cap, self->_elt_size, head, into, n);
+  }
+  atomic_store_explicit(&self->_head, head + n, memory_order_release);
+
+  return (n);
+}
+
+size_t spsc_queue_size(spsc_queue_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  size_t head = atomic_load_explicit(&self->_head, memory_order_acquire);
+  size_t tail = atomic_load_explicit(&self->_tail, memory_order_acquire);
+
+  return (tail - head);
+}
+
+/* MPMC */
+
+static mpmc_queue_t *mpmc_queue_init(const array_allocator_t *allocator,
+                                     void *buffer, size_t elt_size,
+                                     size_t cap, bool is_owner) {
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(sizeof(atomic_size_t), cap) == false);
+
+  mpmc_queue_t *self = _allocator_alloc(allocator, sizeof(*self));
+
+  if (unlikely(!self)) {
+    return (NULL);
+  }
+
+  (void)builtin_memset(self, 0x00, sizeof(*self));
+  self->_seq = _allocator_alloc(allocator, sizeof(atomic_size_t) * cap);
+
+  if (unlikely(!self->_seq)) {
+    _allocator_free(allocator, self);
+    return (NULL);
+  }
+
+  /* slot 'i' is ready to be written for position 'i' */
+  for (size_t i = 0; i < cap; i++) {
+    atomic_init(&self->_seq[i], i);
+  }
+
+  self->_ptr = buffer;
+  self->_cap = cap;
+  self->_elt_size = elt_size;
+  self->_is_owner = is_owner;
+  self->_allocator = allocator;
+  atomic_init(&self->_head, 0);
+  atomic_init(&self->_tail, 0);
+
+  return (self);
+}
+
+mpmc_queue_t *mpmc_queue_create(size_t elt_size, size_t n) {
+  return (mpmc_queue_create_with_allocator(&__array_allocator__, elt_size, n));
+}
+
+mpmc_queue_t *mpmc_queue_create_with_allocator(
+    const array_allocator_t *allocator, size_t elt_size, size_t n) {
+  HR_COMPLAIN_IF(allocator == NULL);
+  HR_COMPLAIN_IF(elt_size == 0);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(elt_size, n) == false);
+
+  /* with a single slot, a freed slot would look ready to be read */
+  size_t cap = round_pow2(n ? MAX(n, 2) : ARRAY_INITIAL_SIZE);
+  void *buffer = _allocator_alloc(allocator, cap * elt_size);
+
+  if (unlikely(!buffer)) {
+    return (NULL);
+  }
+
+  mpmc_queue_t *self =
+      mpmc_queue_init(allocator, buffer, elt_size, cap, true);
+
+  if (unlikely(!self)) {
+    _allocator_free(allocator, buffer);
+  }
+
+  return (self);
+}
+
+mpmc_queue_t *mpmc_queue_borrow_buffer(void *buffer, size_t elt_size,
+                                       size_t n) {
+  HR_COMPLAIN_IF(buffer == NULL);
+  HR_COMPLAIN_IF(elt_size == 0);
+  HR_COMPLAIN_IF(is_pow2(n) == false || n < 2);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_MUL(elt_size, n) == false);
+
+  return (mpmc_queue_init(&__array_allocator__, buffer, elt_size, n, false));
+}
+
+void mpmc_queue_kill(mpmc_queue_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  if (self->_is_owner) {
+    _allocator_free(self->_allocator, self->_ptr);
+  }
+  _allocator_free(self->_allocator, self->_seq);
+  _allocator_free(self->_allocator, self);
+}
+
+bool mpmc_queue_push(mpmc_queue_t *self, const void *e) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(e == NULL);
+
+  return (mpmc_queue_push_batch(self, e, 1) == 1);
+}
+
+bool mpmc_queue_pop(mpmc_queue_t *self, void *into) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (mpmc_queue_pop_batch(self, into, 1) == 1);
+}
+
+/* Claims up to 'n' positions from '*counter', 'lag' being the distance
+ * between a position and the sequence number its slot holds when it is ready
+ * (0 for producers, 1 for consumers). Returns the number of positions
+ * claimed, the first one being stored in 'pos'.
+ */
+static size_t mpmc_queue_claim(mpmc_queue_t *self, atomic_size_t *counter,
+                               size_t lag, size_t n, size_t *pos) {
+  size_t mask = self->_cap - 1;
+
+  *pos = atomic_load_explicit(counter, memory_order_relaxed);
+
+  for (;;) {
+    size_t k = 0;
+    intptr_t diff = 0;
+
+    while (k < n && k < self->_cap) {
+      size_t seq = atomic_load_explicit(&self->_seq[(*pos + k) & mask],
+                                        memory_order_acquire);
+
+      diff = (intptr_t)(seq - (*pos + k + lag));
+      if (diff != 0) {
+        break;
+      }
+      k++;
+    }
+
+    if (k == 0) {
+      if (diff < 0) {
+        return (0); /* full (or empty for consumers) */
+      }
+      /* another thread took this position already */
+      *pos = atomic_load_explicit(counter, memory_order_relaxed);
+      continue;
+    }
+
+    /* the slots checked above can only change hands through the counter,
+     * so they are still ready if nobody moved it */
+    if (atomic_compare_exchange_weak_explicit(counter, pos, *pos + k,
+                                              memory_order_relaxed,
+                                              memory_order_relaxed)) {
+      return (k);
+    }
+  }
+}
+
+size_t mpmc_queue_push_batch(mpmc_queue_t *self, const void *src, size_t n) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(src == NULL && n);
+
+  size_t pos;
+
+  if (unlikely(n == 0)) {
+    return (0);
+  }
+
+  n = mpmc_queue_claim(self, &self->_tail, 0, n, &pos);
+  if (n) {
+    ring_copy_in(self->_ptr, self->_cap, self->_elt_size, pos, src, n);
+    for (size_t i = 0; i < n; i++) {
+      atomic_store_explicit(&self->_seq[(pos + i) & (self->_cap - 1)],
+                            pos + i + 1, memory_order_release);
+    }
+  }
+
+  return (n);
+}
+
+size_t mpmc_queue_pop_batch(mpmc_queue_t *self, void *into, size_t n) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  size_t pos;
+
+  if (unlikely(n == 0)) {
+    return (0);
+  }
+
+  n = mpmc_queue_claim(self, &self->_head, 1, n, &pos);
+  if (n) {
+    if (into) {
+      ring_copy_out(self->_ptr, self->_cap, self->_elt_size, pos, into, n);
+    }
+    /* the slot becomes writable for the position one lap ahead */
+    for (size_t i = 0; i < n; i++) {
+      atomic_store_explicit(&self->_seq[(pos + i) & (self->_cap - 1)],
+                            pos + i + self->_cap, memory_order_release);
+    }
+  }
+
+  return (n);
+}
+
+size_t mpmc_queue_size(mpmc_queue_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  size_t head = atomic_load_explicit(&self->_head, memory_order_acquire);
+  size_t tail = atomic_load_explicit(&self->_tail, memory_order_acquire);
+
+  return (MIN(tail - head, self->_cap));
+}
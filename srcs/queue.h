@@ -0,0 +1,145 @@
+#ifndef __QUEUE_H__
+#define __QUEUE_H__
+
+#include "array.h"
+#include "internal.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Bounded lock-free queues of fixed-size elements. Elements are copied in
+ * and out '_elt_size' bytes at a time, just like 'array_push'/'array_pop'.
+ * The number of slots is always a power of 2, and the queues never grow:
+ * pushing into a full queue fails instead.
+ *
+ * The consumer side ('_head') and the producer side ('_tail') live on their
+ * own cache lines so that producers and consumers don't invalidate each
+ * other's line on every operation.
+ */
+
+/* A single-producer single-consumer ring: one thread may push while another
+ * one pops, without any read-modify-write operation.
+ */
+typedef struct {
+  void *_ptr;       /* A pointer to the start of the buffer */
+  size_t _cap;      /* The number of slots in the buffer (a power of 2) */
+  size_t _elt_size; /* The size of one element (in bytes) */
+  bool _is_owner;   /* Is the buffer freed with the queue */
+
+  const array_allocator_t *_allocator; /* Allocator of the queue (and of its
+                                        * buffer if owned) */
+
+  char _pad0[ARRAY_CACHE_LINE_SIZE];
+
+  atomic_size_t _head; /* The next slot to pop, written by the consumer */
+  size_t _tail_cache;  /* The consumer's last view of '_tail' */
+
+  char _pad1[ARRAY_CACHE_LINE_SIZE - sizeof(size_t) * 2];
+
+  atomic_size_t _tail; /* The next slot to push, written by the producer */
+  size_t _head_cache;  /* The producer's last view of '_head' */
+
+  char _pad2[ARRAY_CACHE_LINE_SIZE - sizeof(size_t) * 2];
+} spsc_queue_t;
+
+/* A multi-producer multi-consumer ring (Dmitry Vyukov's bounded queue):
+ * every slot carries a sequence number telling whether it is ready to be
+ * written or read for the current lap, so threads only contend on the
+ * position counters.
+ */
+typedef struct {
+  void *_ptr;          /* A pointer to the start of the buffer */
+  atomic_size_t *_seq; /* The sequence number of each slot */
+  size_t _cap;         /* The number of slots in the buffer (a power of 2) */
+  size_t _elt_size;    /* The size of one element (in bytes) */
+  bool _is_owner;      /* Is the buffer freed with the queue */
+
+  const array_allocator_t *_allocator; /* Allocator of the queue, of the
+                                        * sequence numbers (and of the
+                                        * buffer if owned) */
+
+  char _pad0[ARRAY_CACHE_LINE_SIZE];
+
+  atomic_size_t _head; /* The next position to pop */
+
+  char _pad1[ARRAY_CACHE_LINE_SIZE - sizeof(size_t)];
+
+  atomic_size_t _tail; /* The next position to push */
+
+  char _pad2[ARRAY_CACHE_LINE_SIZE - sizeof(size_t)];
+} mpmc_queue_t;
+
+/* Creates a queue with room for at least 'n' elements.
+ */
+spsc_queue_t *spsc_queue_create(size_t elt_size, size_t n);
+
+spsc_queue_t *spsc_queue_create_with_allocator(
+    const array_allocator_t *allocator, size_t elt_size, size_t n);
+
+/* Creates a queue on top of 'buffer' which holds 'n' slots of 'elt_size'
+ * bytes, 'n' being a power of 2. As with 'array_borrow_buffer' the buffer
+ * is never freed by the queue.
+ */
+spsc_queue_t *spsc_queue_borrow_buffer(void *buffer, size_t elt_size,
+                                       size_t n);
+
+/* Frees the queue (and its buffer if owned). Must not race with any other
+ * operation.
+ */
+void spsc_queue_kill(spsc_queue_t *self);
+
+/* Producer side: adds a copy of the element pointed to by 'e'. Returns
+ * false if the queue is full.
+ */
+bool spsc_queue_push(spsc_queue_t *self, const void *e);
+
+/* Consumer side: removes the oldest element, copying it into 'into' first if
+ * not NULL. Returns false if the queue is empty.
+ */
+bool spsc_queue_pop(spsc_queue_t *self, void *into);
+
+/* Producer side: adds up to 'n' consecutive elements from 'src', returns how
+ * many were added.
+ */
+size_t spsc_queue_push_batch(spsc_queue_t *self, const void *src, size_t n);
+
+/* Consumer side: removes up to 'n' elements, copying them into 'into' if not
+ * NULL, returns how many were removed.
+ */
+size_t spsc_queue_pop_batch(spsc_queue_t *self, void *into, size_t n);
+
+/* Returns the number of elements in the queue. When called while the other
+ * side is running, the value may be outdated as soon as it is returned.
+ */
+size_t spsc_queue_size(spsc_queue_t *self);
+
+/* Same as the spsc functions, every one of them may be called from any
+ * number of threads at the same time (except 'mpmc_queue_kill').
+ */
+mpmc_queue_t *mpmc_queue_create(size_t elt_size, size_t n);
+
+mpmc_queue_t *mpmc_queue_create_with_allocator(
+    const array_allocator_t *allocator, size_t elt_size, size_t n);
+
+/* Only the sequence numbers are allocated, the elements are kept in
+ * 'buffer'.
+ */
+mpmc_queue_t *mpmc_queue_borrow_buffer(void *buffer, size_t elt_size,
+                                       size_t n);
+
+void mpmc_queue_kill(mpmc_queue_t *self);
+
+bool mpmc_queue_push(mpmc_queue_t *self, const void *e);
+
+bool mpmc_queue_pop(mpmc_queue_t *self, void *into);
+
+/* The batch is claimed with a single update of the position counter, so its
+ * elements are contiguous in the queue order.
+ */
+size_t mpmc_queue_push_batch(mpmc_queue_t *self, const void *src, size_t n);
+
+size_t mpmc_queue_pop_batch(mpmc_queue_t *self, void *into, size_t n);
+
+size_t mpmc_queue_size(mpmc_queue_t *self);
+
+#endif /* __QUEUE_H__ */
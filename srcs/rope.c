@@ -0,0 +1,496 @@
+#include "rope.h"
+#include "array.h"
+#include "dynstr.h"
+#include "internal.h"
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define _node_size(node) ((node) ? (node)->_size : 0)
+#define _chunk_size(node) ((node)->_chunk->_nmemb)
+#define _chunk_data(node) ((char *)(node)->_chunk->_ptr)
+
+/* NODES */
+
+static ut64_t rope_priority(rope_t *self) {
+  self->_seed ^= self->_seed << 13;
+  self->_seed ^= self->_seed >> 7;
+  self->_seed ^= self->_seed << 17;
+  return (self->_seed);
+}
+
+static void node_update(rope_node_t *node) {
+  node->_size =
+      _node_size(node->_left) + _chunk_size(node) + _node_size(node->_right);
+}
+
+/* Creates a node holding a copy of the 'n' (at most ROPE_CHUNK_SIZE)
+ * characters at 'src'. */
+static rope_node_t *node_create(rope_t *self, const char *src, size_t n) {
+  rope_node_t *node = _allocator_alloc(self->_allocator, sizeof(*node));
+
+  if (unlikely(!node)) {
+    return (NULL);
+  }
+
+  /* One more byte, as an array only fills up to its capacity excluded. */
+  node->_chunk = array_create_with_allocator(self->_allocator, sizeof(char),
+                                             ROPE_CHUNK_SIZE + 1, NULL);
+  if (unlikely(!node->_chunk)) {
+    _allocator_free(self->_allocator, node);
+    return (NULL);
+  }
+  array_settle(node->_chunk);
+
+  if (n) {
+    (void)array_append(node->_chunk, src, n);
+  }
+  node->_left = NULL;
+  node->_right = NULL;
+  node->_priority = rope_priority(self);
+  node_update(node);
+
+  return (node);
+}
+
+static void node_kill(const array_allocator_t *allocator, rope_node_t *node) {
+  if (node) {
+    node_kill(allocator, node->_left);
+    node_kill(allocator, node->_right);
+    array_kill(node->_chunk);
+    _allocator_free(allocator, node);
+  }
+}
+
+/* Joins two trees, all the characters of 'a' coming first. */
+static rope_node_t *node_merge(rope_node_t *a, rope_node_t *b) {
+  if (!a || !b) {
+    return (a ? a : b);
+  }
+
+  if (a->_priority > b->_priority) {
+    a->_right = node_merge(a->_right, b);
+    node_update(a);
+    return (a);
+  }
+
+  b->_left = node_merge(a, b->_left);
+  node_update(b);
+  return (b);
+}
+
+/* Unlinks the first node of a tree and returns it, or NULL if the tree is
+ * empty. */
+static rope_node_t *node_pop_first(rope_node_t **tree) {
+  rope_node_t **link = tree;
+
+  if (!*tree) {
+    return (NULL);
+  }
+  while ((*link)->_left) {
+    link = &(*link)->_left;
+  }
+
+  rope_node_t *node = *link;
+
+  for (rope_node_t *it = *tree; it != node; it = it->_left) {
+    it->_size -= _chunk_size(node);
+  }
+  *link = node->_right;
+  node->_right = NULL;
+  node_update(node);
+
+  return (node);
+}
+
+/* Same as 'node_pop_first', for the last node. */
+static rope_node_t *node_pop_last(rope_node_t **tree) {
+  rope_node_t **link = tree;
+
+  if (!*tree) {
+    return (NULL);
+  }
+  while ((*link)->_right) {
+    link = &(*link)->_right;
+  }
+
+  rope_node_t *node = *link;
+
+  for (rope_node_t *it = *tree; it != node; it = it->_right) {
+    it->_size -= _chunk_size(node);
+  }
+  *link = node->_left;
+  node->_left = NULL;
+  node_update(node);
+
+  return (node);
+}
+
+/* Joins two trees like 'node_merge', packing the chunks around the seam
+ * first: the last two of 'a' and the first two of 'b' are merged whenever
+ * two neighbours fit in one chunk.
+ *
+ * A cut only ever shrinks the chunk at the end of each side, so packing
+ * these after every cut keeps any two neighbouring chunks above
+ * ROPE_CHUNK_SIZE characters together. The chunks then stay half full on
+ * average, however the rope gets edited. */
+static rope_node_t *node_join(const array_allocator_t *allocator,
+                              rope_node_t *a, rope_node_t *b) {
+  rope_node_t *window[4];
+  size_t count = 0;
+  size_t packed = 0;
+
+  window[1] = node_pop_last(&a);
+  window[0] = node_pop_last(&a);
+  window[2] = node_pop_first(&b);
+  window[3] = node_pop_first(&b);
+
+  for (size_t i = 0; i < 4; i++) {
+    if (window[i]) {
+      window[count++] = window[i];
+    }
+  }
+
+  for (size_t i = 1; i < count; i++) {
+    rope_node_t *last = window[packed];
+    size_t len = _chunk_size(window[i]);
+
+    if (_chunk_size(last) + len <= ROPE_CHUNK_SIZE) {
+      (void)array_append(last->_chunk, _chunk_data(window[i]), len);
+      node_update(last);
+      node_kill(allocator, window[i]);
+    } else {
+      window[++packed] = window[i];
+    }
+  }
+
+  for (size_t i = 0; count && i <= packed; i++) {
+    a = node_merge(a, window[i]);
+  }
+
+  return (node_merge(a, b));
+}
+
+/* Splits a tree into the first 'pos' characters and the others. When 'pos'
+ * falls inside a chunk, its end moves to '*spare', which is then set to
+ * NULL. */
+static void node_split(rope_node_t *node, size_t pos, rope_node_t **spare,
+                       rope_node_t **l, rope_node_t **r) {
+  if (!node) {
+    *l = NULL;
+    *r = NULL;
+    return;
+  }
+
+  size_t before = _node_size(node->_left);
+  size_t len = _chunk_size(node);
+
+  if (pos <= before) {
+    node_split(node->_left, pos, spare, l, &node->_left);
+    node_update(node);
+    *r = node;
+  } else if (pos >= before + len) {
+    node_split(node->_right, pos - before - len, spare, &node->_right, r);
+    node_update(node);
+    *l = node;
+  } else {
+    rope_node_t *tail = *spare;
+    size_t k = pos - before;
+
+    *spare = NULL;
+    (void)array_append(tail->_chunk, _chunk_data(node) + k, len - k);
+    array_wipe(node->_chunk, k, len);
+    node_update(tail);
+
+    *r = node_merge(tail, node->_right);
+    node->_right = NULL;
+    node_update(node);
+    *l = node;
+  }
+}
+
+/* Returns the node holding the character at 'pos' and its position in the
+ * chunk in '*offset'. With 'at_end', a position right after a chunk may stop
+ * at it too, so the end of the rope is found. */
+static rope_node_t *rope_find(const rope_t *self, size_t pos, bool at_end,
+                              size_t *offset) {
+  rope_node_t *node = self->_root;
+
+  while (node) {
+    size_t before = _node_size(node->_left);
+    size_t len = _chunk_size(node);
+
+    if (pos < before) {
+      node = node->_left;
+    } else if (pos < before + len || (at_end && pos == before + len)) {
+      *offset = pos - before;
+      return (node);
+    } else {
+      pos -= before + len;
+      node = node->_right;
+    }
+  }
+
+  return (NULL);
+}
+
+/* Splits the rope at 'pos', leaving it empty, or returns false if a spare
+ * node could not be made. */
+static bool rope_cut(rope_t *self, size_t pos, rope_node_t **l,
+                     rope_node_t **r) {
+  size_t offset = 0;
+  rope_node_t *node = rope_find(self, pos, false, &offset);
+  rope_node_t *spare = NULL;
+  rope_node_t *root = self->_root;
+
+  /* A cut between two chunks copies nothing. */
+  if (node && offset) {
+    spare = node_create(self, NULL, 0);
+    if (unlikely(!spare)) {
+      return (false);
+    }
+  }
+
+  self->_root = NULL;
+  node_split(root, pos, &spare, l, r);
+  if (spare) {
+    node_kill(self->_allocator, spare);
+  }
+
+  return (true);
+}
+
+/* Builds a tree from 'n' characters, ROPE_CHUNK_SIZE at a time. */
+static bool rope_build(rope_t *self, const char *src, size_t n,
+                       rope_node_t **tree) {
+  *tree = NULL;
+
+  for (size_t i = 0; i < n; i += ROPE_CHUNK_SIZE) {
+    rope_node_t *node = node_create(self, src + i, MIN(ROPE_CHUNK_SIZE, n - i));
+
+    if (unlikely(!node)) {
+      node_kill(self->_allocator, *tree);
+      *tree = NULL;
+      return (false);
+    }
+    *tree = node_merge(*tree, node);
+  }
+
+  return (true);
+}
+
+/* API */
+
+rope_t *rope_create(void) {
+  return (rope_create_with_allocator(&__array_allocator__));
+}
+
+rope_t *rope_create_with_allocator(const array_allocator_t *allocator) {
+  HR_COMPLAIN_IF(allocator == NULL);
+
+  rope_t *self = _allocator_alloc(allocator, sizeof(*self));
+
+  if (likely(self)) {
+    self->_root = NULL;
+    self->_seed = 0x9e3779b97f4a7c15ULL ^ (ut64_t)(uintptr_t)self;
+    self->_allocator = allocator;
+  }
+
+  return (self);
+}
+
+rope_t *rope_assign(const char *src, st64_t n) {
+  HR_COMPLAIN_IF(src == NULL);
+  HR_COMPLAIN_IF(LONG_MAX - 1 <= n);
+
+  rope_t *self = rope_create();
+
+  if (likely(self) && unlikely(!rope_append(self, src, n))) {
+    rope_kill(self);
+    return (NULL);
+  }
+
+  return (self);
+}
+
+void rope_kill(rope_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  node_kill(self->_allocator, self->_root);
+  _allocator_free(self->_allocator, self);
+}
+
+__attr_pure size_t rope_size(const rope_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (_node_size(self->_root));
+}
+
+__attr_pure char rope_at(const rope_t *self, size_t p) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(p >= rope_size(self));
+
+  size_t offset = 0;
+  rope_node_t *node = rope_find(self, p, false, &offset);
+
+  return (_chunk_data(node)[offset]);
+}
+
+bool rope_inject(rope_t *self, size_t pos, const char *src, st64_t n) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(src == NULL);
+  HR_COMPLAIN_IF(LONG_MAX - 1 <= n);
+  HR_COMPLAIN_IF(pos > rope_size(self));
+
+  size_t size = (n == -1) ? strlen(src) : (size_t)n;
+  size_t offset = 0;
+  rope_node_t *target = rope_find(self, pos, true, &offset);
+
+  if (!size) {
+    return (true);
+  }
+
+  /* The chunk at 'pos' has room: the sizes along its path grow. */
+  if (target && _chunk_size(target) + size <= ROPE_CHUNK_SIZE) {
+    rope_node_t *node = self->_root;
+
+    if (unlikely(!array_inject(target->_chunk, offset, src, size))) {
+      return (false);
+    }
+
+    for (size_t p = pos; node != target;) {
+      size_t before = _node_size(node->_left);
+
+      node->_size += size;
+      if (p < before) {
+        node = node->_left;
+      } else {
+        p -= before + _chunk_size(node);
+        node = node->_right;
+      }
+    }
+    target->_size += size;
+
+    return (true);
+  }
+
+  rope_node_t *middle;
+  rope_node_t *l;
+  rope_node_t *r;
+
+  if (unlikely(!rope_build(self, src, size, &middle))) {
+    return (false);
+  }
+  if (unlikely(!rope_cut(self, pos, &l, &r))) {
+    node_kill(self->_allocator, middle);
+    return (false);
+  }
+  self->_root = node_join(self->_allocator,
+                          node_join(self->_allocator, l, middle), r);
+
+  return (true);
+}
+
+bool rope_append(rope_t *self, const char *src, st64_t n) {
+  return (rope_inject(self, rope_size(self), src, n));
+}
+
+bool rope_wipe(rope_t *self, size_t start, size_t end) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(SIZE_T_SAFE_TO_SUB(end, start) == false);
+  HR_COMPLAIN_IF(end > rope_size(self));
+
+  rope_node_t *l;
+  rope_node_t *middle;
+  rope_node_t *r;
+
+  if (start == end) {
+    return (true);
+  }
+
+  if (unlikely(!rope_cut(self, end, &middle, &r))) {
+    return (false);
+  }
+  self->_root = middle;
+  if (unlikely(!rope_cut(self, start, &l, &middle))) {
+    self->_root = node_merge(self->_root, r);
+    return (false);
+  }
+
+  node_kill(self->_allocator, middle);
+  self->_root = node_join(self->_allocator, l, r);
+
+  return (true);
+}
+
+void rope_concat(rope_t *self, rope_t *other) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(other == NULL);
+  HR_COMPLAIN_IF(self == other);
+  HR_COMPLAIN_IF(self->_allocator != other->_allocator);
+
+  self->_root = node_join(self->_allocator, self->_root, other->_root);
+  other->_root = NULL;
+}
+
+rope_t *rope_split(rope_t *self, size_t pos) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(pos > rope_size(self));
+
+  rope_t *other = rope_create_with_allocator(self->_allocator);
+  rope_node_t *root = self->_root;
+
+  if (unlikely(!other)) {
+    return (NULL);
+  }
+
+  if (unlikely(!rope_cut(self, pos, &self->_root, &other->_root))) {
+    self->_root = root;
+    rope_kill(other);
+    return (NULL);
+  }
+  self->_root = node_join(self->_allocator, self->_root, NULL);
+  other->_root = node_join(self->_allocator, NULL, other->_root);
+
+  return (other);
+}
+
+bool rope_next(const rope_t *self, size_t *it, const char **ptr, size_t *len) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(it == NULL);
+  HR_COMPLAIN_IF(ptr == NULL);
+  HR_COMPLAIN_IF(len == NULL);
+
+  if (*it >= rope_size(self)) {
+    return (false);
+  }
+
+  size_t offset = 0;
+  rope_node_t *node = rope_find(self, *it, false, &offset);
+
+  *ptr = _chunk_data(node) + offset;
+  *len = _chunk_size(node) - offset;
+  *it += *len;
+
+  return (true);
+}
+
+dynstr_t *rope_flatten(const rope_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  dynstr_t *str =
+      dynstr_create_with_allocator(self->_allocator, rope_size(self));
+  size_t it = 0;
+  const char *ptr;
+  size_t len;
+
+  if (unlikely(!str)) {
+    return (NULL);
+  }
+
+  while (rope_next(self, &it, &ptr, &len)) {
+    (void)dynstr_append(str, ptr, (st64_t)len);
+  }
+
+  return (str);
+}
@@ -0,0 +1,100 @@
+#ifndef __ROPE_H__
+#define __ROPE_H__
+
+#include "array.h"
+#include "dynstr.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/* A node of a rope: a chunk of at most ROPE_CHUNK_SIZE characters, which
+ * come after the ones of the left subtree and before the ones of the right
+ * subtree.
+ */
+typedef struct rope_node_s {
+  struct rope_node_s *_left;
+  struct rope_node_s *_right;
+  array_t *_chunk;  /* The characters of the node (never empty) */
+  size_t _size;     /* The number of characters in the subtree */
+  ut64_t _priority; /* Every node has a higher priority than its children */
+} rope_node_t;
+
+/* A string split into chunks held by a balanced tree (a treap, keyed by the
+ * position of the characters). Joining, splitting, inserting and indexing
+ * take O(log n) steps, and only ever copy the characters of one or two
+ * chunks, so the string can be much larger than a single buffer reasonably
+ * reallocated.
+ */
+typedef struct {
+  rope_node_t *_root;
+  ut64_t _seed; /* The state of the priority generator */
+
+  const array_allocator_t *_allocator; /* Allocator of the rope, its nodes
+                                        * and their chunks */
+} rope_t;
+
+/* Creates a new empty rope.
+ */
+rope_t *rope_create(void);
+
+rope_t *rope_create_with_allocator(const array_allocator_t *allocator);
+
+/* Creates a new rope from the data pointed to by 'src', copying it until
+ * '\0' if 'n' == -1, or 'n' bytes.
+ */
+rope_t *rope_assign(const char *src, st64_t n);
+
+/* Frees the rope.
+ */
+void rope_kill(rope_t *self);
+
+/* Returns the number of characters.
+ */
+__attr_pure size_t rope_size(const rope_t *self);
+
+/* Returns the character at position 'p'.
+ */
+__attr_pure char rope_at(const rope_t *self, size_t p);
+
+/* Injects the string pointed to by 'src' at position 'pos', copying it until
+ * '\0' if 'n' == -1, or 'n' bytes. A short string goes into the chunk at
+ * 'pos' when it has room left.
+ */
+bool rope_inject(rope_t *self, size_t pos, const char *src, st64_t n);
+
+/* Same as 'inject', at the end of the rope.
+ */
+bool rope_append(rope_t *self, const char *src, st64_t n);
+
+/* Removes the characters within start -> end (excluded).
+ */
+bool rope_wipe(rope_t *self, size_t start, size_t end);
+
+/* Moves all the characters of 'other' to the end of 'self', leaving 'other'
+ * empty. The last two chunks of 'self' and the first two of 'other' are
+ * packed: each is appended to the chunk before it when both fit in one, so
+ * up to three neighbouring chunks may be copied. The other chunks are
+ * moved as they are. Both ropes must use the same allocator.
+ */
+void rope_concat(rope_t *self, rope_t *other);
+
+/* Moves the characters from position 'pos' to the end into a new rope,
+ * which is returned. When 'pos' falls inside a chunk, the end of that chunk
+ * is copied into a new one. The two chunks at the end of 'self' and the two
+ * at the start of the new rope are then packed like in 'concat'.
+ */
+rope_t *rope_split(rope_t *self, size_t pos);
+
+/* Iterates over the characters one chunk at a time, without copying them:
+ * starting with '*it' set to 0 (or any position), every call stores the
+ * address of the next run of contiguous characters in 'ptr' and its length
+ * in 'len', and returns true, until there are no more. The rope must not be
+ * modified during the iteration.
+ */
+bool rope_next(const rope_t *self, size_t *it, const char **ptr, size_t *len);
+
+/* Creates a new dynamic string holding a copy of the whole rope.
+ */
+dynstr_t *rope_flatten(const rope_t *self);
+
+#endif /* __ROPE_H__ */
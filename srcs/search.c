@@ -0,0 +1,351 @@
+#include "search.h"
+#include "cpu.h"
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef size_t (*find_kernel_t)(const void *, size_t, const void *);
+typedef void (*minmax_kernel_t)(const void *, size_t, void *, void *);
+
+/* SCALAR KERNELS */
+
+#define SCALAR_FIND(type)                                                      \
+  static size_t find_##type(const void *base, size_t n, const void *value) {  \
+    const type *p = base;                                                      \
+    type v;                                                                    \
+                                                                               \
+    (void)builtin_memcpy(&v, value, sizeof(v));                                \
+    for (size_t i = 0; i < n; i++) {                                           \
+      if (p[i] == v) {                                                         \
+        return (i);                                                            \
+      }                                                                        \
+    }                                                                          \
+    return (n);                                                                \
+  }                                                                            \
+                                                                               \
+  static size_t count_##type(const void *base, size_t n, const void *value) { \
+    const type *p = base;                                                      \
+    size_t count = 0;                                                          \
+    type v;                                                                    \
+                                                                               \
+    (void)builtin_memcpy(&v, value, sizeof(v));                                \
+    for (size_t i = 0; i < n; i++) {                                           \
+      count += p[i] == v;                                                      \
+    }                                                                          \
+    return (count);                                                            \
+  }
+
+/* Merges the elements into '*min' and '*max', which already hold one. */
+#define SCALAR_MINMAX(type)                                                    \
+  static void minmax_##type(const void *base, size_t n, void *min,            \
+                            void *max) {                                       \
+    const type *p = base;                                                      \
+    type lo;                                                                   \
+    type hi;                                                                   \
+                                                                               \
+    (void)builtin_memcpy(&lo, min, sizeof(lo));                                \
+    (void)builtin_memcpy(&hi, max, sizeof(hi));                                \
+    for (size_t i = 0; i < n; i++) {                                           \
+      lo = p[i] < lo ? p[i] : lo;                                              \
+      hi = p[i] > hi ? p[i] : hi;                                              \
+    }                                                                          \
+    (void)builtin_memcpy(min, &lo, sizeof(lo));                                \
+    (void)builtin_memcpy(max, &hi, sizeof(hi));                                \
+  }
+
+SCALAR_FIND(ut8_t)
+SCALAR_FIND(ut16_t)
+SCALAR_FIND(ut32_t)
+SCALAR_FIND(ut64_t)
+
+SCALAR_MINMAX(ut8_t)
+SCALAR_MINMAX(ut16_t)
+SCALAR_MINMAX(ut32_t)
+SCALAR_MINMAX(ut64_t)
+SCALAR_MINMAX(st8_t)
+SCALAR_MINMAX(st16_t)
+SCALAR_MINMAX(st32_t)
+SCALAR_MINMAX(st64_t)
+
+/* Indexed by the log2 of the element size. */
+static const find_kernel_t find_scalar[4] = {&find_ut8_t, &find_ut16_t,
+                                             &find_ut32_t, &find_ut64_t};
+static const find_kernel_t count_scalar[4] = {&count_ut8_t, &count_ut16_t,
+                                              &count_ut32_t, &count_ut64_t};
+static const minmax_kernel_t minmax_scalar[4][2] = {
+    {&minmax_ut8_t, &minmax_st8_t},
+    {&minmax_ut16_t, &minmax_st16_t},
+    {&minmax_ut32_t, &minmax_st32_t},
+    {&minmax_ut64_t, &minmax_st64_t},
+};
+
+#ifdef CPU_X86
+
+/* WIDE KERNELS
+ *
+ * A comparison of 'width' bytes gives a mask with 'size' bits per matching
+ * element, from which the position of the first one, or the number of
+ * matches, is read with a single instruction.
+ */
+
+#define WIDE_FIND(name, isa, width, vec_t, type, lg, loadu, set1, cmpeq,       \
+                  movemask)                                                    \
+  __attribute__((target(isa))) static size_t find_##name(                      \
+      const void *base, size_t n, const void *value) {                         \
+    const type *p = base;                                                      \
+    size_t per = (width) / sizeof(type);                                       \
+    size_t i = 0;                                                              \
+    type v;                                                                    \
+                                                                               \
+    (void)builtin_memcpy(&v, value, sizeof(v));                                \
+    vec_t splat = set1(v);                                                     \
+                                                                               \
+    for (; i + per <= n; i += per) {                                           \
+      ut32_t m = (ut32_t)movemask(cmpeq(loadu((const vec_t *)(p + i)), splat)); \
+                                                                               \
+      if (m) {                                                                 \
+        return (i + ((size_t)__builtin_ctz(m) >> (lg)));                       \
+      }                                                                        \
+    }                                                                          \
+    return (i + find_scalar[lg](p + i, n - i, value));                         \
+  }                                                                            \
+                                                                               \
+  __attribute__((target(isa))) static size_t count_##name(                     \
+      const void *base, size_t n, const void *value) {                         \
+    const type *p = base;                                                      \
+    size_t per = (width) / sizeof(type);                                       \
+    size_t bits = 0;                                                           \
+    size_t i = 0;                                                              \
+    type v;                                                                    \
+                                                                               \
+    (void)builtin_memcpy(&v, value, sizeof(v));                                \
+    vec_t splat = set1(v);                                                     \
+                                                                               \
+    for (; i + per <= n; i += per) {                                           \
+      bits += (size_t)__builtin_popcount(                                      \
+          (ut32_t)movemask(cmpeq(loadu((const vec_t *)(p + i)), splat)));      \
+    }                                                                          \
+    return ((bits >> (lg)) + count_scalar[lg](p + i, n - i, value));           \
+  }
+
+/* The elements are xored with 'bias' on the way in and out, to run an
+ * unsigned comparison on signed instructions or the other way around. The
+ * lanes of the vector minimum and maximum are merged at the end, like any
+ * other element. */
+#define WIDE_MINMAX(name, isa, width, vec_t, type, lg, sign, loadu, storeu,    \
+                    set1, xor, vmin, vmax, bias)                               \
+  __attribute__((target(isa))) static void minmax_##name(                      \
+      const void *base, size_t n, void *min, void *max) {                      \
+    const type *p = base;                                                      \
+    size_t per = (width) / sizeof(type);                                       \
+    size_t i = 0;                                                              \
+                                                                               \
+    if (n >= per) {                                                            \
+      vec_t b = set1(bias);                                                    \
+      vec_t lo = xor(loadu((const vec_t *)p), b);                              \
+      vec_t hi = lo;                                                           \
+      type lanes[2 * (width) / sizeof(type)];                                  \
+                                                                               \
+      for (i = per; i + per <= n; i += per) {                                  \
+        vec_t x = xor(loadu((const vec_t *)(p + i)), b);                       \
+                                                                               \
+        lo = vmin(lo, x);                                                      \
+        hi = vmax(hi, x);                                                      \
+      }                                                                        \
+      storeu((vec_t *)lanes, xor(lo, b));                                      \
+      storeu((vec_t *)(lanes + per), xor(hi, b));                              \
+      minmax_scalar[lg][sign](lanes, 2 * per, min, max);                       \
+    }                                                                          \
+    minmax_scalar[lg][sign](p + i, n - i, min, max);                           \
+  }
+
+/* SSE2 has no 64-bit equality: both halves must match. */
+__attribute__((target("sse2"))) static inline __m128i
+sse2_cmpeq_epi64(__m128i a, __m128i b) {
+  __m128i e = _mm_cmpeq_epi32(a, b);
+
+  return (_mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1))));
+}
+
+__attribute__((target("avx2"))) static inline __m256i
+avx2_min_epi64(__m256i a, __m256i b) {
+  return (_mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)));
+}
+
+__attribute__((target("avx2"))) static inline __m256i
+avx2_max_epi64(__m256i a, __m256i b) {
+  return (_mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)));
+}
+
+WIDE_FIND(8_sse2, "sse2", 16, __m128i, ut8_t, 0, _mm_loadu_si128,
+          _mm_set1_epi8, _mm_cmpeq_epi8, _mm_movemask_epi8)
+WIDE_FIND(16_sse2, "sse2", 16, __m128i, ut16_t, 1, _mm_loadu_si128,
+          _mm_set1_epi16, _mm_cmpeq_epi16, _mm_movemask_epi8)
+WIDE_FIND(32_sse2, "sse2", 16, __m128i, ut32_t, 2, _mm_loadu_si128,
+          _mm_set1_epi32, _mm_cmpeq_epi32, _mm_movemask_epi8)
+WIDE_FIND(64_sse2, "sse2", 16, __m128i, ut64_t, 3, _mm_loadu_si128,
+          _mm_set1_epi64x, sse2_cmpeq_epi64, _mm_movemask_epi8)
+
+WIDE_FIND(8_avx2, "avx2,popcnt", 32, __m256i, ut8_t, 0, _mm256_loadu_si256,
+          _mm256_set1_epi8, _mm256_cmpeq_epi8, _mm256_movemask_epi8)
+WIDE_FIND(16_avx2, "avx2,popcnt", 32, __m256i, ut16_t, 1, _mm256_loadu_si256,
+          _mm256_set1_epi16, _mm256_cmpeq_epi16, _mm256_movemask_epi8)
+WIDE_FIND(32_avx2, "avx2,popcnt", 32, __m256i, ut32_t, 2, _mm256_loadu_si256,
+          _mm256_set1_epi32, _mm256_cmpeq_epi32, _mm256_movemask_epi8)
+WIDE_FIND(64_avx2, "avx2,popcnt", 32, __m256i, ut64_t, 3, _mm256_loadu_si256,
+          _mm256_set1_epi64x, _mm256_cmpeq_epi64, _mm256_movemask_epi8)
+
+/* SSE2 only has unsigned 8-bit and signed 16-bit minimum and maximum. */
+WIDE_MINMAX(u8_sse2, "sse2", 16, __m128i, ut8_t, 0, 0, _mm_loadu_si128,
+            _mm_storeu_si128, _mm_set1_epi8, _mm_xor_si128, _mm_min_epu8,
+            _mm_max_epu8, 0)
+WIDE_MINMAX(s8_sse2, "sse2", 16, __m128i, st8_t, 0, 1, _mm_loadu_si128,
+            _mm_storeu_si128, _mm_set1_epi8, _mm_xor_si128, _mm_min_epu8,
+            _mm_max_epu8, (char)0x80)
+WIDE_MINMAX(u16_sse2, "sse2", 16, __m128i, ut16_t, 1, 0, _mm_loadu_si128,
+            _mm_storeu_si128, _mm_set1_epi16, _mm_xor_si128, _mm_min_epi16,
+            _mm_max_epi16, (short)0x8000)
+WIDE_MINMAX(s16_sse2, "sse2", 16, __m128i, st16_t, 1, 1, _mm_loadu_si128,
+            _mm_storeu_si128, _mm_set1_epi16, _mm_xor_si128, _mm_min_epi16,
+            _mm_max_epi16, 0)
+
+WIDE_MINMAX(u8_avx2, "avx2", 32, __m256i, ut8_t, 0, 0, _mm256_loadu_si256,
+            _mm256_storeu_si256, _mm256_set1_epi8, _mm256_xor_si256,
+            _mm256_min_epu8, _mm256_max_epu8, 0)
+WIDE_MINMAX(s8_avx2, "avx2", 32, __m256i, st8_t, 0, 1, _mm256_loadu_si256,
+            _mm256_storeu_si256, _mm256_set1_epi8, _mm256_xor_si256,
+            _mm256_min_epi8, _mm256_max_epi8, 0)
+WIDE_MINMAX(u16_avx2, "avx2", 32, __m256i, ut16_t, 1, 0, _mm256_loadu_si256,
+            _mm256_storeu_si256, _mm256_set1_epi16, _mm256_xor_si256,
+            _mm256_min_epu16, _mm256_max_epu16, 0)
+WIDE_MINMAX(s16_avx2, "avx2", 32, __m256i, st16_t, 1, 1, _mm256_loadu_si256,
+            _mm256_storeu_si256, _mm256_set1_epi16, _mm256_xor_si256,
+            _mm256_min_epi16, _mm256_max_epi16, 0)
+WIDE_MINMAX(u32_avx2, "avx2", 32, __m256i, ut32_t, 2, 0, _mm256_loadu_si256,
+            _mm256_storeu_si256, _mm256_set1_epi32, _mm256_xor_si256,
+            _mm256_min_epu32, _mm256_max_epu32, 0)
+WIDE_MINMAX(s32_avx2, "avx2", 32, __m256i, st32_t, 2, 1, _mm256_loadu_si256,
+            _mm256_storeu_si256, _mm256_set1_epi32, _mm256_xor_si256,
+            _mm256_min_epi32, _mm256_max_epi32, 0)
+WIDE_MINMAX(u64_avx2, "avx2", 32, __m256i, ut64_t, 3, 0, _mm256_loadu_si256,
+            _mm256_storeu_si256, _mm256_set1_epi64x, _mm256_xor_si256,
+            avx2_min_epi64, avx2_max_epi64, (long long)(1ULL << 63))
+WIDE_MINMAX(s64_avx2, "avx2", 32, __m256i, st64_t, 3, 1, _mm256_loadu_si256,
+            _mm256_storeu_si256, _mm256_set1_epi64x, _mm256_xor_si256,
+            avx2_min_epi64, avx2_max_epi64, 0)
+
+#endif /* CPU_X86 */
+
+static find_kernel_t find_kernels[4] = {&find_ut8_t, &find_ut16_t,
+                                        &find_ut32_t, &find_ut64_t};
+static find_kernel_t count_kernels[4] = {&count_ut8_t, &count_ut16_t,
+                                         &count_ut32_t, &count_ut64_t};
+static minmax_kernel_t minmax_kernels[4][2] = {
+    {&minmax_ut8_t, &minmax_st8_t},
+    {&minmax_ut16_t, &minmax_st16_t},
+    {&minmax_ut32_t, &minmax_st32_t},
+    {&minmax_ut64_t, &minmax_st64_t},
+};
+
+__attribute__((constructor)) static void search_select_kernels(void) {
+#ifdef CPU_X86
+  unsigned int features = cpu_features();
+
+  if (features & CPU_SSE2) {
+    find_kernels[0] = &find_8_sse2;
+    find_kernels[1] = &find_16_sse2;
+    find_kernels[2] = &find_32_sse2;
+    find_kernels[3] = &find_64_sse2;
+    count_kernels[0] = &count_8_sse2;
+    count_kernels[1] = &count_16_sse2;
+    count_kernels[2] = &count_32_sse2;
+    count_kernels[3] = &count_64_sse2;
+    minmax_kernels[0][0] = &minmax_u8_sse2;
+    minmax_kernels[0][1] = &minmax_s8_sse2;
+    minmax_kernels[1][0] = &minmax_u16_sse2;
+    minmax_kernels[1][1] = &minmax_s16_sse2;
+  }
+  if ((features & CPU_AVX2) && (features & CPU_POPCNT)) {
+    find_kernels[0] = &find_8_avx2;
+    find_kernels[1] = &find_16_avx2;
+    find_kernels[2] = &find_32_avx2;
+    find_kernels[3] = &find_64_avx2;
+    count_kernels[0] = &count_8_avx2;
+    count_kernels[1] = &count_16_avx2;
+    count_kernels[2] = &count_32_avx2;
+    count_kernels[3] = &count_64_avx2;
+    minmax_kernels[0][0] = &minmax_u8_avx2;
+    minmax_kernels[0][1] = &minmax_s8_avx2;
+    minmax_kernels[1][0] = &minmax_u16_avx2;
+    minmax_kernels[1][1] = &minmax_s16_avx2;
+    minmax_kernels[2][0] = &minmax_u32_avx2;
+    minmax_kernels[2][1] = &minmax_s32_avx2;
+    minmax_kernels[3][0] = &minmax_u64_avx2;
+    minmax_kernels[3][1] = &minmax_s64_avx2;
+  }
+#endif
+}
+
+/* Returns the log2 of 'size' if it is 1, 2, 4 or 8, or -1. */
+static inline int size_log2(size_t size) {
+  switch (size) {
+  case 1:
+    return (0);
+  case 2:
+    return (1);
+  case 4:
+    return (2);
+  case 8:
+    return (3);
+  default:
+    return (-1);
+  }
+}
+
+__attr_pure size_t search_find(const void *base, size_t n, size_t size,
+                               const void *value) {
+  int lg = size_log2(size);
+
+  if (likely(lg >= 0)) {
+    return (find_kernels[lg](base, n, value));
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    if (memcmp((const char *)base + i * size, value, size) == 0) {
+      return (i);
+    }
+  }
+  return (n);
+}
+
+__attr_pure size_t search_count(const void *base, size_t n, size_t size,
+                                const void *value) {
+  int lg = size_log2(size);
+  size_t count = 0;
+
+  if (likely(lg >= 0)) {
+    return (count_kernels[lg](base, n, value));
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    count += memcmp((const char *)base + i * size, value, size) == 0;
+  }
+  return (count);
+}
+
+void search_minmax(const void *base, size_t n, size_t size, bool is_signed,
+                   void *min, void *max) {
+  int lg = size_log2(size);
+
+  HR_COMPLAIN_IF(lg < 0);
+  HR_COMPLAIN_IF(n == 0);
+
+  if (unlikely(lg < 0 || n == 0)) {
+    return;
+  }
+
+  (void)builtin_memcpy(min, base, size);
+  (void)builtin_memcpy(max, base, size);
+  minmax_kernels[lg][is_signed](base, n, min, max);
+}
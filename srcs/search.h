@@ -0,0 +1,31 @@
+#ifndef __SEARCH_H__
+#define __SEARCH_H__
+
+#include "internal.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Value search kernels. Elements of 1, 2, 4 or 8 bytes are compared as
+ * integers, several at a time: the wide versions (SSE2, AVX2) are picked once
+ * at startup from the features of the CPU the library runs on.
+ */
+
+/* Returns the position of the first of the 'n' elements of 'size' bytes
+ * starting at 'base' equal to the one at 'value', or 'n' if there is none.
+ * Other sizes are compared byte by byte.
+ */
+__attr_pure size_t search_find(const void *base, size_t n, size_t size,
+                               const void *value);
+
+/* Returns the number of elements equal to the one at 'value'.
+ */
+__attr_pure size_t search_count(const void *base, size_t n, size_t size,
+                                const void *value);
+
+/* Stores the smallest and the largest of the 'n' (at least 1) integers of
+ * 'size' bytes (1, 2, 4 or 8) starting at 'base' into 'min' and 'max'.
+ */
+void search_minmax(const void *base, size_t n, size_t size, bool is_signed,
+                   void *min, void *max);
+
+#endif /* __SEARCH_H__ */
@@ -0,0 +1,315 @@
+#include "snapshot.h"
+#include "internal.h"
+#include "pages.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+_Static_assert(sizeof(snapshot_header_t) == 64,
+               "the elements of a mapped snapshot must stay aligned");
+
+static inline ut64_t checksum_mix(ut64_t h, ut64_t w) {
+  h = (h ^ w) * FNV_PRIME;
+  return (h ^ (h >> 29));
+}
+
+/* FNV-1a on 64 bit words, over four interleaved lanes so the multiplies
+ * of consecutive words do not wait on each other.
+ */
+__attr_pure ut64_t snapshot_checksum(const void *data, size_t n) {
+  const ut8_t *p = data;
+  ut64_t lanes[4] = {FNV_OFFSET, FNV_OFFSET ^ 1, FNV_OFFSET ^ 2,
+                     FNV_OFFSET ^ 3};
+
+  while (n >= sizeof(lanes)) {
+    ut64_t w[4];
+
+    (void)builtin_memcpy(w, p, sizeof(w));
+    lanes[0] = checksum_mix(lanes[0], w[0]);
+    lanes[1] = checksum_mix(lanes[1], w[1]);
+    lanes[2] = checksum_mix(lanes[2], w[2]);
+    lanes[3] = checksum_mix(lanes[3], w[3]);
+    p += sizeof(w);
+    n -= sizeof(w);
+  }
+
+  ut64_t h = lanes[0];
+
+  h = checksum_mix(h, lanes[1]);
+  h = checksum_mix(h, lanes[2]);
+  h = checksum_mix(h, lanes[3]);
+
+  while (n--) {
+    h = (h ^ *p++) * FNV_PRIME;
+  }
+
+  return (h ^ (h >> 32));
+}
+
+static bool write_full(int fd, const void *buf, size_t n) {
+  const char *p = buf;
+
+  while (n) {
+    ssize_t ret = write(fd, p, n);
+
+    if (ret == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return (false);
+    }
+
+    p += ret;
+    n -= ret;
+  }
+
+  return (true);
+}
+
+static bool read_full(int fd, void *buf, size_t n) {
+  char *p = buf;
+
+  while (n) {
+    ssize_t ret = read(fd, p, n);
+
+    if (ret == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return (false);
+    }
+
+    if (ret == 0) {
+      return (false);
+    }
+
+    p += ret;
+    n -= ret;
+  }
+
+  return (true);
+}
+
+static void snapshot_header_init(snapshot_header_t *header,
+                                 const array_t *self) {
+  (void)builtin_memset(header, 0x00, sizeof(*header));
+  header->_magic = SNAPSHOT_MAGIC;
+  header->_version = SNAPSHOT_VERSION;
+  header->_elt_size = self->_elt_size;
+  header->_nmemb = self->_nmemb;
+  header->_checksum = snapshot_checksum(self->_ptr, array_sizeof(self));
+}
+
+/* Returns the size of the elements described by 'header', or SIZE_MAX if
+ * the header is not valid.
+ */
+static size_t snapshot_header_check(const snapshot_header_t *header) {
+  if (header->_magic != SNAPSHOT_MAGIC ||
+      header->_version != SNAPSHOT_VERSION || header->_elt_size == 0 ||
+      !SIZE_T_SAFE_TO_MUL(header->_nmemb, header->_elt_size)) {
+    return (SIZE_MAX);
+  }
+
+  return (header->_nmemb * header->_elt_size);
+}
+
+/* Hands the 'bytes' bytes of 'buffer' over to a new array, once they are
+ * checked against the header.
+ */
+static array_t *snapshot_seize(const array_allocator_t *allocator,
+                               const snapshot_header_t *header, void *buffer,
+                               size_t bytes) {
+  array_t *self = NULL;
+
+  if (likely(snapshot_checksum(buffer, bytes) == header->_checksum)) {
+    self = array_seize_buffer_with_allocator(allocator, (void **)buffer, bytes,
+                                             header->_elt_size,
+                                             header->_nmemb, NULL);
+  }
+
+  if (unlikely(!self)) {
+    _allocator_free(allocator, buffer);
+  }
+
+  return (self);
+}
+
+__attr_pure size_t array_dump_size(const array_t *self) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  return (sizeof(snapshot_header_t) + array_sizeof(self));
+}
+
+bool array_dump(const array_t *self, int fd) {
+  HR_COMPLAIN_IF(self == NULL);
+
+  snapshot_header_t header;
+
+  snapshot_header_init(&header, self);
+
+  return (write_full(fd, &header, sizeof(header)) &&
+          write_full(fd, self->_ptr, array_sizeof(self)));
+}
+
+size_t array_dump_to_buffer(const array_t *self, void *buf, size_t bufsize) {
+  HR_COMPLAIN_IF(self == NULL);
+  HR_COMPLAIN_IF(buf == NULL);
+
+  size_t size = array_dump_size(self);
+
+  if (bufsize < size) {
+    return (0);
+  }
+
+  snapshot_header_init(buf, self);
+  (void)builtin_memcpy((char *)buf + sizeof(snapshot_header_t), self->_ptr,
+                       array_sizeof(self));
+
+  return (size);
+}
+
+array_t *array_load(int fd) {
+  return (array_load_with_allocator(&__array_allocator__, fd));
+}
+
+array_t *array_load_with_allocator(const array_allocator_t *allocator, int fd) {
+  HR_COMPLAIN_IF(allocator == NULL);
+
+  snapshot_header_t header;
+
+  if (unlikely(!read_full(fd, &header, sizeof(header)))) {
+    return (NULL);
+  }
+
+  size_t bytes = snapshot_header_check(&header);
+
+  if (unlikely(bytes == SIZE_MAX)) {
+    return (NULL);
+  }
+
+  void *buffer = _allocator_alloc(allocator, MAX(bytes, 1));
+
+  if (unlikely(!buffer)) {
+    return (NULL);
+  }
+
+  if (unlikely(!read_full(fd, buffer, bytes))) {
+    _allocator_free(allocator, buffer);
+    return (NULL);
+  }
+
+  return (snapshot_seize(allocator, &header, buffer, bytes));
+}
+
+array_t *array_load_from_buffer(const void *buf, size_t bufsize) {
+  HR_COMPLAIN_IF(buf == NULL);
+
+  snapshot_header_t header;
+
+  if (unlikely(bufsize < sizeof(header))) {
+    return (NULL);
+  }
+
+  (void)builtin_memcpy(&header, buf, sizeof(header));
+
+  size_t bytes = snapshot_header_check(&header);
+
+  if (unlikely(bytes == SIZE_MAX || bufsize - sizeof(header) < bytes)) {
+    return (NULL);
+  }
+
+  void *buffer = _allocator_alloc(&__array_allocator__, MAX(bytes, 1));
+
+  if (unlikely(!buffer)) {
+    return (NULL);
+  }
+
+  (void)builtin_memcpy(buffer, (const char *)buf + sizeof(header), bytes);
+
+  return (snapshot_seize(&__array_allocator__, &header, buffer, bytes));
+}
+
+array_t *array_load_mapped(const char *path, bool verify) {
+  HR_COMPLAIN_IF(path == NULL);
+
+  int fd = open(path, O_RDONLY);
+  struct stat st;
+  char *base = NULL;
+  size_t size = 0;
+
+  if (unlikely(fd == -1)) {
+    return (NULL);
+  }
+
+  if (unlikely(fstat(fd, &st) == -1 ||
+               (size_t)st.st_size < sizeof(snapshot_header_t))) {
+    goto error;
+  }
+
+  size = (size_t)st.st_size;
+  base = pages_map_file(fd, size, false);
+
+  if (unlikely(!base)) {
+    goto error;
+  }
+
+  const snapshot_header_t *header = (const snapshot_header_t *)base;
+  size_t bytes = snapshot_header_check(header);
+
+  if (unlikely(bytes == SIZE_MAX || size - sizeof(*header) < bytes)) {
+    goto error;
+  }
+
+  if (verify &&
+      snapshot_checksum(base + sizeof(*header), bytes) != header->_checksum) {
+    goto error;
+  }
+
+  array_t *self = _allocator_alloc(&__array_allocator__, sizeof(*self));
+
+  if (unlikely(!self)) {
+    goto error;
+  }
+
+  (void)builtin_memset(self, 0x00, sizeof(*self));
+  _allocator(self) = &__array_allocator__;
+  _data(self) = base + sizeof(*header);
+  _capacity(self) = bytes;
+  _size(self) = header->_nmemb;
+  _typesize(self) = header->_elt_size;
+  _storage(self) = ARRAY_STORAGE_FILE;
+  _fd(self) = fd;
+  _is_owner(self) = false;
+  _settled(self) = true;
+
+  return (self);
+
+error:
+  if (base) {
+    pages_unmap(base, size);
+  }
+  (void)close(fd);
+  return (NULL);
+}
+
+bool dynstr_dump(const dynstr_t *self, int fd) {
+  return (array_dump((const array_t *)self, fd));
+}
+
+dynstr_t *dynstr_load(int fd) {
+  array_t *self = array_load(fd);
+
+  if (self && (_typesize(self) != sizeof(char) || _size(self) == 0 ||
+               ((char *)_data(self))[_size(self) - 1] != '\0')) {
+    array_kill(self);
+    return (NULL);
+  }
+
+  return ((dynstr_t *)self);
+}
@@ -0,0 +1,68 @@
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+
+#include "array.h"
+#include "dynstr.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SNAPSHOT_MAGIC 0x544e4f43 /* "CONT" */
+#define SNAPSHOT_VERSION 1
+
+/* A snapshot is this header followed by the raw elements of the array.
+ * Everything is stored in the byte order of the machine that made it, a
+ * snapshot from a machine of a different byte order is refused.
+ */
+typedef struct {
+  ut32_t _magic;    /* SNAPSHOT_MAGIC */
+  ut16_t _version;  /* SNAPSHOT_VERSION */
+  ut16_t _reserved; /* Must be 0 */
+  ut64_t _elt_size; /* The size of one element (in bytes) */
+  ut64_t _nmemb;    /* The number of elements */
+  ut64_t _checksum; /* The checksum of the elements (see 'snapshot_checksum') */
+  ut8_t _padding[32];
+} snapshot_header_t;
+
+/* Returns the checksum of the 'n' bytes pointed to by 'data'.
+ */
+__attr_pure ut64_t snapshot_checksum(const void *data, size_t n);
+
+/* Returns the number of bytes a snapshot of 'self' takes.
+ */
+__attr_pure size_t array_dump_size(const array_t *self);
+
+/* Writes a snapshot of 'self' to the file descriptor 'fd'.
+ */
+bool array_dump(const array_t *self, int fd);
+
+/* Writes a snapshot of 'self' into 'buf', returns the number of bytes
+ * written, or 0 if 'bufsize' is too small.
+ */
+size_t array_dump_to_buffer(const array_t *self, void *buf, size_t bufsize);
+
+/* Reads a snapshot from the file descriptor 'fd' into a new array, the
+ * elements are read at once into a buffer seized by the array. Returns
+ * NULL if the snapshot is truncated or corrupted. The elements are not
+ * given a destructor.
+ */
+array_t *array_load(int fd);
+
+array_t *array_load_with_allocator(const array_allocator_t *allocator, int fd);
+
+/* Same as 'load', from the 'bufsize' bytes pointed to by 'buf'.
+ */
+array_t *array_load_from_buffer(const void *buf, size_t bufsize);
+
+/* Opens the snapshot file at 'path' as a read-only array whose buffer is a
+ * mapping of the file, so nothing is read until the elements are accessed.
+ * The checksum is only verified if 'verify' is true, as it touches every
+ * page of the file.
+ */
+array_t *array_load_mapped(const char *path, bool verify);
+
+/* Same as the array functions, for dynamic strings.
+ */
+bool dynstr_dump(const dynstr_t *self, int fd);
+dynstr_t *dynstr_load(int fd);
+
+#endif /* __SNAPSHOT_H__ */
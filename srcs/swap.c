@@ -0,0 +1,182 @@
+#include "swap.h"
+#include "cpu.h"
+#include "internal.h"
+#include <stddef.h>
+#include <stdint.h>
+
+static void swap_4(void *a, void *b, size_t size) {
+  ut32_t x;
+  ut32_t y;
+
+  (void)size;
+  (void)builtin_memcpy(&x, a, sizeof(x));
+  (void)builtin_memcpy(&y, b, sizeof(y));
+  (void)builtin_memcpy(a, &y, sizeof(y));
+  (void)builtin_memcpy(b, &x, sizeof(x));
+}
+
+static void swap_8(void *a, void *b, size_t size) {
+  ut64_t x;
+  ut64_t y;
+
+  (void)size;
+  (void)builtin_memcpy(&x, a, sizeof(x));
+  (void)builtin_memcpy(&y, b, sizeof(y));
+  (void)builtin_memcpy(a, &y, sizeof(y));
+  (void)builtin_memcpy(b, &x, sizeof(x));
+}
+
+/* Word by word, then byte by byte for the tail. */
+static void swap_words(void *a, void *b, size_t size) {
+  char *p = a;
+  char *q = b;
+
+  for (; size >= sizeof(ut64_t); size -= sizeof(ut64_t)) {
+    swap_8(p, q, sizeof(ut64_t));
+    p += sizeof(ut64_t);
+    q += sizeof(ut64_t);
+  }
+
+  while (size--) {
+    char c = *p;
+
+    *p++ = *q;
+    *q++ = c;
+  }
+}
+
+static void swap_16_words(void *a, void *b, size_t size) {
+  swap_words(a, b, size);
+}
+
+static void swap_32_words(void *a, void *b, size_t size) {
+  swap_words(a, b, size);
+}
+
+#ifdef CPU_X86
+
+__attribute__((target("sse2"))) static void swap_16_sse2(void *a, void *b,
+                                                         size_t size) {
+  __m128i x = _mm_loadu_si128((const __m128i *)a);
+  __m128i y = _mm_loadu_si128((const __m128i *)b);
+
+  (void)size;
+  _mm_storeu_si128((__m128i *)a, y);
+  _mm_storeu_si128((__m128i *)b, x);
+}
+
+__attribute__((target("sse2"))) static void swap_32_sse2(void *a, void *b,
+                                                         size_t size) {
+  swap_16_sse2(a, b, 16);
+  swap_16_sse2((char *)a + 16, (char *)b + 16, size - 16);
+}
+
+__attribute__((target("sse2"))) static void swap_bytes_sse2(void *a, void *b,
+                                                            size_t size) {
+  char *p = a;
+  char *q = b;
+
+  for (; size >= 16; size -= 16, p += 16, q += 16) {
+    swap_16_sse2(p, q, 16);
+  }
+  swap_words(p, q, size);
+}
+
+__attribute__((target("avx2"))) static void swap_32_avx2(void *a, void *b,
+                                                         size_t size) {
+  __m256i x = _mm256_loadu_si256((const __m256i *)a);
+  __m256i y = _mm256_loadu_si256((const __m256i *)b);
+
+  (void)size;
+  _mm256_storeu_si256((__m256i *)a, y);
+  _mm256_storeu_si256((__m256i *)b, x);
+}
+
+__attribute__((target("avx2"))) static void swap_bytes_avx2(void *a, void *b,
+                                                            size_t size) {
+  char *p = a;
+  char *q = b;
+
+  for (; size >= 32; size -= 32, p += 32, q += 32) {
+    swap_32_avx2(p, q, 32);
+  }
+  if (size >= 16) {
+    swap_16_sse2(p, q, 16);
+    size -= 16, p += 16, q += 16;
+  }
+  swap_words(p, q, size);
+}
+
+#endif /* CPU_X86 */
+
+static swap_kernel_t swap_16 = &swap_16_words;
+static swap_kernel_t swap_32 = &swap_32_words;
+static swap_kernel_t swap_any = &swap_words;
+
+__attribute__((constructor)) static void swap_select_kernels(void) {
+#ifdef CPU_X86
+  unsigned int features = cpu_features();
+
+  if (features & CPU_SSE2) {
+    swap_16 = &swap_16_sse2;
+    swap_32 = &swap_32_sse2;
+    swap_any = &swap_bytes_sse2;
+  }
+  if (features & CPU_AVX2) {
+    swap_32 = &swap_32_avx2;
+    swap_any = &swap_bytes_avx2;
+  }
+#endif
+}
+
+__attr_pure swap_kernel_t swap_kernel(size_t size) {
+  switch (size) {
+  case 4:
+    return (&swap_4);
+  case 8:
+    return (&swap_8);
+  case 16:
+    return (swap_16);
+  case 32:
+    return (swap_32);
+  default:
+    return (size < 16 ? &swap_words : swap_any);
+  }
+}
+
+void swap_bytes(void *a, void *b, size_t size) {
+  if (likely(a != b)) {
+    swap_any(a, b, size);
+  }
+}
+
+void swap_reverse(void *base, size_t n, size_t size) {
+  swap_kernel_t swap = swap_kernel(size);
+  char *lo = base;
+  char *hi = (char *)base + (n ? n - 1 : 0) * size;
+
+  for (; lo < hi; lo += size, hi -= size) {
+    swap(lo, hi, size);
+  }
+}
+
+void swap_rotate(void *base, size_t n, size_t k, size_t size) {
+  HR_COMPLAIN_IF(k > n);
+
+  char *p = base;
+  size_t left = k * size;        /* [p, p + left) goes to the end */
+  size_t right = (n - k) * size; /* [p + left, p + left + right) goes first */
+
+  while (left && right) {
+    if (left <= right) {
+      /* [A][B1][B2] -> [B2][B1][A], A is in place */
+      swap_any(p, p + right, left);
+      right -= left;
+    } else {
+      /* [A1][A2][B] -> [B][A2][A1], B is in place */
+      swap_any(p, p + left, right);
+      p += right;
+      left -= right;
+    }
+  }
+}
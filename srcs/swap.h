@@ -0,0 +1,37 @@
+#ifndef __SWAP_H__
+#define __SWAP_H__
+
+#include "internal.h"
+#include <stddef.h>
+
+/* Element move kernels. The wide versions (SSE2, AVX2) are picked once at
+ * startup from the features of the CPU the library runs on.
+ */
+
+/* Swaps the 'size' bytes at 'a' with the 'size' bytes at 'b'.
+ */
+typedef void (*swap_kernel_t)(void *a, void *b, size_t size);
+
+/* Returns the fastest kernel for elements of 'size' bytes: sizes 4, 8, 16
+ * and 32 get a dedicated one, the other sizes go through 'swap_bytes'.
+ * Callers swapping many elements should get the kernel once and reuse it.
+ */
+__attr_pure swap_kernel_t swap_kernel(size_t size);
+
+/* Swaps two ranges of 'size' bytes, which must not overlap (unless they are
+ * the same).
+ */
+void swap_bytes(void *a, void *b, size_t size);
+
+/* Reverses the order of the 'n' elements of 'size' bytes starting at
+ * 'base'.
+ */
+void swap_reverse(void *base, size_t n, size_t size);
+
+/* Rotates the 'n' elements of 'size' bytes starting at 'base' so that the
+ * element at position 'k' comes first. Whole blocks of elements are swapped
+ * at once (Gries-Mills block swap), every element moves once or twice.
+ */
+void swap_rotate(void *base, size_t n, size_t k, size_t size);
+
+#endif /* __SWAP_H__ */
@@ -0,0 +1,99 @@
+#include "arena.h"
+#include "array.h"
+#include "dynstr.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+static bool __test_001__(void) {
+  arena_t *arena = arena_create(256);
+
+  void *a = arena_alloc(arena, 10);
+  void *b = arena_alloc(arena, 10);
+  assert(a && b && a != b);
+  assert((uintptr_t)a % 16 == 0);
+  assert((uintptr_t)b % 16 == 0);
+
+  /* 'b' is the last allocation, it grows in place */
+  memset(b, 'x', 10);
+  void *c = arena_realloc(arena, b, 100);
+  assert(c == b);
+  assert(!memcmp(c, "xxxxxxxxxx", 10));
+
+  /* 'a' is not, it moves and keeps its content */
+  memset(a, 'y', 10);
+  void *d = arena_realloc(arena, a, 100);
+  assert(d != a);
+  assert(!memcmp(d, "yyyyyyyyyy", 10));
+
+  /* bigger than a chunk */
+  void *e = arena_alloc(arena, 4096);
+  assert(e);
+  memset(e, 0, 4096);
+
+  arena_kill(arena);
+  return (true);
+}
+
+static bool __test_002__(void) {
+  arena_t *arena = arena_create(0);
+
+  (void)arena_alloc(arena, 32);
+  size_t used = arena_used(arena);
+  arena_mark_t mark = arena_mark(arena);
+
+  for (int i = 0; i < 1000; i++)
+    assert(arena_alloc(arena, 128));
+  assert(arena_used(arena) > used);
+
+  arena_rewind(arena, mark);
+  assert(arena_used(arena) == used);
+
+  void *a = arena_alloc(arena, 8);
+  arena_free(arena, a);
+  assert(arena_used(arena) == used);
+
+  arena_reset(arena);
+  assert(arena_used(arena) == 0);
+
+  arena_kill(arena);
+  return (true);
+}
+
+static bool __test_003__(void) {
+  arena_t *arena = arena_create(1024);
+  const array_allocator_t *allocator = arena_allocator(arena);
+
+  for (int round = 0; round < 10; round++) {
+    arena_mark_t mark = arena_mark(arena);
+    array_t *v = array_create_with_allocator(allocator, sizeof(int32_t), 0, NULL);
+    dynstr_t *s = dynstr_assign_with_allocator(allocator, "hello", -1);
+
+    for (int32_t i = 0; i < 1000; i++)
+      assert(array_push(v, &i));
+    assert(dynstr_append(s, " world", -1));
+
+    for (int32_t i = 0; i < 1000; i++)
+      assert(*(int32_t *)array_at(v, i) == i);
+    ASSERT_STR_EQUAL(s->_ptr, "hello world");
+
+    /* no kill, the whole request is dropped at once */
+    arena_rewind(arena, mark);
+    assert(arena_used(arena) == 0);
+  }
+
+  arena_kill(arena);
+  return (true);
+}
+
+TEST_FUNCTION void arena_basic_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "arena alloc/realloc");
+  run_test(&__test_002__, "arena mark/rewind/reset");
+  run_test(&__test_003__, "arena backed array and dynstr");
+
+  __test_end__;
+}
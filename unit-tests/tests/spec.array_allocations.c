@@ -1,13 +1,208 @@
 #include "array.h"
+#include "dynstr.h"
 #include "unit_tests.h"
 #include "internal.h"
+#include "pages.h"
 #include <assert.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
 #include <unistd.h>
 
+typedef struct {
+	size_t allocs;
+	size_t reallocs;
+	size_t frees;
+} counting_ctx_t;
+
+static void *counting_alloc(void *ctx, size_t n) {
+	((counting_ctx_t *)ctx)->allocs++;
+	return (malloc(n));
+}
+
+static void *counting_realloc(void *ctx, void *ptr, size_t n) {
+	((counting_ctx_t *)ctx)->reallocs++;
+	return (realloc(ptr, n));
+}
+
+static void counting_free(void *ctx, void *ptr) {
+	((counting_ctx_t *)ctx)->frees++;
+	free(ptr);
+}
+
 static bool __test_001__(void) {
+	array_t *v = array_create(sizeof(int32_t), 0, NULL);
+
+	assert(v);
+	assert(array_allocator(v) == &__array_allocator__);
+	assert(array_cap(v) == ARRAY_INITIAL_SIZE * sizeof(int32_t));
+	assert(array_size(v) == 0);
+
+	array_kill(v);
+	return (true);
+}
+
+static bool __test_002__(void) {
+	counting_ctx_t ctx = {0};
+	array_allocator_t allocator = {
+		._memory_alloc = counting_alloc,
+		._memory_realloc = counting_realloc,
+		._memory_free = counting_free,
+		._ctx = &ctx,
+	};
+	array_t *v = array_create_with_allocator(&allocator, sizeof(int64_t), 1, NULL);
+
+	assert(v);
+	assert(ctx.allocs == 1);
+	for (int64_t i = 0; i < 100; i++)
+		assert(array_push(v, &i));
+	assert(ctx.reallocs > 0);
+
+	array_t *pull = array_pull(v, 0, 9);
+	assert(array_allocator(pull) == &allocator);
+	assert(ctx.allocs == 4);
+	array_kill(pull);
+
+	array_kill(v);
+	assert(ctx.frees == ctx.allocs);
+	return (true);
+}
+
+static bool __test_003__(void) {
+	counting_ctx_t ctx = {0};
+	array_allocator_t allocator = {
+		._memory_alloc = counting_alloc,
+		._memory_realloc = counting_realloc,
+		._memory_free = counting_free,
+		._ctx = &ctx,
+	};
+	int32_t buf[4] = {1, 2, 3, 4};
+	array_t *v = array_borrow_buffer_with_allocator(&allocator, (void **)&buf,
+		sizeof(buf), sizeof(int32_t), 4, NULL);
+
+	assert(v);
+	assert(ctx.allocs == 1);
+	assert(*(int32_t *)array_at(v, 3) == 4);
+	array_kill(v);
+	assert(ctx.frees == 1);
+	return (true);
+}
+
+static bool __test_004__(void) {
+	counting_ctx_t ctx = {0};
+	array_allocator_t allocator = {
+		._memory_alloc = counting_alloc,
+		._memory_realloc = counting_realloc,
+		._memory_free = counting_free,
+		._ctx = &ctx,
+	};
+	array_t *v = array_create_inline_with_allocator(&allocator, sizeof(int32_t), 4, NULL);
+
+	assert(v);
+	assert(ctx.allocs == 1);
+	assert(v->_storage == ARRAY_STORAGE_INLINE);
+	assert((char *)v->_ptr > (char *)v);
+	for (int32_t i = 0; i < 3; i++)
+		assert(array_push(v, &i));
+	assert(ctx.allocs == 1);
+
+	/* outgrows the inline buffer */
+	for (int32_t i = 3; i < 100; i++)
+		assert(array_push(v, &i));
+	assert(v->_storage == ARRAY_STORAGE_SEPARATE);
+	for (int32_t i = 0; i < 100; i++)
+		assert(*(int32_t *)array_at(v, i) == i);
+
+	array_kill(v);
+	assert(ctx.frees == ctx.allocs);
+	return (true);
+}
+
+static bool __test_005__(void) {
+	counting_ctx_t ctx = {0};
+	array_allocator_t allocator = {
+		._memory_alloc = counting_alloc,
+		._memory_realloc = counting_realloc,
+		._memory_free = counting_free,
+		._ctx = &ctx,
+	};
+	array_t *v = array_create_with_allocator(&allocator, sizeof(void *), 8, NULL);
+
+	assert(v->_storage == ARRAY_STORAGE_INLINE);
+	assert(ctx.allocs == 1);
+	array_kill(v);
+	assert(ctx.frees == 1);
+
+	v = array_create_with_allocator(&allocator, sizeof(void *), 9, NULL);
+	assert(v->_storage == ARRAY_STORAGE_SEPARATE);
+	array_kill(v);
+
+	dynstr_t *str = dynstr_assign_with_allocator(&allocator, "small string", -1);
+	assert(((array_t *)str)->_storage == ARRAY_STORAGE_INLINE);
+	assert(dynstr_append(str, ", now spilling to the heap through adjust", -1));
+	assert(((array_t *)str)->_storage == ARRAY_STORAGE_SEPARATE);
+	ASSERT_STR_EQUAL(str->_ptr, "small string, now spilling to the heap through adjust");
+	dynstr_kill(str);
+
+	assert(ctx.frees == ctx.allocs);
+	return (true);
+}
+
+static bool __test_006__(void) {
+	const array_growth_t policies[] = {
+		ARRAY_GROWTH_DOUBLE, ARRAY_GROWTH_HALF, ARRAY_GROWTH_CHUNK, ARRAY_GROWTH_PAGES
+	};
+	size_t reallocs[4];
+
+	for (size_t p = 0; p < 4; p++) {
+		array_t *v = array_create(sizeof(int32_t), 0, NULL);
+		array_set_growth(v, policies[p], 1000);
+
+		for (int32_t i = 0; i < 100000; i++)
+			assert(array_push(v, &i));
+		for (int32_t i = 0; i < 100000; i++)
+			assert(*(int32_t *)array_at(v, i) == i);
+
+		array_stats_t stats = array_stats(v);
+		assert(stats._used == 100000 * sizeof(int32_t));
+		assert(stats._cap == array_cap(v));
+		assert(stats._slack == stats._cap - stats._used);
+		if (policies[p] == ARRAY_GROWTH_PAGES)
+			assert(stats._cap % ARRAY_PAGE_SIZE == 0);
+		if (policies[p] == ARRAY_GROWTH_CHUNK)
+			assert(stats._slack < 1000 * sizeof(int32_t));
+		reallocs[p] = stats._reallocs;
+		array_kill(v);
+	}
+	assert(reallocs[0] < reallocs[1]);
+	assert(reallocs[1] < reallocs[2]);
+	return (true);
+}
+
+static bool __test_007__(void) {
+	static char block[1 << 20];
+	array_t *v = array_create(sizeof(char), 0, NULL);
+	size_t n = ARRAY_MMAP_THRESHOLD / sizeof(block) + 4;
+
+	for (size_t i = 0; i < n; i++) {
+		memset(block, (int)i, sizeof(block));
+		assert(array_append(v, block, sizeof(block)));
+	}
+	assert(v->_storage == ARRAY_STORAGE_MAPPED);
+	assert(array_cap(v) % ARRAY_PAGE_SIZE == 0);
+	for (size_t i = 0; i < n; i++)
+		assert(*(char *)array_at(v, i * sizeof(block) + 1234) == (char)i);
+
+	array_wipe(v, sizeof(block), n * sizeof(block));
+	assert(array_size(v) == sizeof(block));
+	assert(array_slimcheck(v));
+	assert(array_cap(v) == sizeof(block));
+	assert(*(char *)array_at(v, 0) == 0);
+
+	assert(array_append(v, block, sizeof(block)));
+	assert(*(char *)array_tail(v) == (char)(n - 1));
+
+	array_kill(v);
 	return (true);
 }
 
@@ -15,6 +210,12 @@ TEST_FUNCTION void array_allocations_specs(void) {
 	__test_start__;
 
 	run_test(&__test_001__, "array initial alloc");
+	run_test(&__test_002__, "array custom allocator");
+	run_test(&__test_003__, "array borrow with allocator");
+	run_test(&__test_004__, "array inline buffer");
+	run_test(&__test_005__, "small buffer optimization");
+	run_test(&__test_006__, "growth policies");
+	run_test(&__test_007__, "mmap backed huge buffer");
 
 	__test_end__;
 }
@@ -0,0 +1,113 @@
+#include "array.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+static array_t *range(size_t n) {
+  array_t *arr = array_create(sizeof(int32_t), n, NULL);
+
+  for (int32_t i = 0; i < (int32_t)n; i++)
+    assert(array_push(arr, &i));
+  return (arr);
+}
+
+static bool keep_some(const void *e) {
+  int32_t x = *(const int32_t *)e;
+
+  return (x % 3 == 0 || (x / 100) % 2);
+}
+
+static void keep_some_batch(const void *elems, size_t n, uint64_t *keep) {
+  const int32_t *x = elems;
+
+  for (size_t i = 0; i < n; i++)
+    if (x[i] % 3 == 0 || (x[i] / 100) % 2)
+      keep[i / 64] |= (uint64_t)1 << (i % 64);
+}
+
+static void keep_all_batch(const void *elems, size_t n, uint64_t *keep) {
+  (void)elems;
+  /* sets more bits than needed on purpose */
+  memset(keep, 0xff, (n + 63) / 64 * sizeof(*keep));
+}
+
+static size_t find_1234(const void *elems, size_t n) {
+  const int32_t *x = elems;
+
+  for (size_t i = 0; i < n; i++)
+    if (x[i] == 1234)
+      return (i);
+  return (n);
+}
+
+static size_t find_nothing(const void *elems, size_t n) {
+  (void)elems;
+  return (n);
+}
+
+static bool negate_batch(void *elems, size_t n) {
+  int32_t *x = elems;
+
+  for (size_t i = 0; i < n; i++)
+    x[i] = -x[i];
+  return (true);
+}
+
+static bool stop_batch(void *elems, size_t n) {
+  (void)elems;
+  (void)n;
+  return (false);
+}
+
+static bool __test_001__(void) {
+  static const size_t sizes[] = {0, 1, 63, 64, 65, 256, 1000, 10001};
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(*sizes); s++) {
+    array_t *arr = range(sizes[s]);
+    array_t *expected = array_filter(arr, &keep_some);
+    array_t *filtered = array_filter_batch(arr, &keep_some_batch);
+    array_t *all = array_filter_batch(arr, &keep_all_batch);
+
+    assert(array_size(filtered) == array_size(expected));
+    assert(!array_size(expected) ||
+           memcmp(array_data(filtered), array_data(expected),
+                  array_sizeof(expected)) == 0);
+    assert(array_size(all) == sizes[s]);
+    assert(!sizes[s] ||
+           memcmp(array_data(all), array_data(arr), array_sizeof(arr)) == 0);
+
+    array_kill(all);
+    array_kill(filtered);
+    array_kill(expected);
+    array_kill(arr);
+  }
+  return (true);
+}
+
+static bool __test_002__(void) {
+  array_t *arr = range(5000);
+
+  assert(array_find_index_batch(arr, &find_1234) == 1234);
+  assert(*(int32_t *)array_find_batch(arr, &find_1234) == 1234);
+  assert(array_find_index_batch(arr, &find_nothing) == -1);
+  assert(!array_find_batch(arr, &find_nothing));
+
+  assert(array_foreach_batch(arr, &negate_batch));
+  for (size_t i = 0; i < array_size(arr); i++)
+    assert(*(int32_t *)array_at(arr, i) == -(int32_t)i);
+  assert(!array_foreach_batch(arr, &stop_batch));
+
+  array_kill(arr);
+  return (true);
+}
+
+TEST_FUNCTION void array_batch_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "batch filter matches filter");
+  run_test(&__test_002__, "batch find and foreach");
+
+  __test_end__;
+}
@@ -0,0 +1,188 @@
+#include "array.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WORKERS 4
+#define PER_WORKER 20000
+
+typedef struct {
+  array_appender_t *app;
+  int64_t id;
+} worker_t;
+
+static void *worker(void *arg) {
+  worker_t *w = arg;
+  int64_t batch[5];
+
+  for (int64_t i = 0; i < PER_WORKER; i += 5) {
+    for (int64_t j = 0; j < 5; j++)
+      batch[j] = w->id * PER_WORKER + i + j;
+    assert(array_append_concurrent(w->app, batch, 5));
+  }
+  return (NULL);
+}
+
+static bool __test_001__(void) {
+  array_t *arr = array_create(sizeof(int64_t), 4, NULL);
+  array_appender_t *app;
+  pthread_t threads[WORKERS];
+  worker_t workers[WORKERS];
+  char *seen;
+
+  assert(array_push(arr, &(int64_t){-1}));
+  app = array_appender_begin(arr);
+  for (int64_t i = 0; i < WORKERS; i++) {
+    workers[i] = (worker_t){app, i};
+    assert(pthread_create(&threads[i], NULL, &worker, &workers[i]) == 0);
+  }
+  for (int64_t i = 0; i < WORKERS; i++)
+    assert(pthread_join(threads[i], NULL) == 0);
+  array_appender_end(app);
+
+  assert(array_size(arr) == WORKERS * PER_WORKER + 1);
+  assert(*(int64_t *)array_at(arr, 0) == -1);
+
+  /* every element made it exactly once, and batches stayed contiguous */
+  seen = calloc(WORKERS * PER_WORKER, 1);
+  for (size_t i = 1; i < array_size(arr); i++) {
+    int64_t x = *(int64_t *)array_at(arr, i);
+
+    assert(x >= 0 && x < WORKERS * PER_WORKER && !seen[x]);
+    seen[x] = 1;
+    if (x % 5)
+      assert(*(int64_t *)array_at(arr, i - 1) == x - 1);
+  }
+  free(seen);
+
+  array_kill(arr);
+  return (true);
+}
+
+static bool __test_002__(void) {
+  array_t *arr = array_create(sizeof(int32_t), 100, NULL);
+  array_appender_t *app;
+  size_t cap = array_cap(arr) / sizeof(int32_t);
+  size_t index;
+  int32_t *slots;
+
+  /* a settled array only hands out the slots it already has */
+  array_settle(arr);
+  app = array_appender_begin(arr);
+  slots = array_reserve_concurrent(app, 10, &index);
+  assert(slots && index == 0);
+  for (int32_t i = 0; i < 10; i++)
+    slots[i] = i;
+  array_commit_concurrent(app);
+
+  while (array_append_concurrent(app, &(int32_t){42}, 1))
+    ;
+  assert(!array_reserve_concurrent(app, 1, NULL));
+  array_appender_end(app);
+
+  assert(array_size(arr) == cap);
+  assert(*(int32_t *)array_at(arr, 9) == 9);
+  assert(*(int32_t *)array_at(arr, cap - 1) == 42);
+
+  array_kill(arr);
+  return (true);
+}
+
+static bool __test_003__(void) {
+  array_t *arr = array_create(sizeof(int64_t), 0, NULL);
+  array_appender_t *app = array_appender_begin(arr);
+  int64_t *old = array_reserve_concurrent(app, 1, NULL);
+
+  *old = 7;
+  array_commit_concurrent(app);
+
+  /* the buffer is replaced, but the old one stays readable until the
+   * session ends */
+  for (int64_t i = 0; i < 1000; i++)
+    assert(array_append_concurrent(app, &i, 1));
+  assert(arr->_ptr != (void *)old);
+  assert(*old == 7);
+  assert(array_stats(arr)._reallocs > 0);
+
+  array_appender_end(app);
+  assert(array_size(arr) == 1001);
+  assert(*(int64_t *)array_at(arr, 1000) == 999);
+
+  array_kill(arr);
+  return (true);
+}
+
+#if defined(ARRAY_SPEC_HOOKS)
+/* Only in the debug library, see array.c. */
+extern void (*__array_appender_hook__)(array_appender_t *app);
+
+static pthread_t late_grower;
+static atomic_bool late_grower_waiting;
+static atomic_bool buffer_grown;
+
+/* Holds back 'late_grower' between its overflow and its attempt to grow,
+ * until another thread has grown the buffer in the meantime. */
+static void hold_late_grower(array_appender_t *app) {
+  (void)app;
+  if (!pthread_equal(pthread_self(), late_grower))
+    return;
+  atomic_store(&late_grower_waiting, true);
+  while (!atomic_load(&buffer_grown))
+    sched_yield();
+}
+
+static void *late_append(void *arg) {
+  assert(array_append_concurrent(arg, &(int64_t){-2}, 1));
+  return (NULL);
+}
+
+static bool __test_004__(void) {
+  array_t *arr = array_create(sizeof(int64_t), 16, NULL);
+  size_t cap = array_cap(arr) / sizeof(int64_t);
+  array_appender_t *app = array_appender_begin(arr);
+
+  for (int64_t i = 0; i < (int64_t)cap; i++)
+    assert(array_append_concurrent(app, &i, 1));
+
+  /* a thread that overflowed only gets to grow once the buffer was already
+   * grown for it */
+  __array_appender_hook__ = &hold_late_grower;
+  assert(pthread_create(&late_grower, NULL, &late_append, app) == 0);
+  while (!atomic_load(&late_grower_waiting))
+    sched_yield();
+  assert(array_append_concurrent(app, &(int64_t){-1}, 1));
+  atomic_store(&buffer_grown, true);
+  assert(pthread_join(late_grower, NULL) == 0);
+  __array_appender_hook__ = NULL;
+
+  assert(atomic_load(&app->_cursor) == cap + 2);
+  array_appender_end(app);
+
+  assert(array_size(arr) == cap + 2);
+  for (size_t i = 0; i < cap; i++)
+    assert(*(int64_t *)array_at(arr, i) == (int64_t)i);
+  assert(*(int64_t *)array_at(arr, cap) + *(int64_t *)array_at(arr, cap + 1) ==
+         -3);
+
+  array_kill(arr);
+  return (true);
+}
+#endif /* defined(ARRAY_SPEC_HOOKS) */
+
+TEST_FUNCTION void array_concurrent_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "concurrent append from several threads");
+  run_test(&__test_002__, "concurrent append into a settled array");
+  run_test(&__test_003__, "old buffers outlive the growth");
+#if defined(ARRAY_SPEC_HOOKS)
+  run_test(&__test_004__, "late overflow after the buffer grew");
+#endif
+
+  __test_end__;
+}
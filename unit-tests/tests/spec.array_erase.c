@@ -0,0 +1,154 @@
+#include "array.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* The destructor records which elements it was given. */
+static bool freed[100];
+
+static void record_free(void *elem) {
+  int32_t x = *(int32_t *)elem;
+
+  assert(!freed[x]);
+  freed[x] = true;
+}
+
+static array_t *numbers(size_t n) {
+  array_t *arr = array_create(sizeof(int32_t), n, &record_free);
+
+  memset(freed, 0, sizeof(freed));
+  for (int32_t i = 0; i < (int32_t)n; i++)
+    assert(array_push(arr, &i));
+  return (arr);
+}
+
+static void assert_removed(const array_t *arr, size_t n, bool (*gone)(int32_t)) {
+  size_t k = 0;
+
+  for (int32_t i = 0; i < (int32_t)n; i++) {
+    assert(freed[i] == gone(i));
+    if (!gone(i))
+      assert(((int32_t *)arr->_ptr)[k++] == i);
+  }
+  assert(array_size(arr) == k);
+}
+
+static bool in_wiped_range(int32_t x) { return (x >= 40 && x < 60); }
+
+static bool __test_001__(void) {
+  array_t *arr = numbers(100);
+
+  /* the destructor runs on start -> end, not on the first elements */
+  array_wipe(arr, 40, 60);
+  assert_removed(arr, 100, &in_wiped_range);
+
+  arr->_free = NULL;
+  array_wipe(arr, 0, array_size(arr));
+  assert(array_size(arr) == 0);
+
+  array_kill(arr);
+  return (true);
+}
+
+static bool is_multiple_of_3(int32_t x) { return (x % 3 == 0); }
+
+static bool elem_is_multiple_of_3(const void *elem) {
+  return (is_multiple_of_3(*(const int32_t *)elem));
+}
+
+static bool always(const void *elem) {
+  (void)elem;
+  return (true);
+}
+
+static bool never(const void *elem) {
+  (void)elem;
+  return (false);
+}
+
+static bool __test_002__(void) {
+  array_t *arr = numbers(100);
+
+  assert(array_erase_if(arr, &elem_is_multiple_of_3) == 34);
+  assert_removed(arr, 100, &is_multiple_of_3);
+  array_kill(arr);
+
+  arr = numbers(10);
+  assert(array_erase_if(arr, &never) == 0);
+  assert(array_size(arr) == 10);
+  assert(array_erase_if(arr, &always) == 10);
+  assert(array_size(arr) == 0);
+  assert(array_erase_if(arr, &always) == 0);
+
+  array_kill(arr);
+  return (true);
+}
+
+static bool is_listed(int32_t x) {
+  return (x == 0 || x == 1 || x == 7 || x == 50 || x == 98 || x == 99);
+}
+
+static bool __test_003__(void) {
+  array_t *arr = numbers(100);
+  static const size_t indices[] = {0, 1, 7, 50, 98, 99};
+
+  array_remove_indices(arr, indices, sizeof(indices) / sizeof(*indices));
+  assert_removed(arr, 100, &is_listed);
+
+  /* nothing to remove */
+  array_remove_indices(arr, NULL, 0);
+  assert(array_size(arr) == 94);
+
+  array_kill(arr);
+  return (true);
+}
+
+static bool is_3_or_9(int32_t x) { return (x == 3 || x == 9); }
+
+static bool nothing(int32_t x) {
+  (void)x;
+  return (false);
+}
+
+static bool __test_004__(void) {
+  array_t *arr = numbers(20);
+  static const size_t unsorted[] = {3, 9, 5, 12};
+  static const size_t duplicated[] = {3, 9, 9, 12};
+  static const size_t out_of_range[] = {3, 9, 20, 12};
+  static const size_t first_out_of_range[] = {20, 3};
+
+  /* the removal stops at the first index out of order, or out of range */
+  array_remove_indices(arr, unsorted, 4);
+  assert_removed(arr, 20, &is_3_or_9);
+  array_kill(arr);
+
+  arr = numbers(20);
+  array_remove_indices(arr, duplicated, 4);
+  assert_removed(arr, 20, &is_3_or_9);
+  array_kill(arr);
+
+  arr = numbers(20);
+  array_remove_indices(arr, out_of_range, 4);
+  assert_removed(arr, 20, &is_3_or_9);
+  array_kill(arr);
+
+  arr = numbers(20);
+  array_remove_indices(arr, first_out_of_range, 2);
+  assert_removed(arr, 20, &nothing);
+
+  array_kill(arr);
+  return (true);
+}
+
+TEST_FUNCTION void array_erase_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "array_wipe destructor range");
+  run_test(&__test_002__, "array_erase_if");
+  run_test(&__test_003__, "array_remove_indices");
+  run_test(&__test_004__, "array_remove_indices with bad indices");
+
+  __test_end__;
+}
@@ -0,0 +1,83 @@
+#include "array.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef struct {
+  int64_t id;
+  double value;
+} record_t;
+
+static bool __test_001__(void) {
+  char path[] = "/tmp/spec.array_map_file.XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd != -1);
+  close(fd);
+
+  array_t *v = array_map_file(path, sizeof(record_t), ARRAY_MAP_RDWR);
+  assert(v);
+  assert(array_size(v) == 0);
+  assert(!array_is_settled(v));
+
+  for (int64_t i = 0; i < 10000; i++)
+    assert(array_push(v, &(record_t){.id = i, .value = i * 0.5}));
+  array_kill(v);
+
+  struct stat st;
+  assert(stat(path, &st) == 0);
+  assert((size_t)st.st_size == 10000 * sizeof(record_t));
+
+  v = array_map_file(path, sizeof(record_t), ARRAY_MAP_RDONLY);
+  assert(v);
+  assert(array_size(v) == 10000);
+  assert(array_is_settled(v));
+  assert(!v->_is_own_buffer);
+  for (int64_t i = 0; i < 10000; i++) {
+    const record_t *r = array_at(v, i);
+    assert(r->id == i && r->value == i * 0.5);
+  }
+  assert(!array_push(v, &(record_t){.id = -1, .value = 0}));
+  array_kill(v);
+
+  /* reopened for writing, modified in place and appended to */
+  v = array_map_file(path, sizeof(record_t), ARRAY_MAP_RDWR);
+  ((record_t *)array_access(v, 0))->id = 42;
+  assert(stat(path, &st) == 0);
+  assert((size_t)st.st_size == 10000 * sizeof(record_t));
+  assert(array_push(v, &(record_t){.id = 10000, .value = 0}));
+  array_kill(v);
+
+  v = array_map_file(path, sizeof(record_t), ARRAY_MAP_RDONLY);
+  assert(array_size(v) == 10001);
+  assert(((const record_t *)array_at(v, 0))->id == 42);
+  assert(((const record_t *)array_at(v, 10000))->id == 10000);
+  array_kill(v);
+
+  /* opening for writing leaves the file alone until it has to grow */
+  v = array_map_file(path, sizeof(record_t), ARRAY_MAP_RDWR);
+  array_kill(v);
+  assert(stat(path, &st) == 0);
+  assert((size_t)st.st_size == 10001 * sizeof(record_t));
+
+  unlink(path);
+  return (true);
+}
+
+static bool __test_002__(void) {
+  assert(!array_map_file("/nonexistent/file", 8, ARRAY_MAP_RDONLY));
+  return (true);
+}
+
+TEST_FUNCTION void array_map_file_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "file backed array");
+  run_test(&__test_002__, "mapping a missing file");
+
+  __test_end__;
+}
@@ -0,0 +1,228 @@
+#include "arena.h"
+#include "array.h"
+#include "array_parallel.h"
+#include "pool.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+static array_t *range(size_t n) {
+  array_t *arr = array_create(sizeof(int64_t), n, NULL);
+
+  for (int64_t i = 0; i < (int64_t)n; i++)
+    assert(array_push(arr, &i));
+  return (arr);
+}
+
+static bool keep_some(const void *e) {
+  int64_t x = *(const int64_t *)e;
+
+  return (x % 3 == 0 || (x / 100) % 2);
+}
+
+static bool is_big(const void *e) { return (*(const int64_t *)e >= 70000); }
+
+static bool is_negative(const void *e) { return (*(const int64_t *)e < 0); }
+
+static bool twice(void *e) {
+  *(int64_t *)e *= 2;
+  return (true);
+}
+
+static bool stop_at_500(void *e) { return (*(int64_t *)e != 500); }
+
+static void count_task(void *ctx, size_t task) {
+  atomic_uint *hits = ctx;
+
+  atomic_fetch_add(&hits[task], 1);
+}
+
+static bool __test_001__(void) {
+  pool_t *pool = pool_create(4);
+  atomic_uint hits[1000];
+
+  assert(pool_size(pool) == 4);
+  for (int round = 0; round < 3; round++) {
+    memset(hits, 0, sizeof(hits));
+    pool_run(pool, 1000, &count_task, hits);
+    for (size_t i = 0; i < 1000; i++)
+      assert(atomic_load(&hits[i]) == 1);
+  }
+
+  pool_kill(pool);
+  return (true);
+}
+
+static bool __test_002__(void) {
+  pool_t *pool = pool_create(4);
+  array_t *arr = range(100000);
+  array_t *expected = array_filter(arr, &keep_some);
+  static const size_t grains[] = {0, 1, 100, 64, 1000000};
+
+  for (size_t i = 0; i < sizeof(grains) / sizeof(*grains); i++) {
+    array_t *filtered = array_filter_parallel(arr, &keep_some, pool, grains[i]);
+
+    assert(array_size(filtered) == array_size(expected));
+    assert(memcmp(array_data(filtered), array_data(expected),
+                  array_sizeof(expected)) == 0);
+    array_kill(filtered);
+  }
+
+  array_t *none = array_filter_parallel(arr, &is_negative, pool, 0);
+  assert(array_size(none) == 0);
+  array_kill(none);
+
+  array_kill(expected);
+  array_kill(arr);
+  pool_kill(pool);
+  return (true);
+}
+
+static bool __test_003__(void) {
+  pool_t *pool = pool_create(4);
+  array_t *arr = range(100000);
+
+  assert(array_find_index_parallel(arr, &is_big, pool, 0) == 70000);
+  assert(array_find_index_parallel(arr, &is_big, pool, 7) == 70000);
+  assert(*(int64_t *)array_find_parallel(arr, &is_big, pool, 333) == 70000);
+  assert(array_find_index_parallel(arr, &is_negative, pool, 0) == -1);
+  assert(!array_find_parallel(arr, &is_negative, pool, 0));
+
+  assert(array_foreach_parallel(arr, &twice, pool, 1000));
+  for (size_t i = 0; i < array_size(arr); i++)
+    assert(*(int64_t *)array_at(arr, i) == (int64_t)i * 2);
+
+  /* 500 is at index 250, the first chunk stops there */
+  assert(!array_foreach_parallel(arr, &stop_at_500, pool, 1000));
+  assert(*(int64_t *)array_at(arr, 249) == 498);
+
+  assert(!array_foreach(arr, &stop_at_500));
+  assert(array_foreach(arr, &twice));
+
+  array_kill(arr);
+  pool_kill(pool);
+  return (true);
+}
+
+typedef struct {
+  int32_t key;
+  uint32_t order;
+  char pad[5];
+} record_t;
+
+static int cmp_record(const void *a, const void *b) {
+  const record_t *x = a;
+  const record_t *y = b;
+
+  return ((x->key > y->key) - (x->key < y->key));
+}
+
+static bool __test_004__(void) {
+  static const size_t threads[] = {1, 3, 4, 7};
+  static const size_t sizes[] = {100, 8192, 50001, 120000};
+  uint64_t state = 88172645463325252ULL;
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(*sizes); s++) {
+    array_t *arr = array_create(sizeof(record_t), sizes[s], NULL);
+
+    for (size_t i = 0; i < sizes[s]; i++) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      record_t r = {(int32_t)(state % 500), (uint32_t)i, {0}};
+      assert(array_push(arr, &r));
+    }
+
+    array_t *expected = array_create(sizeof(record_t), sizes[s], NULL);
+    assert(array_append(expected, array_data(arr), sizes[s]));
+    assert(array_sort_stable(expected, &cmp_record));
+
+    for (size_t t = 0; t < sizeof(threads) / sizeof(*threads); t++) {
+      pool_t *pool = pool_create(threads[t]);
+      array_t *sorted = array_create(sizeof(record_t), sizes[s], NULL);
+
+      assert(array_append(sorted, array_data(arr), sizes[s]));
+      assert(array_sort_parallel(sorted, &cmp_record, pool));
+      assert(memcmp(array_data(sorted), array_data(expected),
+                    array_sizeof(expected)) == 0);
+
+      array_kill(sorted);
+      pool_kill(pool);
+    }
+
+    array_kill(expected);
+    array_kill(arr);
+  }
+  return (true);
+}
+
+static int cmp_int32(const void *a, const void *b) {
+  int32_t x = *(const int32_t *)a;
+  int32_t y = *(const int32_t *)b;
+
+  return ((x > y) - (x < y));
+}
+
+/* An arena is not thread-safe: every allocation must come from the thread
+ * that sorts. */
+static pthread_t sorting_thread;
+
+static void *arena_alloc_here(void *ctx, size_t n) {
+  assert(pthread_equal(pthread_self(), sorting_thread));
+  return (arena_alloc(ctx, n));
+}
+
+static void *arena_realloc_here(void *ctx, void *ptr, size_t n) {
+  assert(pthread_equal(pthread_self(), sorting_thread));
+  return (arena_realloc(ctx, ptr, n));
+}
+
+static void arena_free_here(void *ctx, void *ptr) {
+  assert(pthread_equal(pthread_self(), sorting_thread));
+  arena_free(ctx, ptr);
+}
+
+static bool __test_005__(void) {
+  arena_t *arena = arena_create(0);
+  array_allocator_t allocator = {._memory_alloc = arena_alloc_here,
+                                 ._memory_realloc = arena_realloc_here,
+                                 ._memory_free = arena_free_here,
+                                 ._ctx = arena};
+  pool_t *pool = pool_create(8);
+  array_t *arr;
+  uint64_t state = 88172645463325252ULL;
+
+  sorting_thread = pthread_self();
+  arr = array_create_with_allocator(&allocator, sizeof(int32_t), 0, NULL);
+  for (size_t i = 0; i < 400000; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    assert(array_push(arr, &(int32_t){(int32_t)(state % 100000)}));
+  }
+
+  assert(array_sort_parallel(arr, &cmp_int32, pool));
+  for (size_t i = 1; i < array_size(arr); i++)
+    assert(*(int32_t *)array_at(arr, i - 1) <= *(int32_t *)array_at(arr, i));
+
+  array_kill(arr);
+  pool_kill(pool);
+  arena_kill(arena);
+  return (true);
+}
+
+TEST_FUNCTION void array_parallel_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "pool runs every task once");
+  run_test(&__test_002__, "parallel filter keeps the order");
+  run_test(&__test_003__, "parallel find and foreach");
+  run_test(&__test_004__, "parallel sort matches the stable sort");
+  run_test(&__test_005__, "parallel sort of an arena backed array");
+
+  __test_end__;
+}
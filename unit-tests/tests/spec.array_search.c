@@ -0,0 +1,167 @@
+#include "array.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool is_odd(const void *elem) { return (*(const int32_t *)elem & 1); }
+
+static bool is_negative(const void *elem) {
+  return (*(const int32_t *)elem < 0);
+}
+
+static bool __test_001__(void) {
+  array_t *arr = array_create(sizeof(int32_t), 16, NULL);
+
+  assert(array_find_index(arr, &is_odd) == -1);
+  assert(array_rfind_index(arr, &is_odd) == -1);
+  for (int32_t i = 0; i < 10; i++)
+    assert(array_push(arr, &(int32_t){i * 2}));
+  assert(array_find(arr, &is_odd) == NULL);
+  assert(array_rfind(arr, &is_odd) == NULL);
+
+  *(int32_t *)array_access(arr, 3) = 7;
+  *(int32_t *)array_access(arr, 8) = 9;
+  assert(array_find_index(arr, &is_odd) == 3);
+  assert(array_rfind_index(arr, &is_odd) == 8);
+  assert(*(int32_t *)array_find(arr, &is_odd) == 7);
+  assert(*(int32_t *)array_rfind(arr, &is_odd) == 9);
+  assert(array_rfind_index(arr, &is_negative) == -1);
+
+  array_kill(arr);
+  return (true);
+}
+
+/* Every position of a match, with lengths around the vector widths. */
+static bool check_find_count(size_t size) {
+  unsigned char value[8];
+  unsigned char other[8];
+
+  memset(value, 0x5a, sizeof(value));
+  memcpy(other, value, sizeof(other));
+  /* differs in a single byte, the last one */
+  other[size - 1] ^= 1;
+
+  for (size_t n = 0; n < 80; n++) {
+    array_t *arr = array_create(size, n, NULL);
+
+    for (size_t i = 0; i < n; i++)
+      assert(array_push(arr, other));
+    assert(array_find_value_index(arr, value) == -1);
+    assert(!array_contains_value(arr, value));
+    assert(array_count_value(arr, value) == 0);
+    assert(array_count_value(arr, other) == n);
+
+    for (size_t i = 0; i < n; i++) {
+      memcpy(array_access(arr, i), value, size);
+      assert(array_find_value_index(arr, value) == (int64_t)i);
+      assert(array_find_value(arr, value) == array_access(arr, i));
+      assert(array_count_value(arr, value) == 1);
+      memcpy(array_access(arr, i), other, size);
+    }
+
+    for (size_t i = 0; i < n; i += 3)
+      memcpy(array_access(arr, i), value, size);
+    assert(array_count_value(arr, value) == (n + 2) / 3);
+    assert(array_contains_value(arr, value) == (n > 0));
+
+    array_kill(arr);
+  }
+
+  return (true);
+}
+
+static bool __test_002__(void) {
+  static const size_t sizes[] = {1, 2, 3, 4, 8};
+
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); i++)
+    assert(check_find_count(sizes[i]));
+
+  return (true);
+}
+
+#define CHECK_MINMAX(type, is_signed)                                          \
+  do {                                                                         \
+    for (size_t n = 1; n < 100; n++) {                                         \
+      array_t *arr = array_create(sizeof(type), n, NULL);                      \
+      type lo = 0;                                                             \
+      type hi = 0;                                                             \
+      type min;                                                                \
+      type max;                                                                \
+                                                                               \
+      for (size_t i = 0; i < n; i++) {                                         \
+        type x;                                                                \
+        for (size_t b = 0; b < sizeof(x); b++)                                 \
+          ((unsigned char *)&x)[b] = (unsigned char)rand();                    \
+        if (!i || x < lo)                                                      \
+          lo = x;                                                              \
+        if (!i || x > hi)                                                      \
+          hi = x;                                                              \
+        assert(array_push(arr, &x));                                           \
+      }                                                                        \
+      assert(array_minmax(arr, is_signed, &min, &max));                        \
+      assert(min == lo && max == hi);                                          \
+      array_kill(arr);                                                         \
+    }                                                                          \
+  } while (0)
+
+static bool __test_003__(void) {
+  srand(42);
+  for (int round = 0; round < 10; round++) {
+    CHECK_MINMAX(uint8_t, false);
+    CHECK_MINMAX(int8_t, true);
+    CHECK_MINMAX(uint16_t, false);
+    CHECK_MINMAX(int16_t, true);
+    CHECK_MINMAX(uint32_t, false);
+    CHECK_MINMAX(int32_t, true);
+    CHECK_MINMAX(uint64_t, false);
+    CHECK_MINMAX(int64_t, true);
+  }
+
+  array_t *arr = array_create(sizeof(int64_t), 0, NULL);
+  int64_t max = 0;
+
+  assert(!array_minmax(arr, true, NULL, &max));
+  for (int64_t i = 0; i < 100; i++)
+    assert(array_push(arr, &(int64_t){i % 2 ? INT64_MIN : INT64_MAX}));
+  assert(array_minmax(arr, true, NULL, &max) && max == INT64_MAX);
+  /* the same bits, read as unsigned */
+  assert(array_minmax(arr, false, NULL, &max) && max == INT64_MIN);
+  array_kill(arr);
+
+  return (true);
+}
+
+static bool __test_004__(void) {
+  static const size_t sizes[] = {3, 5, 16};
+  char elem[16] = {1};
+  char min[16] = {0};
+  char max[16] = {0};
+
+  /* only 1, 2, 4 and 8 byte integers have a minimum and a maximum */
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(*sizes); s++) {
+    array_t *arr = array_create(sizes[s], 0, NULL);
+
+    for (int i = 0; i < 10; i++)
+      assert(array_push(arr, elem));
+    assert(!array_minmax(arr, true, min, max));
+    assert(!array_minmax(arr, false, min, max));
+    array_kill(arr);
+  }
+  assert(min[0] == 0 && max[0] == 0);
+
+  return (true);
+}
+
+TEST_FUNCTION void array_search_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "find/rfind with a callback");
+  run_test(&__test_002__, "find/count by value");
+  run_test(&__test_003__, "minmax");
+  run_test(&__test_004__, "minmax on elements that are not integers");
+
+  __test_end__;
+}
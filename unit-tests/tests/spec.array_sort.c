@@ -0,0 +1,195 @@
+#include "array.h"
+#include "array_sort.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  char tag[3];
+  int32_t key; /* at offset 4 */
+  double value;
+  uint32_t order;
+} record_t;
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t rng(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (rng_state);
+}
+
+static int cmp_i64(const void *a, const void *b) {
+  int64_t x = *(const int64_t *)a;
+  int64_t y = *(const int64_t *)b;
+
+  return ((x > y) - (x < y));
+}
+
+static int cmp_record_key(const void *a, const void *b) {
+  const record_t *x = a;
+  const record_t *y = b;
+
+  return ((x->key > y->key) - (x->key < y->key));
+}
+
+static int cmp_record_value(const void *a, const void *b) {
+  const record_t *x = a;
+  const record_t *y = b;
+
+  return ((x->value > y->value) - (x->value < y->value));
+}
+
+static array_t *clone(const array_t *arr) {
+  array_t *copy = array_create(arr->_elt_size, array_size(arr), NULL);
+
+  assert(array_append(copy, arr->_ptr, array_size(arr)));
+  return (copy);
+}
+
+static array_t *numbers(size_t n, int pattern) {
+  array_t *arr = array_create(sizeof(int64_t), n, NULL);
+
+  for (size_t i = 0; i < n; i++) {
+    int64_t x = pattern == 0   ? (int64_t)(rng() % 1000000) - 500000
+                : pattern == 1 ? (int64_t)i
+                : pattern == 2 ? (int64_t)(n - i)
+                : pattern == 3 ? (int64_t)(rng() % 4)
+                               : (int64_t)(i % 2 ? i : n - i);
+    assert(array_push(arr, &x));
+  }
+  return (arr);
+}
+
+static array_t *records(size_t n) {
+  array_t *arr = array_create(sizeof(record_t), n, NULL);
+
+  for (size_t i = 0; i < n; i++) {
+    record_t r = {{0}, (int32_t)(rng() % 2000) - 1000,
+                  ((double)(rng() % 20000) - 10000.0) / 7.0, (uint32_t)i};
+
+    assert(array_push(arr, &r));
+  }
+  return (arr);
+}
+
+static bool __test_001__(void) {
+  static const size_t sizes[] = {0, 1, 2, 15, 16, 17, 1000, 50000};
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(*sizes); s++) {
+    for (int pattern = 0; pattern < 5; pattern++) {
+      array_t *a = numbers(sizes[s], pattern);
+      array_t *b = clone(a);
+      array_t *c = clone(a);
+
+      array_sort(a, &cmp_i64);
+      assert(array_sort_stable(b, &cmp_i64));
+      assert(array_radix_sort(c, 0, ARRAY_KEY_I64));
+      for (size_t i = 1; i < array_size(a); i++)
+        assert(cmp_i64(array_at(a, i - 1), array_at(a, i)) <= 0);
+      if (sizes[s]) {
+        assert(memcmp(array_data(a), array_data(b), array_sizeof(a)) == 0);
+        assert(memcmp(array_data(a), array_data(c), array_sizeof(a)) == 0);
+      }
+
+      array_kill(a);
+      array_kill(b);
+      array_kill(c);
+    }
+  }
+  return (true);
+}
+
+static bool __test_002__(void) {
+  array_t *a = records(20000);
+  array_t *b = clone(a);
+
+  /* equal keys keep their original order */
+  assert(array_sort_stable(a, &cmp_record_key));
+  for (size_t i = 1; i < array_size(a); i++) {
+    const record_t *x = array_at(a, i - 1);
+    const record_t *y = array_at(a, i);
+
+    assert(x->key < y->key || (x->key == y->key && x->order < y->order));
+  }
+
+  /* the radix sort is stable too */
+  assert(array_radix_sort(b, offsetof(record_t, key), ARRAY_KEY_I32));
+  assert(memcmp(array_data(a), array_data(b), array_sizeof(a)) == 0);
+
+  assert(array_sort_stable(a, &cmp_record_value));
+  assert(array_radix_sort(b, offsetof(record_t, value), ARRAY_KEY_F64));
+  assert(memcmp(array_data(a), array_data(b), array_sizeof(a)) == 0);
+
+  array_kill(a);
+  array_kill(b);
+  return (true);
+}
+
+static bool __test_003__(void) {
+  float values[] = {3.5f, -0.0f, -INFINITY, 1e-30f, -2.25f, INFINITY,
+                    0.0f, -1e30f, 42.0f, -1e-30f};
+  uint32_t words[] = {7, 0xffffffffu, 0, 0x80000000u, 12, 0x7fffffffu};
+  array_t *f = array_create(sizeof(float), 16, NULL);
+  array_t *u = array_create(sizeof(uint32_t), 16, NULL);
+
+  assert(array_append(f, values, sizeof(values) / sizeof(*values)));
+  assert(array_append(u, words, sizeof(words) / sizeof(*words)));
+  assert(array_radix_sort(f, 0, ARRAY_KEY_F32));
+  assert(array_radix_sort(u, 0, ARRAY_KEY_U32));
+
+  for (size_t i = 1; i < array_size(f); i++)
+    assert(*(float *)array_at(f, i - 1) <= *(float *)array_at(f, i));
+  assert(*(float *)array_at(f, 0) == -INFINITY);
+  assert(signbit(*(float *)array_at(f, 4)) && !signbit(*(float *)array_at(f, 5)));
+
+  for (size_t i = 1; i < array_size(u); i++)
+    assert(*(uint32_t *)array_at(u, i - 1) <= *(uint32_t *)array_at(u, i));
+
+  array_kill(f);
+  array_kill(u);
+  return (true);
+}
+
+static bool __test_004__(void) {
+  array_t *arr = array_create(sizeof(int64_t), 16, NULL);
+  int64_t values[] = {1, 3, 3, 3, 5, 8, 8, 13};
+  int64_t key;
+
+  assert(array_append(arr, values, 8));
+
+  key = 3;
+  assert(array_lower_bound(arr, &key, &cmp_i64) == 1);
+  assert(array_upper_bound(arr, &key, &cmp_i64) == 4);
+  assert(*(int64_t *)array_bsearch(arr, &key, &cmp_i64) == 3);
+  key = 0;
+  assert(array_lower_bound(arr, &key, &cmp_i64) == 0);
+  assert(array_upper_bound(arr, &key, &cmp_i64) == 0);
+  assert(!array_bsearch(arr, &key, &cmp_i64));
+  key = 9;
+  assert(array_lower_bound(arr, &key, &cmp_i64) == 7);
+  assert(!array_bsearch(arr, &key, &cmp_i64));
+  key = 13;
+  assert(array_upper_bound(arr, &key, &cmp_i64) == 8);
+  key = 99;
+  assert(array_lower_bound(arr, &key, &cmp_i64) == 8);
+
+  array_kill(arr);
+  return (true);
+}
+
+TEST_FUNCTION void array_sort_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "sort, stable sort and radix sort agree");
+  run_test(&__test_002__, "stable sorts keep the order of equal keys");
+  run_test(&__test_003__, "radix sort on float and unsigned keys");
+  run_test(&__test_004__, "binary search and bounds");
+
+  __test_end__;
+}
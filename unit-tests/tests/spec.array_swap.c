@@ -0,0 +1,101 @@
+#include "array.h"
+#include "swap.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Element 'i' is filled with bytes derived from 'i'. */
+static array_t *numbered(size_t elt_size, size_t n) {
+  array_t *arr = array_create(elt_size, n, NULL);
+  unsigned char elem[128];
+
+  for (size_t i = 0; i < n; i++) {
+    for (size_t b = 0; b < elt_size; b++)
+      elem[b] = (unsigned char)(i * 31 + b);
+    assert(array_push(arr, elem));
+  }
+  return (arr);
+}
+
+static bool is_element(const array_t *arr, size_t p, size_t i) {
+  const unsigned char *elem = array_at(arr, p);
+
+  for (size_t b = 0; b < arr->_elt_size; b++)
+    if (elem[b] != (unsigned char)(i * 31 + b))
+      return (false);
+  return (true);
+}
+
+static bool __test_001__(void) {
+  for (size_t elt_size = 1; elt_size <= 100; elt_size++) {
+    array_t *arr = numbered(elt_size, 9);
+
+    array_swap_elems(arr, 1, 7);
+    array_swap_elems(arr, 3, 3);
+    assert(is_element(arr, 1, 7) && is_element(arr, 7, 1));
+    assert(is_element(arr, 3, 3) && is_element(arr, 0, 0));
+
+    array_reverse(arr);
+    assert(is_element(arr, 0, 8) && is_element(arr, 4, 4));
+    assert(is_element(arr, 1, 1) && is_element(arr, 7, 7));
+
+    array_kill(arr);
+  }
+  return (true);
+}
+
+static bool __test_002__(void) {
+  static const size_t elt_sizes[] = {1, 3, 4, 8, 12, 16, 32, 33, 64};
+
+  for (size_t s = 0; s < sizeof(elt_sizes) / sizeof(*elt_sizes); s++) {
+    for (size_t n = 0; n <= 40; n += 5) {
+      for (size_t k = 0; k <= n; k++) {
+        array_t *arr = numbered(elt_sizes[s], n);
+
+        array_rotate(arr, k);
+        for (size_t i = 0; i < n; i++)
+          assert(is_element(arr, i, (i + k) % n));
+        array_kill(arr);
+      }
+    }
+  }
+  return (true);
+}
+
+static bool __test_003__(void) {
+  unsigned char a[200];
+  unsigned char b[200];
+  unsigned char x[200];
+  unsigned char y[200];
+
+  for (size_t i = 0; i < sizeof(a); i++) {
+    a[i] = (unsigned char)i;
+    b[i] = (unsigned char)(255 - i);
+  }
+
+  for (size_t size = 0; size <= 130; size++) {
+    memcpy(x, a, sizeof(a));
+    memcpy(y, b, sizeof(b));
+    swap_bytes(x + 1, y + 3, size);
+    swap_kernel(size)(x + 1, y + 3, size);
+    assert(memcmp(x, a, sizeof(a)) == 0 && memcmp(y, b, sizeof(b)) == 0);
+
+    swap_bytes(x + 1, y + 3, size);
+    assert(memcmp(x + 1, b + 3, size) == 0);
+    assert(memcmp(y + 3, a + 1, size) == 0);
+    assert(x[size + 1] == a[size + 1] && y[size + 3] == b[size + 3]);
+  }
+  return (true);
+}
+
+TEST_FUNCTION void array_swap_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "swap and reverse for any element size");
+  run_test(&__test_002__, "rotate for any element size");
+  run_test(&__test_003__, "swap kernels on unaligned ranges");
+
+  __test_end__;
+}
@@ -0,0 +1,93 @@
+#include "array_typed.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+  int32_t x;
+  int32_t y;
+  double w;
+} point_t;
+
+ARRAY_DECLARE(int32, int32_t)
+ARRAY_DECLARE(point, point_t)
+
+static bool __test_001__(void) {
+  array_t *v = array_int32_create(0);
+
+  for (int32_t i = 0; i < 10000; i++)
+    assert(array_int32_push(v, i * 3));
+  assert(array_int32_size(v) == 10000);
+  assert(array_size(v) == 10000);
+
+  for (int32_t i = 0; i < 10000; i++)
+    assert(array_int32_at(v, i) == i * 3);
+  assert(*(int32_t *)array_at(v, 42) == 126);
+
+  array_int32_set(v, 0, -1);
+  assert(array_int32_data(v)[0] == -1);
+
+  assert(array_int32_pop(v) == 9999 * 3);
+  assert(array_int32_size(v) == 9999);
+
+  const int32_t more[] = {1, 2, 3};
+  assert(array_int32_append(v, more, 3));
+  assert(array_int32_at(v, 10001) == 3);
+
+  array_kill(v);
+  return (true);
+}
+
+static bool __test_002__(void) {
+  array_t *v = array_point_create(1);
+
+  for (int32_t i = 0; i < 100; i++)
+    assert(array_point_push(v, (point_t){.x = i, .y = -i, .w = i / 2.0}));
+
+  /* interoperates with the generic api */
+  point_t p = {.x = 7, .y = 7, .w = 7.0};
+  assert(array_insert(v, 0, &p));
+  assert(array_point_at(v, 0).w == 7.0);
+  assert(array_point_at(v, 100).x == 99);
+  assert(array_point_pop(v).y == -99);
+
+  array_kill(v);
+  return (true);
+}
+
+static bool __test_003__(void) {
+  array_t *v = array_int32_create(100);
+  size_t cap = array_cap(v) / sizeof(int32_t);
+
+  /* typed and generic reservations agree, settled or not */
+  for (int settled = 0; settled < 2; settled++) {
+    for (size_t n = 0; n < cap + 4; n++)
+      assert(array_int32_reserve(v, n) == array_adjust(v, n));
+    array_settle(v);
+    cap = array_cap(v) / sizeof(int32_t);
+  }
+  assert(!array_int32_reserve(v, cap));
+  assert(array_int32_reserve(v, cap - 1));
+
+  /* and neither lets a huge size wrap around */
+  assert(array_int32_push(v, 1));
+  assert(!array_int32_reserve(v, SIZE_MAX / 2));
+  assert(!array_adjust(v, SIZE_MAX / 2));
+  assert(!array_int32_reserve(v, SIZE_MAX));
+  assert(!array_int32_append(v, (int32_t[]){1}, SIZE_MAX / 4 + 1));
+  assert(array_int32_size(v) == 1);
+
+  array_kill(v);
+  return (true);
+}
+
+TEST_FUNCTION void array_typed_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "typed int32 array");
+  run_test(&__test_002__, "typed struct array");
+  run_test(&__test_003__, "typed and generic reservations agree");
+
+  __test_end__;
+}
@@ -0,0 +1,92 @@
+#include "deque.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+static bool __test_001__(void) {
+  deque_t *q = deque_create(sizeof(int64_t), 4, NULL);
+  int64_t x;
+
+  for (int64_t i = 0; i < 100; i++) {
+    assert(deque_push(q, &i));
+    assert(deque_pushf(q, &(int64_t){-i}));
+  }
+  assert(deque_size(q) == 200);
+  assert(*(int64_t *)deque_head(q) == -99);
+  assert(*(int64_t *)deque_tail(q) == 99);
+  assert(*(int64_t *)deque_access(q, 100) == 0);
+  assert(!deque_access(q, 200));
+
+  for (int64_t i = 99; i >= 0; i--) {
+    deque_popf(q, &x);
+    assert(x == -i);
+  }
+  for (int64_t i = 99; i >= 1; i--) {
+    deque_pop(q, &x);
+    assert(x == i);
+  }
+  assert(deque_size(q) == 1);
+  deque_pop(q, NULL);
+  assert(!deque_head(q) && !deque_tail(q));
+
+  deque_kill(q);
+  return (true);
+}
+
+static bool __test_002__(void) {
+  deque_t *q = deque_create(sizeof(int32_t), 8, NULL);
+  int32_t x;
+  int32_t next = 0;
+  int32_t expected = 0;
+
+  /* used as a work queue, the content keeps wrapping around */
+  for (int round = 0; round < 10000; round++) {
+    for (int i = 0; i < 3; i++)
+      assert(deque_push(q, &(int32_t){next++}));
+    for (int i = 0; i < 2; i++) {
+      deque_popf(q, &x);
+      assert(x == expected++);
+    }
+  }
+  assert(deque_size(q) == 10000);
+  for (size_t i = 0; i < deque_size(q); i++)
+    assert(*(int32_t *)deque_access(q, i) == expected + (int32_t)i);
+
+  deque_kill(q);
+  return (true);
+}
+
+static bool __test_003__(void) {
+  deque_t *q = deque_create(sizeof(int32_t), 16, NULL);
+
+  for (int32_t i = 0; i < 10; i++)
+    assert(deque_push(q, &i));
+  for (int32_t i = 1; i <= 5; i++)
+    assert(deque_pushf(q, &(int32_t){-i}));
+
+  array_t *copy = deque_to_array(q);
+  assert(array_size(copy) == 15);
+  for (int32_t i = 0; i < 15; i++)
+    assert(*(int32_t *)array_at(copy, i) == i - 5);
+  array_kill(copy);
+
+  array_t *v = deque_into_array(q);
+  assert(array_size(v) == 15);
+  for (int32_t i = 0; i < 15; i++)
+    assert(*(int32_t *)array_at(v, i) == i - 5);
+  assert(array_push(v, &(int32_t){10}));
+  assert(*(int32_t *)array_tail(v) == 10);
+  array_kill(v);
+  return (true);
+}
+
+TEST_FUNCTION void deque_basic_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "deque push/pop at both ends");
+  run_test(&__test_002__, "deque as a work queue");
+  run_test(&__test_003__, "deque to array");
+
+  __test_end__;
+}
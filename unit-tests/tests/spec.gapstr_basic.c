@@ -0,0 +1,74 @@
+#include "dynstr.h"
+#include "gapstr.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+static bool __test_001__(void) {
+  gapstr_t *s = gapstr_assign("hello world", -1);
+
+  assert(gapstr_size(s) == 11);
+  assert(gapstr_inject(s, 5, ",", -1));
+  assert(gapstr_inject(s, 0, ">> ", -1));
+  assert(gapstr_append(s, "!!", 1));
+  assert(gapstr_size(s) == 16);
+  assert(gapstr_at(s, 0) == '>' && gapstr_at(s, 8) == ',');
+  assert(gapstr_at(s, 15) == '!');
+  assert(strcmp(gapstr_view(s), ">> hello, world!") == 0);
+
+  gapstr_wipe(s, 0, 3);
+  gapstr_wipe(s, 5, 6);
+  assert(strcmp(gapstr_view(s), "hello world!") == 0);
+  /* the view leaves the gap at the end, a second one moves nothing */
+  assert(s->_gap == gapstr_size(s));
+  assert(strcmp(gapstr_view(s), "hello world!") == 0);
+
+  gapstr_wipe(s, 0, gapstr_size(s));
+  assert(gapstr_size(s) == 0 && strcmp(gapstr_view(s), "") == 0);
+
+  dynstr_t *empty = gapstr_pull(s);
+  assert(empty->_nmemb == 1 && empty->_ptr[0] == '\0');
+  dynstr_kill(empty);
+
+  gapstr_kill(s);
+  return (true);
+}
+
+static bool __test_002__(void) {
+  gapstr_t *s = gapstr_create(0);
+
+  /* typing in the middle of a long text, with some backspaces */
+  for (int i = 0; i < 10000; i++)
+    assert(gapstr_append(s, "abcdefghij", -1));
+  for (int i = 0; i < 100000; i++)
+    assert(gapstr_inject(s, 50000 + i, "x", 1));
+  assert(s->_gap == 150000);
+  gapstr_wipe(s, 149000, 150000);
+  assert(gapstr_size(s) == 199000);
+
+  /* the gap did not move while typing, the text before is in place */
+  for (size_t i = 0; i < 50000; i++)
+    assert(gapstr_at(s, i) == 'a' + (char)(i % 10));
+  for (size_t i = 50000; i < 149000; i++)
+    assert(gapstr_at(s, i) == 'x');
+  for (size_t i = 149000; i < 199000; i++)
+    assert(gapstr_at(s, i) == 'a' + (char)((i - 99000) % 10));
+
+  dynstr_t *copy = gapstr_pull(s);
+  assert(copy->_nmemb == 199000 + 1);
+  assert(memcmp(copy->_ptr, gapstr_view(s), 199000 + 1) == 0);
+
+  dynstr_kill(copy);
+  gapstr_kill(s);
+  return (true);
+}
+
+TEST_FUNCTION void gapstr_basic_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "gapstr inject/wipe/view");
+  run_test(&__test_002__, "gapstr localized edits");
+
+  __test_end__;
+}
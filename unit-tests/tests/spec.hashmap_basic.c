@@ -0,0 +1,200 @@
+#include "hash.h"
+#include "hashmap.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static size_t destroyed = 0;
+
+static void count_destroyed(void *entry) {
+  (void)entry;
+  destroyed++;
+}
+
+static bool __test_001__(void) {
+  hashmap_t *m = hashmap_create(sizeof(uint64_t), sizeof(uint32_t),
+                                &count_destroyed);
+
+  destroyed = 0;
+  assert(!hashmap_get(m, &(uint64_t){1}));
+  for (uint64_t i = 0; i < 10000; i++)
+    assert(hashmap_put(m, &i, &(uint32_t){(uint32_t)i * 3}));
+  assert(hashmap_size(m) == 10000);
+  assert(destroyed == 0);
+
+  for (uint64_t i = 0; i < 10000; i++)
+    assert(*(uint32_t *)hashmap_get(m, &i) == i * 3);
+  assert(!hashmap_get(m, &(uint64_t){10000}));
+
+  /* overwriting destroys the previous entry */
+  for (uint64_t i = 0; i < 10000; i += 2)
+    assert(hashmap_put(m, &i, &(uint32_t){7}));
+  assert(hashmap_size(m) == 10000);
+  assert(destroyed == 5000);
+  assert(*(uint32_t *)hashmap_get(m, &(uint64_t){42}) == 7);
+  assert(*(uint32_t *)hashmap_get(m, &(uint64_t){43}) == 129);
+
+  bool inserted;
+  uint32_t *v = hashmap_emplace(m, &(uint64_t){43}, &inserted);
+  assert(!inserted && *v == 129);
+  v = hashmap_emplace(m, &(uint64_t){20000}, &inserted);
+  assert(inserted);
+  *v = 1;
+  assert(*(uint32_t *)hashmap_get(m, &(uint64_t){20000}) == 1);
+
+  hashmap_kill(m);
+  assert(destroyed == 5000 + 10001);
+  return (true);
+}
+
+static bool __test_002__(void) {
+  hashmap_t *m = hashmap_create(sizeof(uint32_t), sizeof(uint32_t),
+                                &count_destroyed);
+
+  destroyed = 0;
+  assert(hashmap_reserve(m, 1000));
+  size_t cap = m->_cap;
+
+  /* a sliding window of keys: erasures must not pile up as tombstones */
+  for (uint32_t i = 0; i < 200000; i++) {
+    assert(hashmap_put(m, &i, &i));
+    if (i >= 1000) {
+      assert(hashmap_erase(m, &(uint32_t){i - 1000}));
+      assert(!hashmap_erase(m, &(uint32_t){i - 1000}));
+    }
+    assert(hashmap_size(m) == MIN(i + 1, 1000));
+  }
+  assert(m->_cap == cap);
+  assert(destroyed == 199000);
+
+  for (uint32_t i = 0; i < 200000; i++) {
+    uint32_t *v = hashmap_get(m, &i);
+    assert(i < 199000 ? !v : *v == i);
+  }
+
+  hashmap_clear(m);
+  assert(hashmap_size(m) == 0 && destroyed == 200000);
+  assert(!hashmap_get(m, &(uint32_t){199999}));
+
+  /* reserved room is used without rehashing */
+  void *slots = m->_slots;
+  for (uint32_t i = 0; i < 1000; i++)
+    assert(hashmap_put(m, &i, &i));
+  assert(m->_cap == cap && m->_slots == slots);
+
+  hashmap_kill(m);
+  return (true);
+}
+
+static bool __test_003__(void) {
+  hashmap_t *m = hashmap_create(sizeof(uint16_t), 0, NULL);
+  size_t it = 0;
+  void *key;
+  void *prev = NULL;
+  size_t seen[1000] = {0};
+
+  for (uint16_t i = 0; i < 1000; i++)
+    assert(hashmap_put(m, &i, NULL));
+  for (uint16_t i = 0; i < 1000; i += 3)
+    assert(hashmap_erase(m, &i));
+
+  size_t n = 0;
+  while (hashmap_next(m, &it, &key, NULL)) {
+    assert((char *)key > (char *)prev);
+    prev = key;
+    seen[*(uint16_t *)key]++;
+    n++;
+  }
+  assert(n == hashmap_size(m) && n == 666);
+  for (size_t i = 0; i < 1000; i++)
+    assert(seen[i] == (i % 3 != 0));
+  assert(!hashmap_next(m, &it, &key, NULL));
+
+  hashmap_kill(m);
+  return (true);
+}
+
+typedef struct {
+  char name[24];
+} name_t;
+
+static uint64_t name_hash(const void *key, size_t size) {
+  (void)size;
+  return (hash_bytes(key, strlen(((const name_t *)key)->name)));
+}
+
+static bool name_eq(const void *a, const void *b, size_t size) {
+  (void)size;
+  return (strcmp(((const name_t *)a)->name, ((const name_t *)b)->name) == 0);
+}
+
+static size_t allocations = 0;
+
+static void *counting_alloc(void *ctx, size_t n) {
+  (void)ctx;
+  allocations++;
+  return (malloc(n));
+}
+
+static void *counting_realloc(void *ctx, void *ptr, size_t n) {
+  (void)ctx;
+  return (realloc(ptr, n));
+}
+
+static void counting_free(void *ctx, void *ptr) {
+  (void)ctx;
+  allocations--;
+  free(ptr);
+}
+
+static bool __test_004__(void) {
+  array_allocator_t allocator = {
+      ._memory_alloc = &counting_alloc,
+      ._memory_realloc = &counting_realloc,
+      ._memory_free = &counting_free,
+      ._ctx = NULL,
+  };
+  hashmap_t *m = hashmap_create_with_allocator(&allocator, sizeof(name_t),
+                                               sizeof(int), NULL);
+  name_t a = {0};
+  name_t b;
+
+  hashmap_set_hasher(m, &name_hash, &name_eq);
+
+  /* the bytes after the terminator differ, the keys are still equal */
+  memset(&b, 'x', sizeof(b));
+  strcpy(a.name, "answer");
+  strcpy(b.name, "answer");
+  assert(hashmap_put(m, &a, &(int){42}));
+  assert(*(int *)hashmap_get(m, &b) == 42);
+  assert(hashmap_erase(m, &b));
+  assert(hashmap_size(m) == 0);
+
+  for (int i = 0; i < 500; i++) {
+    snprintf(a.name, sizeof(a.name), "key-%d", i);
+    assert(hashmap_put(m, &a, &i));
+  }
+  for (int i = 0; i < 500; i++) {
+    snprintf(a.name, sizeof(a.name), "key-%d", i);
+    assert(*(int *)hashmap_get(m, &a) == i);
+  }
+  assert(allocations == 2);
+
+  hashmap_kill(m);
+  assert(allocations == 0);
+  return (true);
+}
+
+TEST_FUNCTION void hashmap_basic_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "hashmap put/get/emplace");
+  run_test(&__test_002__, "hashmap erase churn");
+  run_test(&__test_003__, "hashmap iteration");
+  run_test(&__test_004__, "hashmap hasher and allocator");
+
+  __test_end__;
+}
@@ -0,0 +1,95 @@
+#include "dynstr.h"
+#include "intern.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static bool __test_001__(void) {
+  intern_t *t = intern_create(0);
+  ut32_t id;
+  ut32_t other;
+
+  assert(!intern_find(t, "label", -1, &id));
+  assert(intern_put(t, "label", -1, &id) && id == 0);
+  assert(intern_put(t, "labels", -1, &other) && other == 1);
+  assert(intern_put(t, "labels", 5, &other) && other == 0);
+  assert(intern_find(t, "label", -1, &other) && other == 0);
+  assert(intern_size(t) == 2);
+  assert(intern_bytes(t) == 6 + 7);
+
+  /* the empty string is a string like any other */
+  assert(intern_put(t, "", -1, &id) && id == 2);
+  assert(intern_view(t, id)._size == 0);
+
+  dynstr_t *s = dynstr_assign("labels", -1);
+  assert(intern_put_dynstr(t, s, &id) && id == 1);
+  dynstr_kill(s);
+
+  x_str_t view = intern_view(t, 1);
+  assert(view._size == 6 && strcmp(view._ptr, "labels") == 0);
+
+  intern_kill(t);
+  return (true);
+}
+
+static bool __test_002__(void) {
+  intern_t *t = intern_create(256);
+  const char *views[2000];
+  char buffer[64];
+  ut32_t id;
+
+  /* every string is seen many times, only the first one is stored */
+  for (int round = 0; round < 5; round++) {
+    for (int i = 0; i < 2000; i++) {
+      int n = snprintf(buffer, sizeof(buffer), "service.%d.requests", i);
+      assert(intern_put(t, buffer, n, &id) && id == (ut32_t)i);
+      if (!round)
+        views[i] = intern_view(t, id)._ptr;
+    }
+  }
+  assert(intern_size(t) == 2000);
+
+  /* the bytes never moved while the slabs kept filling */
+  for (int i = 0; i < 2000; i++) {
+    snprintf(buffer, sizeof(buffer), "service.%d.requests", i);
+    assert(intern_view(t, (ut32_t)i)._ptr == views[i]);
+    assert(strcmp(views[i], buffer) == 0);
+  }
+
+  intern_kill(t);
+  return (true);
+}
+
+static bool __test_003__(void) {
+  intern_t *t = intern_create(64);
+  char big[1000];
+  ut32_t id;
+
+  memset(big, 'z', sizeof(big));
+  assert(intern_put(t, "a", -1, &id) && id == 0);
+  assert(intern_put(t, big, sizeof(big), &id) && id == 1);
+  assert(intern_put(t, "b", -1, &id) && id == 2);
+
+  /* the long string got a slab of its own, the small ones share theirs */
+  assert(array_size(t->_slabs) == 2);
+  assert(intern_view(t, 2)._ptr == intern_view(t, 0)._ptr + 2);
+  assert(intern_view(t, 1)._size == sizeof(big));
+  assert(intern_view(t, 1)._ptr[sizeof(big)] == '\0');
+  assert(intern_find(t, big, sizeof(big), &id) && id == 1);
+
+  intern_kill(t);
+  return (true);
+}
+
+TEST_FUNCTION void intern_basic_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "intern put/find/view");
+  run_test(&__test_002__, "intern repeated strings");
+  run_test(&__test_003__, "intern oversized strings");
+
+  __test_end__;
+}
@@ -0,0 +1,260 @@
+#include "array.h"
+#include "numeric.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+static uint64_t rng_state = 0x2545f4914f6cdd1dULL;
+
+static uint64_t rng(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (rng_state);
+}
+
+/* Floats of very different magnitudes, so the order of the additions
+ * shows in the result. */
+static double rng_double(void) {
+  return (ldexp((double)(rng() % 2000001) - 1000000.0, (int)(rng() % 40) - 20));
+}
+
+static array_t *random_doubles(size_t n) {
+  array_t *arr = array_create(sizeof(double), n, NULL);
+
+  for (size_t i = 0; i < n; i++)
+    assert(array_push(arr, &(double){rng_double()}));
+  return (arr);
+}
+
+static array_t *random_floats(size_t n) {
+  array_t *arr = array_create(sizeof(float), n, NULL);
+
+  for (size_t i = 0; i < n; i++)
+    assert(array_push(arr, &(float){(float)rng_double()}));
+  return (arr);
+}
+
+/* The reference order of the header: 8 partial sums, combined pairwise. */
+#define LANE_SUM(type, r)                                                      \
+  (type)(((r[0] + r[4]) + (r[2] + r[6])) + ((r[1] + r[5]) + (r[3] + r[7])))
+
+static bool __test_001__(void) {
+  for (size_t n = 0; n < 70; n++) {
+    array_t *d = random_doubles(n);
+    array_t *e = random_doubles(n);
+    array_t *f = random_floats(n);
+    array_t *g = random_floats(n);
+    double sd[8] = {0};
+    double dd[8] = {0};
+    float sf[8] = {0};
+    float df[8] = {0};
+
+    for (size_t i = 0; i < n; i++) {
+      double x = ((double *)d->_ptr)[i];
+      double y = ((double *)e->_ptr)[i];
+      float u = ((float *)f->_ptr)[i];
+      float v = ((float *)g->_ptr)[i];
+      volatile double xy = x * y;
+      volatile float uv = u * v;
+
+      sd[i % 8] += x;
+      dd[i % 8] += xy;
+      sf[i % 8] += u;
+      df[i % 8] += uv;
+    }
+
+    /* bit for bit */
+    double sum = numeric_sum(d, ARRAY_KEY_F64)._f;
+    double dot = numeric_dot(d, e, ARRAY_KEY_F64)._f;
+    float sumf = (float)numeric_sum(f, ARRAY_KEY_F32)._f;
+    float dotf = (float)numeric_dot(f, g, ARRAY_KEY_F32)._f;
+    assert(memcmp(&sum, &(double){LANE_SUM(double, sd)}, sizeof(sum)) == 0);
+    assert(memcmp(&dot, &(double){LANE_SUM(double, dd)}, sizeof(dot)) == 0);
+    assert(memcmp(&sumf, &(float){LANE_SUM(float, sf)}, sizeof(sumf)) == 0);
+    assert(memcmp(&dotf, &(float){LANE_SUM(float, df)}, sizeof(dotf)) == 0);
+
+    array_kill(d);
+    array_kill(e);
+    array_kill(f);
+    array_kill(g);
+  }
+
+  return (true);
+}
+
+static bool __test_002__(void) {
+  array_t *a = array_create(sizeof(int32_t), 0, NULL);
+  array_t *b = array_create(sizeof(uint64_t), 0, NULL);
+  int64_t sum = 0;
+  uint64_t dot = 0;
+
+  for (int32_t i = 0; i < 1001; i++) {
+    int32_t x = (int32_t)(rng() >> 32);
+
+    assert(array_push(a, &x));
+    sum += x;
+    dot += (uint64_t)((int64_t)x * x);
+  }
+  /* 32-bit elements are summed on 64 bits */
+  assert(numeric_sum(a, ARRAY_KEY_I32)._i == sum);
+  /* the products wrap around */
+  assert(numeric_dot(a, a, ARRAY_KEY_I32)._u == dot);
+
+  for (uint64_t i = 0; i < 100; i++)
+    assert(array_push(b, &(uint64_t){UINT64_MAX - i}));
+  /* wraps around */
+  assert(numeric_sum(b, ARRAY_KEY_U64)._u == (uint64_t)-(100 * 101 / 2));
+
+  array_kill(a);
+  array_kill(b);
+  return (true);
+}
+
+static bool __test_003__(void) {
+  array_t *d = random_doubles(100);
+  numeric_value_t min;
+  numeric_value_t max;
+  double lo = INFINITY;
+  double hi = -INFINITY;
+
+  ((double *)d->_ptr)[37] = NAN;
+  for (size_t i = 0; i < 100; i++) {
+    double x = ((double *)d->_ptr)[i];
+    lo = x < lo ? x : lo;
+    hi = x > hi ? x : hi;
+  }
+  assert(numeric_minmax(d, ARRAY_KEY_F64, &min, &max));
+  assert(min._f == lo && max._f == hi);
+
+  array_t *i = array_create(sizeof(int64_t), 0, NULL);
+  assert(!numeric_minmax(i, ARRAY_KEY_I64, &min, NULL));
+  for (int64_t x = -50; x < 50; x++)
+    assert(array_push(i, &x));
+  assert(numeric_minmax(i, ARRAY_KEY_I64, &min, &max));
+  assert(min._i == -50 && max._i == 49);
+
+  array_kill(d);
+  array_kill(i);
+  return (true);
+}
+
+static bool __test_004__(void) {
+  for (size_t n = 0; n < 40; n++) {
+    array_t *a = array_create(sizeof(int32_t), n, NULL);
+    array_t *f = random_floats(n);
+    int32_t acc = 0;
+    float facc = 0;
+    float expected[40];
+
+    for (size_t i = 0; i < n; i++)
+      assert(array_push(a, &(int32_t){(int32_t)i - 7}));
+    for (size_t i = 0; i < n; i++)
+      expected[i] = facc += ((float *)f->_ptr)[i];
+
+    numeric_prefix_sum(a, ARRAY_KEY_I32);
+    numeric_prefix_sum(f, ARRAY_KEY_F32);
+    for (size_t i = 0; i < n; i++) {
+      acc += (int32_t)i - 7;
+      assert(((int32_t *)a->_ptr)[i] == acc);
+      assert(memcmp(&((float *)f->_ptr)[i], &expected[i], sizeof(float)) == 0);
+    }
+
+    array_kill(a);
+    array_kill(f);
+  }
+
+  return (true);
+}
+
+static bool __test_005__(void) {
+  array_t *x = random_doubles(37);
+  array_t *y = random_doubles(37);
+  double expected[37];
+
+  for (size_t i = 0; i < 37; i++) {
+    volatile double ax = 0.1 * ((double *)x->_ptr)[i];
+    expected[i] = ax + ((double *)y->_ptr)[i];
+  }
+  numeric_axpy(y, (numeric_value_t){._f = 0.1}, x, ARRAY_KEY_F64);
+  assert(memcmp(y->_ptr, expected, sizeof(expected)) == 0);
+
+  array_t *a = array_create(sizeof(int32_t), 0, NULL);
+  array_t *b = array_create(sizeof(int32_t), 0, NULL);
+  for (int32_t i = 0; i < 21; i++) {
+    assert(array_push(a, &i));
+    assert(array_push(b, &(int32_t){-i}));
+  }
+  numeric_axpy(a, (numeric_value_t){._i = -3}, b, ARRAY_KEY_I32);
+  for (int32_t i = 0; i < 21; i++)
+    assert(((int32_t *)a->_ptr)[i] == 4 * i);
+
+  numeric_clamp(a, ARRAY_KEY_I32, (numeric_value_t){._i = 10},
+                (numeric_value_t){._i = 50});
+  for (int32_t i = 0; i < 21; i++)
+    assert(((int32_t *)a->_ptr)[i] == (4 * i < 10 ? 10 : 4 * i > 50 ? 50 : 4 * i));
+
+  ((double *)y->_ptr)[3] = NAN;
+  numeric_clamp(y, ARRAY_KEY_F64, (numeric_value_t){._f = -1.0},
+                (numeric_value_t){._f = 1.0});
+  assert(((double *)y->_ptr)[3] == -1.0);
+  for (size_t i = 0; i < 37; i++)
+    assert(fabs(((double *)y->_ptr)[i]) <= 1.0);
+
+  array_kill(x);
+  array_kill(y);
+  array_kill(a);
+  array_kill(b);
+  return (true);
+}
+
+static bool __test_006__(void) {
+  array_t *a = array_create(sizeof(int32_t), 0, NULL);
+
+  for (int32_t i = 0; i < 23; i++)
+    assert(array_push(a, &(int32_t){(i - 11) * 100003}));
+
+  array_t *d = numeric_convert(a, ARRAY_KEY_I32, ARRAY_KEY_F64);
+  array_t *f = numeric_convert(a, ARRAY_KEY_I32, ARRAY_KEY_F32);
+  array_t *l = numeric_convert(a, ARRAY_KEY_I32, ARRAY_KEY_I64);
+  array_t *u = numeric_convert(a, ARRAY_KEY_I32, ARRAY_KEY_U32);
+  array_t *back = numeric_convert(d, ARRAY_KEY_F64, ARRAY_KEY_I32);
+  array_t *narrow = numeric_convert(d, ARRAY_KEY_F64, ARRAY_KEY_F32);
+
+  assert(array_size(d) == 23 && array_size(narrow) == 23);
+  for (size_t i = 0; i < 23; i++) {
+    int32_t x = ((int32_t *)a->_ptr)[i];
+
+    assert(((double *)d->_ptr)[i] == (double)x);
+    assert(((float *)f->_ptr)[i] == (float)x);
+    assert(((int64_t *)l->_ptr)[i] == (int64_t)x);
+    assert(((uint32_t *)u->_ptr)[i] == (uint32_t)x);
+    assert(((int32_t *)back->_ptr)[i] == x);
+    assert(((float *)narrow->_ptr)[i] == (float)(double)x);
+  }
+
+  array_kill(a);
+  array_kill(d);
+  array_kill(f);
+  array_kill(l);
+  array_kill(u);
+  array_kill(back);
+  array_kill(narrow);
+  return (true);
+}
+
+TEST_FUNCTION void numeric_basic_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "numeric float sum/dot reference order");
+  run_test(&__test_002__, "numeric integer sum/dot");
+  run_test(&__test_003__, "numeric minmax");
+  run_test(&__test_004__, "numeric prefix sum");
+  run_test(&__test_005__, "numeric axpy/clamp");
+  run_test(&__test_006__, "numeric convert");
+
+  __test_end__;
+}
@@ -0,0 +1,201 @@
+#include "queue.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TRANSFER_COUNT 200000
+#define MPMC_THREADS 4
+
+static bool __test_001__(void) {
+  spsc_queue_t *q = spsc_queue_create(sizeof(int64_t), 5);
+  int64_t x;
+
+  assert(q->_cap == 8);
+  assert(!spsc_queue_pop(q, &x));
+
+  /* wraps around the end of the buffer several times */
+  for (int64_t round = 0; round < 10; round++) {
+    for (int64_t i = 0; i < 6; i++)
+      assert(spsc_queue_push(q, &(int64_t){round * 6 + i}));
+    assert(spsc_queue_size(q) == 6);
+    for (int64_t i = 0; i < 6; i++) {
+      assert(spsc_queue_pop(q, &x));
+      assert(x == round * 6 + i);
+    }
+  }
+
+  for (int64_t i = 0; i < 8; i++)
+    assert(spsc_queue_push(q, &i));
+  assert(!spsc_queue_push(q, &x));
+  assert(spsc_queue_pop(q, NULL));
+  assert(spsc_queue_push(q, &x));
+
+  spsc_queue_kill(q);
+  return (true);
+}
+
+static bool __test_002__(void) {
+  int32_t buffer[16];
+  int32_t in[40];
+  int32_t out[40];
+  spsc_queue_t *q = spsc_queue_borrow_buffer(buffer, sizeof(*buffer), 16);
+
+  for (int32_t i = 0; i < 40; i++)
+    in[i] = i * 3;
+
+  assert(spsc_queue_push_batch(q, in, 10) == 10);
+  assert(spsc_queue_pop_batch(q, out, 4) == 4);
+  /* only 10 slots left */
+  assert(spsc_queue_push_batch(q, in + 10, 30) == 10);
+  assert(spsc_queue_pop_batch(q, out + 4, 40) == 16);
+  assert(memcmp(in, out, sizeof(*in) * 20) == 0);
+  assert(spsc_queue_pop_batch(q, out, 1) == 0);
+
+  spsc_queue_kill(q);
+  return (true);
+}
+
+static bool __test_003__(void) {
+  mpmc_queue_t *q = mpmc_queue_create(sizeof(int64_t), 1);
+  int64_t in[5] = {1, 2, 3, 4, 5};
+  int64_t out[5];
+  int64_t buffer[4];
+  int64_t x;
+
+  assert(q->_cap == 2);
+  assert(mpmc_queue_push(q, &in[0]));
+  assert(mpmc_queue_push(q, &in[1]));
+  assert(!mpmc_queue_push(q, &in[2]));
+  assert(mpmc_queue_pop(q, &x) && x == 1);
+  assert(mpmc_queue_pop(q, &x) && x == 2);
+  assert(!mpmc_queue_pop(q, &x));
+  mpmc_queue_kill(q);
+
+  q = mpmc_queue_borrow_buffer(buffer, sizeof(*buffer), 4);
+  assert(mpmc_queue_push_batch(q, in, 5) == 4);
+  assert(mpmc_queue_size(q) == 4);
+  assert(mpmc_queue_pop_batch(q, out, 3) == 3);
+  assert(mpmc_queue_push_batch(q, in + 4, 1) == 1);
+  assert(mpmc_queue_pop_batch(q, out + 3, 5) == 2);
+  assert(memcmp(in, out, sizeof(in)) == 0);
+
+  mpmc_queue_kill(q);
+  return (true);
+}
+
+static void *spsc_producer(void *arg) {
+  spsc_queue_t *q = arg;
+  int64_t batch[7];
+
+  for (int64_t i = 0; i < TRANSFER_COUNT;) {
+    size_t n = 0;
+
+    while (n < 7 && i + (int64_t)n < TRANSFER_COUNT) {
+      batch[n] = i + (int64_t)n;
+      n++;
+    }
+    n = spsc_queue_push_batch(q, batch, n);
+    if (n == 0)
+      sched_yield();
+    i += (int64_t)n;
+  }
+  return (NULL);
+}
+
+static bool __test_004__(void) {
+  spsc_queue_t *q = spsc_queue_create(sizeof(int64_t), 64);
+  pthread_t producer;
+  int64_t expected = 0;
+  int64_t x;
+
+  assert(pthread_create(&producer, NULL, &spsc_producer, q) == 0);
+  while (expected < TRANSFER_COUNT) {
+    if (spsc_queue_pop(q, &x)) {
+      assert(x == expected);
+      expected++;
+    } else {
+      sched_yield();
+    }
+  }
+  assert(pthread_join(producer, NULL) == 0);
+  assert(spsc_queue_size(q) == 0);
+
+  spsc_queue_kill(q);
+  return (true);
+}
+
+typedef struct {
+  mpmc_queue_t *q;
+  int64_t id;
+  int64_t sum;
+  atomic_size_t *popped;
+} mpmc_worker_t;
+
+static void *mpmc_producer(void *arg) {
+  mpmc_worker_t *w = arg;
+
+  for (int64_t i = w->id; i < TRANSFER_COUNT; i += MPMC_THREADS) {
+    while (!mpmc_queue_push(w->q, &i))
+      sched_yield();
+  }
+  return (NULL);
+}
+
+static void *mpmc_consumer(void *arg) {
+  mpmc_worker_t *w = arg;
+  int64_t batch[3];
+  size_t n;
+
+  while (atomic_load(w->popped) < TRANSFER_COUNT) {
+    n = mpmc_queue_pop_batch(w->q, batch, 3);
+    if (n == 0)
+      sched_yield();
+    for (size_t i = 0; i < n; i++)
+      w->sum += batch[i];
+    atomic_fetch_add(w->popped, n);
+  }
+  return (NULL);
+}
+
+static bool __test_005__(void) {
+  mpmc_queue_t *q = mpmc_queue_create(sizeof(int64_t), 128);
+  pthread_t threads[MPMC_THREADS * 2];
+  mpmc_worker_t workers[MPMC_THREADS * 2];
+  atomic_size_t popped = 0;
+  int64_t sum = 0;
+
+  for (int64_t i = 0; i < MPMC_THREADS * 2; i++) {
+    workers[i] = (mpmc_worker_t){q, i % MPMC_THREADS, 0, &popped};
+    assert(pthread_create(&threads[i], NULL,
+                          i < MPMC_THREADS ? &mpmc_producer : &mpmc_consumer,
+                          &workers[i]) == 0);
+  }
+  for (int64_t i = 0; i < MPMC_THREADS * 2; i++) {
+    assert(pthread_join(threads[i], NULL) == 0);
+    sum += workers[i].sum;
+  }
+
+  /* every element was popped exactly once */
+  assert(atomic_load(&popped) == TRANSFER_COUNT);
+  assert(sum == (int64_t)TRANSFER_COUNT * (TRANSFER_COUNT - 1) / 2);
+  assert(mpmc_queue_size(q) == 0);
+
+  mpmc_queue_kill(q);
+  return (true);
+}
+
+TEST_FUNCTION void queue_basic_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "spsc push / pop");
+  run_test(&__test_002__, "spsc borrowed buffer and batches");
+  run_test(&__test_003__, "mpmc push / pop and batches");
+  run_test(&__test_004__, "spsc transfer between two threads");
+  run_test(&__test_005__, "mpmc transfer between many threads");
+
+  __test_end__;
+}
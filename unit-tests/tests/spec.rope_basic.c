@@ -0,0 +1,193 @@
+#include "dynstr.h"
+#include "rope.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint64_t rng_state = 0x853c49e6748fea9bULL;
+
+static uint64_t rng(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (rng_state);
+}
+
+/* Compares the rope with 'expected', through every way of reading it. */
+static bool rope_equals(const rope_t *rope, const char *expected, size_t n) {
+  size_t it = 0;
+  size_t seen = 0;
+  size_t prev = ROPE_CHUNK_SIZE;
+  const char *ptr;
+  size_t len;
+
+  assert(rope_size(rope) == n);
+  while (rope_next(rope, &it, &ptr, &len)) {
+    /* neighbouring chunks never fit in one */
+    assert(len > 0 && len <= ROPE_CHUNK_SIZE && prev + len > ROPE_CHUNK_SIZE);
+    prev = len;
+    assert(memcmp(ptr, expected + seen, len) == 0);
+    seen += len;
+  }
+  assert(seen == n && it == n);
+
+  for (size_t i = 0; i < n; i += 1 + rng() % 97)
+    assert(rope_at(rope, i) == expected[i]);
+
+  dynstr_t *flat = rope_flatten(rope);
+  assert(flat->_nmemb == n + 1 && memcmp(flat->_ptr, expected, n) == 0);
+  assert(flat->_ptr[n] == '\0');
+  dynstr_kill(flat);
+
+  return (true);
+}
+
+static size_t rope_chunks(const rope_t *rope) {
+  size_t it = 0;
+  size_t count = 0;
+  const char *ptr;
+  size_t len;
+
+  while (rope_next(rope, &it, &ptr, &len))
+    count++;
+  return (count);
+}
+
+static bool __test_001__(void) {
+  rope_t *r = rope_assign("hello world", -1);
+
+  assert(rope_equals(r, "hello world", 11));
+  assert(rope_inject(r, 5, ",", -1));
+  assert(rope_append(r, "!", 1));
+  assert(rope_inject(r, 0, "", 0));
+  assert(rope_equals(r, "hello, world!", 13));
+  assert(rope_wipe(r, 0, 7));
+  assert(rope_equals(r, "world!", 6));
+  assert(rope_wipe(r, 0, 6));
+  assert(rope_size(r) == 0 && !r->_root);
+
+  rope_kill(r);
+  return (true);
+}
+
+static bool __test_002__(void) {
+  size_t n = 5 * ROPE_CHUNK_SIZE + 123;
+  char *text = malloc(n);
+
+  for (size_t i = 0; i < n; i++)
+    text[i] = 'a' + (char)(rng() % 26);
+
+  rope_t *r = rope_assign(text, (st64_t)n);
+
+  /* every split position, around the chunk boundaries */
+  for (size_t pos = 0; pos <= n; pos += (pos % ROPE_CHUNK_SIZE) < 3 ? 1 : 511) {
+    rope_t *tail = rope_split(r, pos);
+
+    assert(rope_equals(r, text, pos));
+    assert(rope_equals(tail, text + pos, n - pos));
+    rope_concat(r, tail);
+    assert(rope_size(tail) == 0);
+    rope_kill(tail);
+    assert(rope_size(r) == n);
+  }
+  assert(rope_equals(r, text, n));
+
+  rope_kill(r);
+  free(text);
+  return (true);
+}
+
+static bool __test_003__(void) {
+  size_t cap = 1 << 20;
+  char *expected = malloc(cap);
+  char *piece = malloc(3 * ROPE_CHUNK_SIZE);
+  size_t n = 0;
+  rope_t *r = rope_create();
+
+  /* random edits, against a flat buffer */
+  for (int round = 0; round < 2000; round++) {
+    size_t op = rng() % 3;
+    size_t pos = n ? rng() % (n + 1) : 0;
+
+    if (op < 2 || !n) {
+      size_t len = rng() % 4 ? rng() % 16 : rng() % (3 * ROPE_CHUNK_SIZE);
+
+      if (n + len > cap)
+        continue;
+      for (size_t i = 0; i < len; i++)
+        piece[i] = '0' + (char)(rng() % 10);
+      assert(rope_inject(r, pos, piece, (st64_t)len));
+      memmove(expected + pos + len, expected + pos, n - pos);
+      memcpy(expected + pos, piece, len);
+      n += len;
+    } else {
+      size_t end = pos + rng() % (n - pos + 1) / 4;
+
+      assert(rope_wipe(r, pos, end));
+      memmove(expected + pos, expected + end, n - end);
+      n -= end - pos;
+    }
+
+    if (round % 100 == 0)
+      assert(rope_equals(r, expected, n));
+    /* the chunks stay half full on average */
+    assert(rope_chunks(r) <= 2 * n / ROPE_CHUNK_SIZE + 1);
+  }
+  assert(rope_equals(r, expected, n));
+
+  rope_kill(r);
+  free(piece);
+  free(expected);
+  return (true);
+}
+
+static bool __test_004__(void) {
+  size_t n = 16 * ROPE_CHUNK_SIZE;
+  char *expected = malloc(n);
+  rope_t *r;
+
+  for (size_t i = 0; i < n; i++)
+    expected[i] = 'a' + (char)(i % 26);
+  r = rope_assign(expected, (st64_t)n);
+  assert(rope_chunks(r) == 16);
+
+  /* every wipe cuts a chunk in two, the halves must be packed back */
+  for (size_t i = n - n % 7; i > 0; i -= 7) {
+    assert(rope_wipe(r, i - 1, i));
+    memmove(expected + i - 1, expected + i, n - i);
+    n--;
+  }
+  assert(rope_equals(r, expected, n));
+  assert(rope_chunks(r) <= 16);
+
+  /* and so must small pieces pasted in the middle of chunks */
+  for (size_t i = 0; i < 1000; i++) {
+    size_t pos = (i * 7919) % (n + 1);
+
+    assert(rope_inject(r, pos, "0123456789", 10));
+    memmove(expected + pos + 10, expected + pos, n - pos);
+    memcpy(expected + pos, "0123456789", 10);
+    n += 10;
+    if (n + 10 > 16 * ROPE_CHUNK_SIZE)
+      break;
+  }
+  assert(rope_equals(r, expected, n));
+  assert(rope_chunks(r) <= 2 * n / ROPE_CHUNK_SIZE + 1);
+
+  rope_kill(r);
+  free(expected);
+  return (true);
+}
+
+TEST_FUNCTION void rope_basic_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "rope inject/wipe/flatten");
+  run_test(&__test_002__, "rope split/concat");
+  run_test(&__test_003__, "rope random edits");
+  run_test(&__test_004__, "rope chunks stay packed");
+
+  __test_end__;
+}
@@ -0,0 +1,112 @@
+#include "snapshot.h"
+#include "unit_tests.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static array_t *make_table(size_t n) {
+  array_t *v = array_create(sizeof(int64_t), n, NULL);
+
+  for (int64_t i = 0; i < (int64_t)n; i++)
+    assert(array_push(v, &(int64_t){i * i - 7}));
+  return (v);
+}
+
+static bool same_content(const array_t *a, const array_t *b) {
+  return (array_size(a) == array_size(b) && a->_elt_size == b->_elt_size &&
+          !memcmp(a->_ptr, b->_ptr, array_sizeof(a)));
+}
+
+static bool __test_001__(void) {
+  char path[] = "/tmp/spec.snapshot.XXXXXX";
+  int fd = mkstemp(path);
+  array_t *v = make_table(100001);
+
+  assert(array_dump(v, fd));
+  assert((size_t)lseek(fd, 0, SEEK_CUR) == array_dump_size(v));
+
+  assert(lseek(fd, 0, SEEK_SET) == 0);
+  array_t *loaded = array_load(fd);
+  assert(loaded);
+  assert(same_content(v, loaded));
+  assert(array_push(loaded, &(int64_t){1}));
+  array_kill(loaded);
+
+  array_t *mapped = array_load_mapped(path, true);
+  assert(mapped);
+  assert(same_content(v, mapped));
+  assert(array_is_settled(mapped));
+  array_kill(mapped);
+
+  /* corrupted element */
+  int64_t garbage = 42;
+  assert(pwrite(fd, &garbage, sizeof(garbage), sizeof(snapshot_header_t) + 80) ==
+         sizeof(garbage));
+  assert(lseek(fd, 0, SEEK_SET) == 0);
+  assert(!array_load(fd));
+  assert(!array_load_mapped(path, true));
+  mapped = array_load_mapped(path, false);
+  assert(mapped);
+  array_kill(mapped);
+
+  close(fd);
+  unlink(path);
+  array_kill(v);
+  return (true);
+}
+
+static bool __test_002__(void) {
+  array_t *v = make_table(1000);
+  size_t size = array_dump_size(v);
+  char *buf = malloc(size);
+
+  assert(!array_dump_to_buffer(v, buf, size - 1));
+  assert(array_dump_to_buffer(v, buf, size) == size);
+
+  array_t *loaded = array_load_from_buffer(buf, size);
+  assert(loaded);
+  assert(same_content(v, loaded));
+  array_kill(loaded);
+
+  assert(!array_load_from_buffer(buf, size - 1));
+  buf[0] ^= 0xff;
+  assert(!array_load_from_buffer(buf, size));
+
+  free(buf);
+  array_kill(v);
+  return (true);
+}
+
+static bool __test_003__(void) {
+  char path[] = "/tmp/spec.snapshot.XXXXXX";
+  int fd = mkstemp(path);
+  dynstr_t *str = dynstr_assign("checkpointed string", -1);
+
+  assert(dynstr_dump(str, fd));
+  assert(lseek(fd, 0, SEEK_SET) == 0);
+  dynstr_t *loaded = dynstr_load(fd);
+  assert(loaded);
+  ASSERT_STR_EQUAL(loaded->_ptr, "checkpointed string");
+  assert(dynstr_append(loaded, "!", -1));
+  ASSERT_STR_EQUAL(loaded->_ptr, "checkpointed string!");
+
+  dynstr_kill(loaded);
+  dynstr_kill(str);
+  close(fd);
+  unlink(path);
+  return (true);
+}
+
+TEST_FUNCTION void snapshot_specs(void) {
+  __test_start__;
+
+  run_test(&__test_001__, "array dump/load through a file");
+  run_test(&__test_002__, "array dump/load through a buffer");
+  run_test(&__test_003__, "dynstr dump/load");
+
+  __test_end__;
+}